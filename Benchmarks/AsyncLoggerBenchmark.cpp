@@ -0,0 +1,144 @@
+// AsyncLoggerBenchmark.cpp
+// What a log call costs the thread that makes it: AsyncLogger::Push() with one and with four
+// producer threads, against the old synchronous path (format, open the file, append, close).
+// Also checks that the Block policy loses nothing under four producers and that the Drop policy
+// counts what it discards.
+//
+// Build: ./build.sh AsyncLoggerBenchmark    Run: bin/AsyncLoggerBenchmark [--pushes 60000] [--bytes 120]
+
+#include "BenchmarkUtil.h"
+#include "AsyncLogger.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace RowaPickupSlim;
+
+static std::string TempLog(const char* name)
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+// Lines of the file that end with suffix
+static size_t CountLines(const std::string& path, const std::string& suffix = std::string())
+{
+    std::ifstream file(path);
+    std::string line;
+    size_t lines = 0;
+    while (std::getline(file, line))
+    {
+        if (line.size() >= suffix.size() && line.compare(line.size() - suffix.size(), suffix.size(), suffix) == 0) lines++;
+    }
+    return lines;
+}
+
+// Nanoseconds per call of log(i), recorded by each of threads producers
+template <typename Log>
+static std::vector<long> Measure(int threads, long callsPerThread, Log&& log)
+{
+    std::vector<std::vector<long>> perThread(threads);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; t++)
+    {
+        producers.emplace_back([&, t]() {
+            std::vector<long>& ns = perThread[t];
+            ns.reserve(callsPerThread);
+            for (long i = 0; i < callsPerThread; i++)
+            {
+                Bench::Clock::time_point start = Bench::Clock::now();
+                log(i);
+                ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Bench::Clock::now() - start).count());
+            }
+        });
+    }
+    for (std::thread& t : producers) t.join();
+
+    std::vector<long> all;
+    for (const std::vector<long>& ns : perThread)
+        all.insert(all.end(), ns.begin(), ns.end());
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+static void Print(const char* name, const std::vector<long>& ns)
+{
+    std::printf("%-36s %10ld %10ld %12ld\n", name, ns[ns.size() / 2], ns[ns.size() * 99 / 100], ns.back());
+}
+
+int main(int argc, char* argv[])
+{
+    const long pushes = Bench::Option(argc, argv, "--pushes", 60000);
+    const std::string message(static_cast<size_t>(Bench::Option(argc, argv, "--bytes", 120)), 'm');
+    int failures = 0;
+
+    // Block: four producers, nothing may be lost
+    {
+        const std::string path = TempLog("AsyncLoggerBenchmark-block.log");
+        AsyncLogger logger(1024, AsyncLogger::OverflowPolicy::Block);
+        if (!logger.Open(path)) { std::printf("cannot open %s\n", path.c_str()); return 1; }
+        Measure(4, 50000, [&](long i) { logger.Push("producer message " + std::to_string(i)); });
+        logger.Flush();
+        AsyncLogger::Counters c = logger.GetCounters();
+        size_t lines = CountLines(path);
+        if (c.written != 200000 || c.dropped != 0 || lines != 200000)
+        {
+            std::printf("CHECK FAILED: Block policy wrote %llu records (%zu lines), dropped %llu; expected 200000\n",
+                        static_cast<unsigned long long>(c.written), lines, static_cast<unsigned long long>(c.dropped));
+            failures++;
+        }
+        std::filesystem::remove(path);
+    }
+
+    // Drop: a small ring overflows; every record is either written or counted as dropped
+    // (the writer adds a "[LOG] N log records dropped" line of its own)
+    {
+        const std::string path = TempLog("AsyncLoggerBenchmark-drop.log");
+        AsyncLogger logger(64);
+        logger.Open(path);
+        for (long i = 0; i < 100000; i++) logger.Push("x");
+        logger.Stop();
+        AsyncLogger::Counters c = logger.GetCounters();
+        if (c.pushed + c.dropped != 100000 || c.written != c.pushed || CountLines(path, "] x") != c.written)
+        {
+            std::printf("CHECK FAILED: Drop policy pushed %llu, dropped %llu, wrote %llu\n", static_cast<unsigned long long>(c.pushed),
+                        static_cast<unsigned long long>(c.dropped), static_cast<unsigned long long>(c.written));
+            failures++;
+        }
+        std::filesystem::remove(path);
+    }
+
+    std::printf("%zu-byte messages, ns per call on the logging thread\n", message.size());
+    std::printf("%-36s %10s %10s %12s\n", "", "p50", "p99", "max");
+    for (int threads : { 1, 4 })
+    {
+        const std::string path = TempLog("AsyncLoggerBenchmark.log");
+        AsyncLogger logger(65536);
+        logger.Open(path);
+        std::vector<long> ns = Measure(threads, pushes / threads, [&](long) { logger.Push(message); });
+        logger.Flush();
+        std::string name = "AsyncLogger::Push, " + std::to_string(threads) + (threads == 1 ? " producer" : " producers");
+        Print(name.c_str(), ns);
+        if (logger.GetCounters().dropped != 0)
+            std::printf("  (%llu dropped: the ring is smaller than a burst)\n", static_cast<unsigned long long>(logger.GetCounters().dropped));
+        logger.Stop();
+        std::filesystem::remove(path);
+    }
+
+    {
+        const std::string path = TempLog("AsyncLoggerBenchmark-sync.log");
+        std::vector<long> ns = Measure(1, 2000, [&](long) {
+            std::string line;
+            AsyncLogger::FormatLine(line, std::chrono::system_clock::now(), message);
+            std::ofstream file(path, std::ios::app);
+            file << line << std::flush;
+        });
+        Print("format + open/append/close (old)", ns);
+        std::filesystem::remove(path);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+#pragma once
+// BenchmarkUtil.h
+// Helpers shared by the benchmarks: best-of-N timing, a sink the optimizer cannot remove and
+// "--name value" command line options. Only depends on the standard library.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace Bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    inline double Seconds(Clock::duration d)
+    {
+        return std::chrono::duration<double>(d).count();
+    }
+
+    /// Fastest of runs calls of body, in seconds (the first run also warms caches and buffers)
+    template <typename Body>
+    double BestOf(int runs, Body&& body)
+    {
+        double best = 0;
+        for (int i = 0; i < runs; i++)
+        {
+            Clock::time_point start = Clock::now();
+            body();
+            double elapsed = Seconds(Clock::now() - start);
+            if (i == 0 || elapsed < best) best = elapsed;
+        }
+        return best;
+    }
+
+    /// Make value observable, so the work that produced it is not optimized away
+    template <typename T>
+    inline void Keep(const T& value)
+    {
+        asm volatile("" : : "r"(&value) : "memory");
+    }
+
+    /// Value of "--name N", or fallback
+    inline long Option(int argc, char* argv[], const char* name, long fallback)
+    {
+        for (int i = 1; i + 1 < argc; i++)
+        {
+            if (std::strcmp(argv[i], name) == 0)
+                return std::strtol(argv[i + 1], nullptr, 10);
+        }
+        return fallback;
+    }
+
+    /// True if "--name" is on the command line
+    inline bool Flag(int argc, char* argv[], const char* name)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            if (std::strcmp(argv[i], name) == 0) return true;
+        }
+        return false;
+    }
+}
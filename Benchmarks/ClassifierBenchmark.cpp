@@ -0,0 +1,129 @@
+// ClassifierBenchmark.cpp
+// Cost of routing one received frame with ClassifyWwksFrame + FindTagAttribute, against what the
+// receive loop did before it: search the whole frame for "<KeepAliveRequest", scan the first tags
+// for the Id, and build a pugixml DOM to probe which message element it holds.
+// Measured on a small OutputMessage and on a large StockInfoResponse, whose cost used to grow
+// with the frame while the classifier only reads the first tags.
+//
+// Build: ./build.sh ClassifierBenchmark    Run: bin/ClassifierBenchmark [--articles 20000]
+
+#include "BenchmarkUtil.h"
+#include "WwksClassifier.h"
+#include "pugixml.hpp"
+#include <string>
+#include <string_view>
+
+using namespace RowaPickupSlim;
+
+// The old ordering key lookup (NetworkClient::GetMessageOrderKey)
+static std::string_view OldOrderKey(std::string_view wwksMessage)
+{
+    size_t root = wwksMessage.find("<WWKS");
+    if (root == std::string_view::npos) return {};
+    size_t rootEnd = wwksMessage.find('>', root);
+    if (rootEnd == std::string_view::npos) return {};
+    size_t child = wwksMessage.find('<', rootEnd);
+    if (child == std::string_view::npos) return {};
+    size_t childEnd = wwksMessage.find('>', child);
+    if (childEnd == std::string_view::npos) return {};
+
+    std::string_view tag = wwksMessage.substr(child, childEnd - child);
+    size_t idPos = tag.find(" Id=\"");
+    if (idPos == std::string_view::npos) return {};
+    idPos += 5;
+    size_t idEnd = tag.find('"', idPos);
+    if (idEnd == std::string_view::npos) return {};
+    return tag.substr(idPos, idEnd - idPos);
+}
+
+// The old routing: KeepAlive search over the frame, ordering key, then a DOM to find the type
+static std::string OldRoute(const std::string& frame, std::string& orderKey)
+{
+    if (frame.find("<KeepAliveRequest") != std::string::npos) return "KeepAliveRequest";
+    orderKey = OldOrderKey(frame);
+
+    pugi::xml_document doc;
+    if (!doc.load_string(frame.c_str())) return "";
+    pugi::xml_node root = doc.child("WWKS");
+    if (!root) return "";
+    for (const char* name : { "HelloResponse", "StatusResponse", "StockInfoResponse", "OutputResponse", "OutputMessage" })
+    {
+        if (root.child(name)) return name;
+    }
+    return "";
+}
+
+static WwksMessageType NewRoute(std::string_view frame, std::string_view& orderKey)
+{
+    std::string_view bodyTag;
+    WwksMessageType type = ClassifyWwksFrame(frame, &bodyTag);
+    if (type != WwksMessageType::KeepAliveRequest)
+        FindTagAttribute(bodyTag, "Id", orderKey);
+    return type;
+}
+
+static int Check(bool ok, const char* what)
+{
+    if (ok) return 0;
+    std::printf("CHECK FAILED: %s\n", what);
+    return 1;
+}
+
+int main(int argc, char* argv[])
+{
+    const long articles = Bench::Option(argc, argv, "--articles", 20000);
+
+    int failures = 0;
+    std::string_view tag, value;
+    failures += Check(ClassifyWwksFrame("<?xml version=\"1.0\"?>\n<!-- c --><WWKS Version=\"2.0\" TimeStamp=\"a>b\">\n"
+                                        " <KeepAliveRequest Id='12' Source=\"999\" Destination=\"100\"/></WWKS>",
+                                        &tag) == WwksMessageType::KeepAliveRequest,
+                      "prolog, comment and '>' in a quoted value");
+    failures += Check(FindTagAttribute(tag, "Id", value) && value == "12", "single quoted Id");
+    failures += Check(FindTagAttribute(tag, "Destination", value) && value == "100", "Destination");
+    failures += Check(!FindTagAttribute(tag, "Ids", value), "no prefix match");
+    failures += Check(ClassifyWwksFrame("<WWKSX><OutputMessage/></WWKSX>") == WwksMessageType::Unknown, "other root");
+    failures += Check(ClassifyWwksFrame("<WWKS><Foo/></WWKS>") == WwksMessageType::Unknown, "unknown element");
+    failures += Check(ClassifyWwksFrame("<WWKS>") == WwksMessageType::Unknown, "truncated frame");
+
+    std::string small = "<WWKS Version=\"2.0\" TimeStamp=\"2026-01-01T00:00:00Z\"><OutputMessage Id=\"1234\" Source=\"999\" "
+                        "Destination=\"100\"><Details Status=\"Completed\" OutputDestination=\"1\"/><Article Id=\"RoWa1\">"
+                        "<Pack Id=\"1\"/></Article></OutputMessage></WWKS>";
+    std::string large = "<WWKS Version=\"2.0\" TimeStamp=\"2026-01-01T00:00:00Z\"><StockInfoResponse Id=\"77\" Source=\"999\" Destination=\"100\">";
+    for (long i = 0; i < articles; i++)
+        large += "<Article Id=\"RoWa-" + std::to_string(100000 + i) + "\" Name=\"Article\" Quantity=\"3\" />";
+    large += "</StockInfoResponse></WWKS>";
+
+    std::printf("%-24s %10s %16s %16s %10s\n", "frame", "bytes", "classifier ns", "old (DOM) ns", "speedup");
+    for (const std::string* frame : { &small, &large })
+    {
+        const long iterations = frame == &small ? 200000 : 50;
+
+        std::string_view newKey;
+        WwksMessageType type = WwksMessageType::Unknown;
+        double newSeconds = Bench::BestOf(5, [&]() {
+            for (long i = 0; i < iterations; i++)
+            {
+                type = NewRoute(*frame, newKey);
+                Bench::Keep(type);
+            }
+        });
+
+        std::string oldKey, oldType;
+        double oldSeconds = Bench::BestOf(3, [&]() {
+            for (long i = 0; i < iterations; i++)
+            {
+                oldType = OldRoute(*frame, oldKey);
+                Bench::Keep(oldType);
+            }
+        });
+
+        // Both must route the frame the same way
+        failures += Check(oldType == ToString(type) && oldKey == newKey, "same type and ordering key as the old routing");
+
+        double newNs = newSeconds * 1e9 / static_cast<double>(iterations);
+        double oldNs = oldSeconds * 1e9 / static_cast<double>(iterations);
+        std::printf("%-24s %10zu %16.0f %16.0f %9.0fx\n", ToString(type), frame->size(), newNs, oldNs, oldNs / newNs);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+// FrameSplitterBenchmark.cpp
+// Throughput of WwksFrameSplitter on a synthetic multi-megabyte stream, fed in recv-sized chunks,
+// against the loop ReceiveLoop used before it (append, find "</WWKS>" from offset 0, substr, erase).
+// The stream mixes large StockInfoResponses with KeepAlives and OutputMessages; every chunking must
+// produce the same frames.
+//
+// Build: ./build.sh FrameSplitterBenchmark    Run: bin/FrameSplitterBenchmark [--articles 60000] [--frames 4]
+
+#include "BenchmarkUtil.h"
+#include "WwksFrameSplitter.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+using namespace RowaPickupSlim;
+
+static std::string MakeStream(long articles, long largeFrames)
+{
+    std::string large = "<WWKS Version=\"2.0\" TimeStamp=\"2026-01-01T00:00:00Z\"><StockInfoResponse Id=\"1\" Source=\"999\" Destination=\"100\">";
+    for (long i = 0; i < articles; i++)
+        large += "<Article Id=\"RoWa-" + std::to_string(100000 + i) + "\" Name=\"Article\" Quantity=\"3\" />";
+    large += "</StockInfoResponse></WWKS>";
+
+    std::string stream;
+    for (long f = 0; f < largeFrames; f++)
+    {
+        stream += "<WWKS Version=\"2.0\"><KeepAliveRequest Id=\"" + std::to_string(f) + "\" Source=\"999\" Destination=\"100\" /></WWKS>\n";
+        stream += large;
+        for (int i = 0; i < 100; i++)
+            stream += "<WWKS Version=\"2.0\"><OutputMessage Id=\"" + std::to_string(i) + "\"><Details Status=\"InProcess\" /></OutputMessage></WWKS>";
+    }
+    return stream;
+}
+
+struct Split
+{
+    size_t frames = 0;
+    size_t bytes = 0;
+};
+
+// Received in chunks of at most chunkSize bytes, written straight into the splitter as recv does
+static Split RunSplitter(const std::string& stream, size_t chunkSize)
+{
+    WwksFrameSplitter splitter;
+    Split result;
+    for (size_t offset = 0; offset < stream.size(); offset += chunkSize)
+    {
+        size_t length = std::min(chunkSize, stream.size() - offset);
+        std::memcpy(splitter.PrepareWrite(length), stream.data() + offset, length);
+        splitter.Commit(length);
+
+        std::string_view frame;
+        while (splitter.NextFrame(frame))
+        {
+            result.frames++;
+            result.bytes += frame.size();
+        }
+    }
+    return result;
+}
+
+static Split RunOldLoop(const std::string& stream, size_t chunkSize)
+{
+    std::string messageBuilder;
+    Split result;
+    for (size_t offset = 0; offset < stream.size(); offset += chunkSize)
+    {
+        messageBuilder.append(stream.data() + offset, std::min(chunkSize, stream.size() - offset));
+
+        size_t endPos;
+        while ((endPos = messageBuilder.find("</WWKS>")) != std::string::npos)
+        {
+            std::string completeMessage = messageBuilder.substr(0, endPos + 7);
+            messageBuilder.erase(0, endPos + 7);
+
+            // The old loop trimmed leading whitespace from each frame
+            size_t first = completeMessage.find_first_not_of(" \t\r\n");
+            result.frames++;
+            result.bytes += completeMessage.size() - (first == std::string::npos ? completeMessage.size() : first);
+        }
+    }
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    const long articles = Bench::Option(argc, argv, "--articles", 60000);
+    const long largeFrames = Bench::Option(argc, argv, "--frames", 4);
+    const std::string stream = MakeStream(articles, largeFrames);
+    const double mb = static_cast<double>(stream.size()) / 1e6;
+    std::printf("stream: %.1f MB, %ld StockInfoResponses of %ld articles\n", mb, largeFrames, articles);
+
+    // Tiny chunks split every end tag somewhere; all chunkings must agree
+    const Split reference = RunSplitter(stream, stream.size());
+    int failures = 0;
+    for (size_t chunk : { 1, 3, 7, 1000 })
+    {
+        Split s = RunSplitter(stream, chunk);
+        if (s.frames != reference.frames || s.bytes != reference.bytes)
+        {
+            std::printf("MISMATCH at chunk %zu: %zu frames / %zu bytes, expected %zu / %zu\n", chunk, s.frames, s.bytes,
+                        reference.frames, reference.bytes);
+            failures++;
+        }
+    }
+
+    std::printf("%-28s %10s %10s %12s\n", "", "chunk", "frames", "MB/s");
+    for (size_t chunk : { 1024, 8192, 65536 })
+    {
+        Split s;
+        double seconds = Bench::BestOf(5, [&]() { s = RunSplitter(stream, chunk); });
+        std::printf("%-28s %10zu %10zu %12.0f\n", "WwksFrameSplitter", chunk, s.frames, mb / seconds);
+    }
+
+    Split old;
+    double seconds = Bench::BestOf(1, [&]() { old = RunOldLoop(stream, 8192); });
+    std::printf("%-28s %10d %10zu %12.0f\n", "find/substr/erase (old)", 8192, old.frames, mb / seconds);
+    if (old.frames != reference.frames || old.bytes != reference.bytes)
+    {
+        std::printf("MISMATCH: the old loop found %zu frames / %zu bytes\n", old.frames, old.bytes);
+        failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
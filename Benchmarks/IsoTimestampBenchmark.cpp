@@ -0,0 +1,180 @@
+// IsoTimestampBenchmark.cpp
+// ns per timestamp formatted with IsoTimestampFormatter (message TimeStamp, the same with
+// milliseconds, the log line's local time) against the old gmtime / localtime + strftime per call,
+// and ns per parse with ParseIsoTimestamp against istringstream + get_time and strptime (each
+// followed by timegm).
+// Checks the formatter against strftime and the parser against the formatter over random seconds
+// from 1900 to 2200, and the parser on valid and invalid edge cases.
+//
+// Build: ./build.sh IsoTimestampBenchmark    Run: bin/IsoTimestampBenchmark [--calls 5000000] [--samples 200000]
+
+#include "BenchmarkUtil.h"
+#include "IsoTimestamp.h"
+#include <ctime>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+
+using namespace RowaPickupSlim;
+using SystemClock = std::chrono::system_clock;
+
+static int CheckFormatAndParse(long samples)
+{
+    int failures = 0;
+    auto fail = [&](const std::string& what) {
+        if (failures++ < 5) std::printf("CHECK FAILED: %s\n", what.c_str());
+    };
+
+    std::mt19937_64 random(7);
+    IsoTimestampFormatter utc;
+    IsoTimestampFormatter utcMs(IsoTimestampFormatter::Zone::Utc, IsoTimestampFormatter::Layout::DateTime, 3);
+    IsoTimestampFormatter local(IsoTimestampFormatter::Zone::Local, IsoTimestampFormatter::Layout::Time);
+    const int64_t from = -2208988800LL;         // 1900-01-01
+    const int64_t to = 7258118400LL;            // 2200-01-01
+    for (long i = 0; i < samples; i++)
+    {
+        std::time_t t = static_cast<std::time_t>(from + static_cast<int64_t>(random() % static_cast<uint64_t>(to - from)));
+        std::tm tm{};
+        gmtime_r(&t, &tm);
+        char expected[64];
+        std::strftime(expected, sizeof(expected), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        if (utc.Format(t) != expected) fail(std::string("UTC ") + expected);
+
+        SystemClock::time_point parsed;
+        bool hasZone = false;
+        if (!ParseIsoTimestamp(expected, parsed, &hasZone) || SystemClock::to_time_t(parsed) != t || !hasZone)
+            fail(std::string("parse ") + expected);
+
+        std::tm localTm{};
+        localtime_r(&t, &localTm);
+        char expectedLocal[16];
+        std::strftime(expectedLocal, sizeof(expectedLocal), "%H:%M:%S", &localTm);
+        if (local.Format(t) != expectedLocal) fail(std::string("local ") + expectedLocal);
+
+        int ms = static_cast<int>(random() % 1000);
+        SystemClock::time_point withMs = SystemClock::from_time_t(t) + std::chrono::milliseconds(ms);
+        char expectedMs[64];
+        std::snprintf(expectedMs, sizeof(expectedMs), "%.19s.%03dZ", expected, ms);
+        std::string_view text = utcMs.Format(withMs);
+        if (text != expectedMs) fail(std::string("UTC .fff ") + expectedMs);
+        if (!ParseIsoTimestamp(text, parsed) || parsed != withMs) fail(std::string("parse ") + expectedMs);
+    }
+
+    struct Case
+    {
+        const char* text;
+        bool valid;
+        long long seconds;
+    };
+    const Case cases[] = {
+        { "2026-01-15T10:20:30Z", true, 1768472430 },
+        { "2026-01-15T11:20:30+01:00", true, 1768472430 },
+        { "2026-01-15T09:20:30-0100", true, 1768472430 },
+        { "2026-01-15T10:20:30+01", true, 1768468830 },
+        { "2026-01-15 10:20:30", true, 1768472430 },
+        { "2026-01-15T10:20Z", true, 1768472400 },
+        { "2026-01-15", true, 1768435200 },
+        { "2024-02-29", true, 1709164800 },
+        { "2026-01-15T10:20:30.123456789123Z", true, 1768472430 },
+        { "2023-02-29", false, 0 },
+        { "2026-13-01", false, 0 },
+        { "2026-01-15T24:00:00Z", false, 0 },
+        { "2026-01-15T10:20:30Zx", false, 0 },
+        { "2026-01-15T10:20:30.", false, 0 },
+        { "2026-1-15", false, 0 },
+        { "9999-12-31", false, 0 },
+        { "", false, 0 },
+    };
+    for (const Case& c : cases)
+    {
+        SystemClock::time_point parsed;
+        bool valid = ParseIsoTimestamp(c.text, parsed);
+        if (valid != c.valid || (valid && SystemClock::to_time_t(parsed) != c.seconds))
+            fail(std::string("parse case \"") + c.text + "\"");
+    }
+    return failures;
+}
+
+// ns per call of body(i)
+template <typename Body>
+static void Measure(const char* name, long calls, Body&& body)
+{
+    size_t sink = 0;
+    double seconds = Bench::BestOf(3, [&]() {
+        for (long i = 0; i < calls; i++) sink += body(i);
+    });
+    Bench::Keep(sink);
+    std::printf("%-52s %10.1f\n", name, seconds * 1e9 / static_cast<double>(calls));
+}
+
+int main(int argc, char* argv[])
+{
+    const long calls = Bench::Option(argc, argv, "--calls", 5000000);
+    const long samples = Bench::Option(argc, argv, "--samples", 200000);
+    int failures = CheckFormatAndParse(samples);
+
+    IsoTimestampFormatter utc;
+    IsoTimestampFormatter utcMs(IsoTimestampFormatter::Zone::Utc, IsoTimestampFormatter::Layout::DateTime, 3);
+    IsoTimestampFormatter local(IsoTimestampFormatter::Zone::Local, IsoTimestampFormatter::Layout::Time);
+    const SystemClock::time_point now = SystemClock::now();
+    const std::time_t base = 1768472430;
+
+    std::printf("%-52s %10s\n", "Format", "ns/call");
+    Measure("TimeStamp, system_clock + gmtime + strftime (old)", calls, [&](long) {
+        std::time_t t = SystemClock::to_time_t(SystemClock::now());
+        std::tm tm{};
+        gmtime_r(&t, &tm);
+        char buffer[64];
+        return std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    });
+    Measure("TimeStamp, system_clock + formatter", calls, [&](long) {
+        return utc.Format(SystemClock::to_time_t(SystemClock::now())).size();
+    });
+    Measure("TimeStamp, a new second every call", calls, [&](long i) {
+        return utc.Format(static_cast<std::time_t>(base + i)).size();
+    });
+    Measure("TimeStamp .fff, gmtime + strftime + snprintf (old)", calls, [&](long i) {
+        SystemClock::time_point t = now + std::chrono::microseconds(i * 7);
+        std::time_t seconds = SystemClock::to_time_t(t);
+        std::tm tm{};
+        gmtime_r(&seconds, &tm);
+        char buffer[64];
+        size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &tm);
+        long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()).count() % 1000;
+        return n + static_cast<size_t>(std::snprintf(buffer + n, 16, ".%03lldZ", ms));
+    });
+    Measure("TimeStamp .fff, formatter (7 us apart)", calls, [&](long i) {
+        return utcMs.Format(now + std::chrono::microseconds(i * 7)).size();
+    });
+    Measure("log [HH:MM:SS], localtime + strftime (old)", calls, [&](long i) {
+        std::time_t t = static_cast<std::time_t>(base + i / 1000);
+        std::tm tm{};
+        localtime_r(&t, &tm);
+        char buffer[16];
+        return std::strftime(buffer, sizeof(buffer), "[%H:%M:%S] ", &tm);
+    });
+    Measure("log [HH:MM:SS], formatter", calls, [&](long i) {
+        return local.Format(static_cast<std::time_t>(base + i / 1000)).size();
+    });
+
+    const char* stamp = "2026-01-15T10:20:30.125Z";
+    std::printf("\n%-52s %10s\n", "Parse \"2026-01-15T10:20:30.125Z\"", "ns/call");
+    Measure("istringstream + get_time + timegm", calls / 5, [&](long) {
+        std::tm tm{};
+        std::istringstream in(stamp);
+        in >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
+        return static_cast<size_t>(timegm(&tm));
+    });
+    Measure("strptime + timegm", calls, [&](long) {
+        std::tm tm{};
+        strptime(stamp, "%Y-%m-%dT%H:%M:%S", &tm);
+        return static_cast<size_t>(timegm(&tm));
+    });
+    Measure("ParseIsoTimestamp", calls, [&](long) {
+        SystemClock::time_point parsed;
+        ParseIsoTimestamp(stamp, parsed);
+        return static_cast<size_t>(parsed.time_since_epoch().count());
+    });
+    return failures == 0 ? 0 : 1;
+}
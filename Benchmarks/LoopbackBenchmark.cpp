@@ -0,0 +1,252 @@
+// LoopbackBenchmark.cpp
+// Receive throughput of NetworkClient over a LoopbackTransport pair: a stand-in robot answers the
+// handshake, then writes a fixed stream of OutputMessages that the client splits, classifies,
+// parses and dispatches. The stream and its chunk boundaries are the same on every run (fixed
+// message text, seeded chunk sizes), so runs differ only in timing. The raw transport pair, with
+// a receiver that only counts bytes, is the baseline. Checks that every message arrives, in order.
+//
+// Build: ./build.sh LoopbackBenchmark    Run: bin/LoopbackBenchmark [--messages 100000] [--runs 3]
+
+#include "BenchmarkUtil.h"
+#include "LoopbackTransport.h"
+#include "networkclient.h"
+#include "WwksClassifier.h"
+#include "WwksFrameSplitter.h"
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace RowaPickupSlim;
+
+static std::string Frame(const std::string& body)
+{
+    return "<WWKS Version=\"2.0\" TimeStamp=\"2026-01-01T00:00:00Z\">" + body + "</WWKS>\n";
+}
+
+static std::string OutputMessage(long id)
+{
+    return Frame("<OutputMessage Id=\"" + std::to_string(id) + "\" Source=\"999\" Destination=\"100\">"
+                 "<Details Priority=\"Normal\" OutputDestination=\"1\" Status=\"Completed\" />"
+                 "<Article Id=\"RoWa-100001\" Quantity=\"1\"><Pack Id=\"1\" DeliveryNumber=\"1\" /></Article></OutputMessage>");
+}
+
+// The stream: OutputMessages 0..count-1, in writes of batch messages
+static std::vector<std::string> Stream(long count, long batch)
+{
+    std::vector<std::string> writes;
+    for (long i = 0; i < count; i += batch)
+    {
+        std::string write;
+        for (long j = i; j < std::min(count, i + batch); j++) write += OutputMessage(j);
+        writes.push_back(std::move(write));
+    }
+    return writes;
+}
+
+static bool WriteAll(Transport& transport, const std::string& data)
+{
+    size_t offset = 0;
+    while (offset < data.size())
+    {
+        Transport::Buffer buffer{ data.data() + offset, data.size() - offset };
+        size_t written = 0;
+        int error = 0;
+        if (!transport.Write(&buffer, 1, written, error)) return false;
+        offset += written;
+    }
+    return true;
+}
+
+// Robot end of the pair: answers Hello / Status / StockInfo on its own reactor thread
+class Robot
+{
+public:
+    explicit Robot(std::unique_ptr<LoopbackTransport> transport)
+        : _transport(std::move(transport))
+    {
+        Transport::Receiver receiver;
+        receiver.Prepare = [this](size_t bytes) { return _splitter.PrepareWrite(bytes); };
+        receiver.Commit = [this](size_t bytes) {
+            _splitter.Commit(bytes);
+            std::string_view frame;
+            while (_splitter.NextFrame(frame)) Answer(frame);
+        };
+        receiver.Closed = [this](int) { _reactor.Stop(); };
+        _transport->Start(_reactor, std::move(receiver));
+        _thread = std::thread([this]() { _reactor.Run(); });
+    }
+
+    ~Robot()
+    {
+        _transport->Shutdown();
+        _reactor.Stop();
+        _thread.join();
+        _transport->Stop();
+    }
+
+    Transport& GetTransport() { return *_transport; }
+
+private:
+    void Answer(std::string_view frame)
+    {
+        std::string_view tag;
+        WwksMessageType type = ClassifyWwksFrame(frame, &tag);
+        std::string_view idView;
+        FindTagAttribute(tag, "Id", idView);
+        std::string id(idView);
+        const std::string route = " Source=\"999\" Destination=\"100\"";
+        if (type == WwksMessageType::HelloRequest)
+            WriteAll(*_transport, Frame("<HelloResponse Id=\"" + id + "\"><Subscriber Id=\"999\" Type=\"StorageSystem\" /></HelloResponse>"));
+        else if (type == WwksMessageType::StatusRequest)
+            WriteAll(*_transport, Frame("<StatusResponse Id=\"" + id + "\"" + route + " State=\"Ready\" />"));
+        else if (type == WwksMessageType::StockInfoRequest)
+            WriteAll(*_transport, Frame("<StockInfoResponse Id=\"" + id + "\"" + route + " />"));
+    }
+
+    std::unique_ptr<LoopbackTransport> _transport;
+    Reactor _reactor;
+    WwksFrameSplitter _splitter;
+    std::thread _thread;
+};
+
+struct Result
+{
+    double seconds = 0;
+    long received = 0;
+    bool inOrder = true;
+};
+
+// Seconds from the first write of the stream to the last message handed to MessageReceived
+static Result ClientRun(const LoopbackTransport::Options& toClient, const std::vector<std::string>& stream, long count)
+{
+    auto [clientEnd, robotEnd] = LoopbackTransport::CreatePair(toClient, LoopbackTransport::Options());
+    NetworkClient client;
+    client.Identity = []() { ClientIdentity identity; identity.sourceNumber = 100; return identity; };
+
+    std::atomic<long> received{ 0 };
+    std::atomic<bool> inOrder{ true };
+    std::atomic<Bench::Clock::rep> last{ 0 };
+    client.MessageReceived = [&](const WwksMessage& message) {
+        if (message.type != WwksMessageType::OutputMessage) return;
+        if (message.body.attribute("Id").as_llong(-1) != received.load()) inOrder = false;
+        received++;
+        last = Bench::Clock::now().time_since_epoch().count();
+    };
+
+    Robot robot(std::move(robotEnd));
+    Result result;
+    if (!client.Connect(std::move(clientEnd))) return result;
+    for (int i = 0; i < 5000 && !client.IsHandshakeComplete(); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    Bench::Clock::time_point start = Bench::Clock::now();
+    for (const std::string& write : stream)
+    {
+        if (!WriteAll(robot.GetTransport(), write)) break;
+    }
+    Bench::Clock::time_point deadline = start + std::chrono::seconds(120);
+    while (received.load() < count && Bench::Clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+    result.received = received.load();
+    result.inOrder = inOrder.load();
+    result.seconds = Bench::Seconds(Bench::Clock::time_point(Bench::Clock::duration(last.load())) - start);
+    client.Close();
+    return result;
+}
+
+// The transport pair alone: the receiver only counts bytes
+static double RawRun(const LoopbackTransport::Options& toClient, const std::vector<std::string>& stream, uint64_t bytes)
+{
+    auto [clientEnd, robotEnd] = LoopbackTransport::CreatePair(toClient, LoopbackTransport::Options());
+    Reactor reactor;
+    std::vector<char> sink(256 * 1024);
+    std::atomic<uint64_t> received{ 0 };
+    Transport::Receiver receiver;
+    receiver.Prepare = [&](size_t bytesWanted) {
+        if (sink.size() < bytesWanted) sink.resize(bytesWanted);
+        return sink.data();
+    };
+    receiver.Commit = [&](size_t n) {
+        received += n;
+        if (received.load() == bytes) reactor.Stop();
+    };
+    clientEnd->Start(reactor, std::move(receiver));
+
+    Bench::Clock::time_point start = Bench::Clock::now();
+    std::thread loop([&]() { reactor.Run(); });
+    for (const std::string& write : stream) WriteAll(*robotEnd, write);
+    loop.join();
+    double seconds = Bench::Seconds(Bench::Clock::now() - start);
+    clientEnd->Stop();
+    return received.load() == bytes ? seconds : -1;
+}
+
+int main(int argc, char* argv[])
+{
+    const long messages = Bench::Option(argc, argv, "--messages", 100000);
+    const int runs = static_cast<int>(Bench::Option(argc, argv, "--runs", 3));
+    int failures = 0;
+
+    struct Case
+    {
+        const char* name;
+        LoopbackTransport::Options options;
+        long count;
+    };
+    LoopbackTransport::Options asWritten;
+    LoopbackTransport::Options segments;        // Like TCP segments on a LAN
+    segments.minChunk = 1;
+    segments.maxChunk = 1460;
+    segments.seed = 42;
+    LoopbackTransport::Options tiny;
+    tiny.minChunk = 1;
+    tiny.maxChunk = 7;
+    tiny.seed = 42;
+    const Case cases[] = {
+        { "as written (64 messages a write)", asWritten, messages },
+        { "chunks of 1-1460 bytes", segments, messages },
+        { "chunks of 1-7 bytes", tiny, messages / 10 },
+    };
+
+    std::printf("%-34s %10s %10s %12s %10s %12s\n", "", "messages", "MB", "msgs/s", "MB/s", "raw MB/s");
+    for (const Case& c : cases)
+    {
+        std::vector<std::string> stream = Stream(c.count, 64);
+        uint64_t bytes = 0;
+        for (const std::string& write : stream) bytes += write.size();
+
+        double best = 0;
+        for (int run = 0; run < runs; run++)
+        {
+            Result result = ClientRun(c.options, stream, c.count);
+            if (result.received != c.count || !result.inOrder)
+            {
+                std::printf("CHECK FAILED: %s: %ld of %ld messages received%s\n", c.name, result.received, c.count,
+                            result.inOrder ? "" : ", out of order");
+                failures++;
+                break;
+            }
+            if (run == 0 || result.seconds < best) best = result.seconds;
+        }
+        double raw = 0;
+        for (int run = 0; run < runs; run++)
+        {
+            double seconds = RawRun(c.options, stream, bytes);
+            if (seconds < 0)
+            {
+                std::printf("CHECK FAILED: %s: the raw pair lost bytes\n", c.name);
+                failures++;
+                break;
+            }
+            if (run == 0 || seconds < raw) raw = seconds;
+        }
+
+        double mb = static_cast<double>(bytes) / 1e6;
+        std::printf("%-34s %10ld %10.1f %12.0f %10.1f %12.1f\n", c.name, c.count, mb, static_cast<double>(c.count) / best,
+                    mb / best, mb / raw);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+// OrderTableBenchmark.cpp
+// OrderTable lookups with 10k active orders, against the linear scans over the vector of 6-tuples
+// main.cpp used before: the display entry for each visible list row on every paint, and the order
+// lookup for every status update.
+//
+// Build: ./build.sh OrderTableBenchmark    Run: bin/OrderTableBenchmark [--orders 10000] [--rows 40] [--paints 2000]
+
+#include "BenchmarkUtil.h"
+#include "OrderTable.h"
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace RowaPickupSlim;
+
+// The old storage: order ID, article ID, quantity, packs, colour, ours
+using OldRecord = std::tuple<std::string, std::string, int, int, unsigned, bool>;
+
+static int Check(bool ok, const char* what)
+{
+    if (ok) return 0;
+    std::printf("CHECK FAILED: %s\n", what);
+    return 1;
+}
+
+// Index maintenance on insert / update / remove
+static int CheckSemantics()
+{
+    int failures = 0;
+    OrderTable table;
+    size_t active = 0;
+    table.SetOrder({ "o1", "A", 2, 0, OutputStatus::Queued, true });
+    table.SetOrder({ "o2", "A", 1, 0, OutputStatus::InProcess, false });
+    const OutputRecord* display = table.FindArticleDisplay("A", &active);
+    failures += Check(display && display->orderId == "o1" && active == 2, "oldest order is displayed");
+
+    table.SetOrder({ "o1", "B", 5, 1, OutputStatus::Incomplete, true });
+    const OutputRecord* order = table.FindOrder("o1");
+    failures += Check(order && order->articleId == "A" && order->packsDelivered == 1, "update keeps the article");
+
+    failures += Check(table.RemoveOrder("o1"), "remove");
+    display = table.FindArticleDisplay("A", &active);
+    failures += Check(display && display->orderId == "o2" && active == 1, "next order is displayed after a remove");
+    failures += Check(!table.RemoveOrder("o1") && table.RemoveOrder("o2"), "remove twice");
+    failures += Check(!table.FindArticleDisplay("A") && table.Size() == 0, "empty after removing all");
+    return failures;
+}
+
+int main(int argc, char* argv[])
+{
+    const long orders = Bench::Option(argc, argv, "--orders", 10000);
+    const long rows = Bench::Option(argc, argv, "--rows", 40);
+    const long paints = Bench::Option(argc, argv, "--paints", 2000);
+    int failures = CheckSemantics();
+
+    OrderTable table;
+    std::vector<OldRecord> old;
+    std::vector<std::string> orderIds;
+    for (long i = 0; i < orders; i++)
+    {
+        std::string article = "RoWa-" + std::to_string(100000 + i);
+        std::string orderId = std::to_string(900000000 + i);
+        old.emplace_back(orderId, article, 1, 0, 0u, false);
+        table.SetOrder({ orderId, article, 1, 0, OutputStatus::Queued, false });
+        orderIds.push_back(orderId);
+    }
+
+    // The visible rows show recent articles, so the old scan runs far into the vector
+    std::vector<std::string> visible;
+    for (long i = 0; i < rows; i++)
+        visible.push_back("RoWa-" + std::to_string(100000 + (orders - 1 - (i * 7) % orders)));
+
+    long oldHits = 0, newHits = 0;
+    double oldPaint = Bench::BestOf(3, [&]() {
+        oldHits = 0;
+        for (long p = 0; p < paints; p++)
+        {
+            for (const std::string& id : visible)
+            {
+                for (const OldRecord& record : old)
+                {
+                    if (std::get<1>(record) == id) { oldHits++; break; }
+                }
+            }
+        }
+    });
+    double newPaint = Bench::BestOf(3, [&]() {
+        newHits = 0;
+        for (long p = 0; p < paints; p++)
+        {
+            for (const std::string& id : visible)
+            {
+                if (table.FindArticleDisplay(id)) newHits++;
+            }
+        }
+    });
+    failures += Check(oldHits == newHits && newHits == paints * rows, "every visible row has an order");
+
+    double oldUpdate = Bench::BestOf(3, [&]() {
+        for (const std::string& orderId : orderIds)
+        {
+            auto it = std::find_if(old.begin(), old.end(), [&](const OldRecord& r) { return std::get<0>(r) == orderId; });
+            std::get<3>(*it)++;
+        }
+    });
+    double newUpdate = Bench::BestOf(3, [&]() {
+        for (const std::string& orderId : orderIds)
+            table.SetOrder({ orderId, "", 2, 1, OutputStatus::InProcess, false });
+    });
+    failures += Check(table.Size() == static_cast<size_t>(orders), "updates do not add orders");
+
+    std::printf("%ld active orders, %ld visible rows\n", orders, rows);
+    std::printf("%-28s %14s %14s\n", "", "scan (old)", "OrderTable");
+    std::printf("%-28s %14.2f %14.3f\n", "us per paint", oldPaint * 1e6 / static_cast<double>(paints),
+                newPaint * 1e6 / static_cast<double>(paints));
+    std::printf("%-28s %14.3f %14.3f\n", "us per status update", oldUpdate * 1e6 / static_cast<double>(orders),
+                newUpdate * 1e6 / static_cast<double>(orders));
+    return failures == 0 ? 0 : 1;
+}
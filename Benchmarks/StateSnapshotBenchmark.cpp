@@ -0,0 +1,264 @@
+// StateSnapshotBenchmark.cpp
+// Cost of publishing UI state versions (publish_state_locked in main.cpp) with 100k articles while
+// reader threads paint from the current version, as the UI thread does.
+//   - One order update: the writer holds the state mutex while it builds the next version. Before,
+//     the order displays were one vector copied per version; now only the touched chunk is cloned.
+//   - "Send all": N OutputRequests recorded at once, published once per article (the old loop,
+//     O(N * articles)) or once per batch.
+// Readers count painted frames; a painted row must never show a half-built version. The writer's
+// hold times include preemption by the readers when there are fewer cores than threads.
+//
+// Build: ./build.sh StateSnapshotBenchmark
+// Run:   bin/StateSnapshotBenchmark [--articles 100000] [--updates 2000] [--batch 1000] [--readers 2]
+
+#include "BenchmarkUtil.h"
+#include "StateSnapshot.h"
+#include "VersionedState.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace RowaPickupSlim;
+
+// The previous snapshot layout: the order displays as one shared vector
+struct OldSnapshot
+{
+    std::shared_ptr<const std::vector<std::string>> articleIds;
+    std::shared_ptr<const std::vector<OrderDisplay>> orders;
+};
+
+static OrderDisplay Display(const OrderTable& table, const std::string& articleId)
+{
+    OrderDisplay display;
+    if (const OutputRecord* record = table.FindArticleDisplay(articleId))
+    {
+        display.hasOrder = true;
+        display.status = record->status;
+        display.quantityRequested = record->quantityRequested;
+    }
+    return display;
+}
+
+// The old Snapshots::Orders(previous, ...): copy of the whole vector with one entry refreshed
+static std::shared_ptr<const std::vector<OrderDisplay>> OldOrders(const std::shared_ptr<const std::vector<OrderDisplay>>& previous,
+    const ArticleStore& store, const OrderTable& table, const std::string& articleId)
+{
+    auto display = std::make_shared<std::vector<OrderDisplay>>(*previous);
+    int index = store.FindArticleIndex(articleId);
+    if (index >= 0) (*display)[index] = Display(table, articleId);
+    return display;
+}
+
+struct State
+{
+    std::mutex mtx;
+    ArticleStore store;
+    OrderTable orders;
+    uint64_t nextOrder = 0;
+};
+
+// Readers paint 40 rows of the current version until stopped
+template <typename Snapshot, typename Paint>
+static long PaintUntil(VersionedState<Snapshot>& versions, const std::atomic<bool>& stop, Paint&& paint)
+{
+    long frames = 0;
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        auto snapshot = versions.Acquire();
+        paint(snapshot->value);
+        frames++;
+    }
+    return frames;
+}
+
+struct Run
+{
+    double writerSeconds = 0;
+    double p99HoldUs = 0;       // Time the writer held the state mutex per call
+    double maxHoldUs = 0;
+    long frames = 0;
+};
+
+// Time body(article) for count updates with readers running; body is called with the state mutex held
+template <typename Snapshot, typename Reader, typename Body>
+static Run Contend(VersionedState<Snapshot>& versions, State& state, int readers, long count, Reader&& paint, Body&& body)
+{
+    std::atomic<bool> stop{ false };
+    std::atomic<long> frames{ 0 };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < readers; i++)
+        threads.emplace_back([&]() { frames += PaintUntil(versions, stop, paint); });
+
+    Run run;
+    std::vector<double> holds;
+    Bench::Clock::time_point start = Bench::Clock::now();
+    for (long i = 0; i < count; i++)
+    {
+        std::lock_guard<std::mutex> lock(state.mtx);
+        Bench::Clock::time_point locked = Bench::Clock::now();
+        body(i);
+        holds.push_back(Bench::Seconds(Bench::Clock::now() - locked) * 1e6);
+    }
+    run.writerSeconds = Bench::Seconds(Bench::Clock::now() - start);
+
+    std::sort(holds.begin(), holds.end());
+    run.p99HoldUs = holds[holds.size() * 99 / 100];
+    run.maxHoldUs = holds.back();
+
+    stop = true;
+    for (std::thread& t : threads) t.join();
+    run.frames = frames.load();
+    return run;
+}
+
+static void Print(const char* name, long count, const Run& run)
+{
+    std::printf("%-34s %12.2f %12.1f %12.1f", name, run.writerSeconds * 1e6 / static_cast<double>(count), run.p99HoldUs,
+                run.maxHoldUs);
+    if (count > 1)
+        std::printf(" %14.0f\n", static_cast<double>(run.frames) / run.writerSeconds);
+    else
+        std::printf(" %14s\n", "-");
+}
+
+int main(int argc, char* argv[])
+{
+    const long articles = Bench::Option(argc, argv, "--articles", 100000);
+    const long updates = Bench::Option(argc, argv, "--updates", 2000);
+    const long batch = Bench::Option(argc, argv, "--batch", 1000);
+    const int readers = static_cast<int>(Bench::Option(argc, argv, "--readers", 2));
+    int failures = 0;
+
+    State state;
+    std::vector<Article> list;
+    for (long i = 0; i < articles; i++)
+        list.emplace_back("RoWa-" + std::to_string(100000 + i), 5);
+    state.store.Assign(std::move(list));
+
+    auto articleOf = [&](long i) -> const std::string& {
+        return state.store[static_cast<size_t>((i * 7919) % articles)].first;
+    };
+    auto addOrder = [&](const std::string& articleId) {
+        state.orders.SetOrder({ std::to_string(state.nextOrder++), articleId, 1, 0, OutputStatus::Queued, true });
+    };
+
+    // A paint reads 40 rows (ID and display order). Every row must be consistent with its own version
+    std::atomic<long> torn{ 0 };
+    auto paintNew = [&](const StateSnapshot& s) {
+        std::string id;
+        int quantity = 0;
+        OrderDisplay order;
+        for (size_t row = 0; row < 40; row++)
+        {
+            if (!s.GetRow((row * 2503) % s.RowCount(), id, quantity, order) || quantity != 5) torn++;
+        }
+        Bench::Keep(order);
+    };
+    auto paintOld = [&](const OldSnapshot& s) {
+        std::string id;
+        OrderDisplay order;
+        for (size_t row = 0; row < 40; row++)
+        {
+            size_t index = (row * 2503) % s.orders->size();
+            id = (*s.articleIds)[index];
+            order = (*s.orders)[index];
+        }
+        Bench::Keep(order);
+    };
+
+    VersionedState<StateSnapshot> versions;
+    {
+        StateSnapshot initial;
+        initial.articleIds = Snapshots::ArticleIds(state.store);
+        initial.quantities = Snapshots::Quantities(state.store);
+        initial.orders = Snapshots::Orders(state.store, state.orders);
+        versions.Publish(std::move(initial));
+    }
+    VersionedState<OldSnapshot> oldVersions;
+    {
+        OldSnapshot initial;
+        initial.articleIds = Snapshots::ArticleIds(state.store);
+        auto orders = std::make_shared<std::vector<OrderDisplay>>();
+        for (const Article& article : state.store)
+            orders->push_back(Display(state.orders, article.first));
+        initial.orders = std::move(orders);
+        oldVersions.Publish(std::move(initial));
+    }
+
+    std::printf("%ld articles, %d reader threads\n", articles, readers);
+    std::printf("%-34s %12s %12s %12s %14s\n", "", "us/publish", "p99 hold us", "max hold us", "paints/s");
+
+    // One order update per version
+    Run oldOne = Contend(oldVersions, state, readers, updates, paintOld, [&](long i) {
+        addOrder(articleOf(i));
+        auto previous = oldVersions.Acquire();
+        OldSnapshot next = previous->value;
+        next.orders = OldOrders(previous->value.orders, state.store, state.orders, articleOf(i));
+        oldVersions.Publish(std::move(next));
+    });
+    Print("order update, vector copy (old)", updates, oldOne);
+
+    Run newOne = Contend(versions, state, readers, updates, paintNew, [&](long i) {
+        addOrder(articleOf(i));
+        auto previous = versions.Acquire();
+        StateSnapshot next = previous->value;
+        next.orders = Snapshots::Orders(previous->value.orders, state.store, state.orders, { articleOf(i) });
+        versions.Publish(std::move(next));
+    });
+    Print("order update, chunked", updates, newOne);
+
+    // The latest version must show every order added so far, and share the untouched chunks
+    {
+        auto snapshot = versions.Acquire();
+        const StateSnapshot& s = snapshot->value;
+        for (long i = 0; i < updates; i++)
+        {
+            int index = state.store.FindArticleIndex(articleOf(i));
+            if (!s.orders[index].hasOrder) { failures++; break; }
+        }
+        StateSnapshot copy = s;
+        copy.orders.Set(0, OrderDisplay());
+        if (copy.orders.SharedChunks() + 1 < (static_cast<size_t>(articles) + 1023) / 1024)
+        {
+            std::printf("CHECK FAILED: a Set() cloned more than one chunk\n");
+            failures++;
+        }
+    }
+
+    // "Send all": batch orders, published per article (old) or once (new); the time is per batch
+    Run oldBatch = Contend(oldVersions, state, readers, 1, paintOld, [&](long) {
+        for (long i = 0; i < batch; i++)
+        {
+            addOrder(articleOf(i));
+            auto previous = oldVersions.Acquire();
+            OldSnapshot next = previous->value;
+            next.orders = OldOrders(previous->value.orders, state.store, state.orders, articleOf(i));
+            oldVersions.Publish(std::move(next));
+        }
+    });
+    Print("send all, per article (old)", 1, oldBatch);
+
+    Run newBatch = Contend(versions, state, readers, 1, paintNew, [&](long) {
+        std::vector<std::string> changed;
+        for (long i = 0; i < batch; i++)
+        {
+            addOrder(articleOf(i));
+            changed.push_back(articleOf(i));
+        }
+        auto previous = versions.Acquire();
+        StateSnapshot next = previous->value;
+        next.orders = Snapshots::Orders(previous->value.orders, state.store, state.orders, changed);
+        versions.Publish(std::move(next));
+    });
+    Print("send all, one publish, chunked", 1, newBatch);
+    std::printf("(send all: %ld OutputRequests; us/publish is per batch)\n", batch);
+
+    if (torn.load() != 0)
+    {
+        std::printf("CHECK FAILED: %ld painted rows did not match their version\n", torn.load());
+        failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
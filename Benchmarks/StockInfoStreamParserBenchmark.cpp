@@ -0,0 +1,103 @@
+// StockInfoStreamParserBenchmark.cpp
+// StockInfoStreamParser on a StockInfoResponse with 100k articles (each with nested packs), fed
+// whole and in recv-sized chunks, against the pugixml DOM + iteration main.cpp used before.
+// Every chunking must report the same articles; nested Pack/Article elements must not be reported.
+//
+// Build: ./build.sh StockInfoStreamParserBenchmark    Run: bin/StockInfoStreamParserBenchmark [--articles 100000]
+
+#include "BenchmarkUtil.h"
+#include "StockInfoStreamParser.h"
+#include "pugixml.hpp"
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+using namespace RowaPickupSlim;
+
+static std::string MakeResponse(long articles)
+{
+    std::string response = "<?xml version=\"1.0\"?><WWKS Version=\"2.0\"><!-- a > b --><StockInfoResponse Id=\"1\" Source=\"999\" Destination=\"100\">";
+    for (long i = 0; i < articles; i++)
+    {
+        response += "<Article Id=\"RoWa-" + std::to_string(100000 + i) + "\" Name=\"A &amp; B > c\" Quantity=\"" +
+                    std::to_string(i % 7) + "\">";
+        for (int k = 0; k < 2; k++)
+            response += "<Pack Id=\"" + std::to_string(k) + "\" ExpiryDate=\"2026-01-01\"><Article Id=\"nested\" Quantity=\"99\"/></Pack>";
+        response += "</Article>";
+    }
+    response += "<Article Id=\"R&amp;D\" Quantity=\"5\"/></StockInfoResponse></WWKS>";
+    return response;
+}
+
+struct Result
+{
+    size_t articles = 0;
+    long quantity = 0;
+    bool nestedReported = false;
+    bool complete = false;
+    std::string last;
+};
+
+// The parser's callback adds to result
+static void RunStream(StockInfoStreamParser& parser, Result& result, const std::string& response, size_t chunkSize)
+{
+    result = Result();
+    parser.Reset();
+    for (size_t offset = 0; offset < response.size(); offset += chunkSize)
+        parser.Feed(response.data() + offset, std::min(chunkSize, response.size() - offset));
+    result.complete = parser.IsComplete();
+}
+
+static Result RunDom(const std::string& response)
+{
+    Result result;
+    pugi::xml_document doc;
+    result.complete = static_cast<bool>(doc.load_string(response.c_str()));
+    for (pugi::xml_node article : doc.child("WWKS").child("StockInfoResponse").children("Article"))
+    {
+        result.articles++;
+        result.quantity += article.attribute("Quantity").as_int();
+        result.last = article.attribute("Id").value();
+    }
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    const long articles = Bench::Option(argc, argv, "--articles", 100000);
+    const std::string response = MakeResponse(articles);
+    const double mb = static_cast<double>(response.size()) / 1e6;
+    std::printf("response: %.1f MB, %ld articles with 2 packs each\n", mb, articles + 1);
+
+    Result result;
+    StockInfoStreamParser parser([&](std::string_view id, int quantity) {
+        result.articles++;
+        result.quantity += quantity;
+        if (id == "nested") result.nestedReported = true;
+        result.last.assign(id);
+    });
+
+    const Result dom = RunDom(response);
+    int failures = 0;
+    std::printf("%-28s %10s %10s %12s %12s\n", "", "chunk", "articles", "ms", "articles/s");
+    for (size_t chunk : { response.size(), size_t(65536), size_t(8192), size_t(13) })
+    {
+        double seconds = Bench::BestOf(chunk < 64 ? 1 : 5, [&]() { RunStream(parser, result, response, chunk); });
+        const Result& r = result;
+        std::printf("%-28s %10zu %10zu %12.1f %12.0f\n", "StockInfoStreamParser", chunk, r.articles, seconds * 1e3,
+                    static_cast<double>(r.articles) / seconds);
+
+        if (!r.complete || r.nestedReported || r.articles != dom.articles || r.quantity != dom.quantity || r.last != "R&D")
+        {
+            std::printf("MISMATCH at chunk %zu: %zu articles, quantity %ld, last \"%s\"%s%s\n", chunk, r.articles, r.quantity,
+                        r.last.c_str(), r.complete ? "" : ", incomplete", r.nestedReported ? ", nested article reported" : "");
+            failures++;
+        }
+    }
+
+    Result d;
+    double seconds = Bench::BestOf(3, [&]() { d = RunDom(response); });
+    std::printf("%-28s %10s %10zu %12.1f %12.0f\n", "pugixml DOM (old)", "-", d.articles, seconds * 1e3,
+                static_cast<double>(d.articles) / seconds);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+// WwksMessageBuilderBenchmark.cpp
+// Messages per second built, and heap allocations per message, for an OutputRequest (the message
+// main.cpp sends per scanned article) with WwksMessageBuilder, against the old ostringstream +
+// gmtime + strftime assembly; and for the KeepAliveResponse rendered by KeepAliveReply.
+// Allocations are counted by replacing the global operator new in this binary.
+// Checks that the builder produces the same bytes as the old code and that it escapes values.
+//
+// Build: ./build.sh WwksMessageBuilderBenchmark    Run: bin/WwksMessageBuilderBenchmark [--messages 2000000]
+
+#include "BenchmarkUtil.h"
+#include "KeepAliveReply.h"
+#include "WwksClassifier.h"
+#include "WwksMessageBuilder.h"
+#include <atomic>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+#include <sstream>
+#include <string>
+
+using namespace RowaPickupSlim;
+
+static std::atomic<uint64_t> g_allocations{ 0 };
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// The old main.cpp code path: timestamp with gmtime + strftime, message with an ostringstream
+static std::string OldTimestamp(std::time_t now)
+{
+    std::tm tm{};
+    gmtime_r(&now, &tm);
+    char buffer[64];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    return buffer;
+}
+
+static std::string OldOutputRequest(std::time_t now, const std::string& id, int source, const std::string& articleId, int quantity)
+{
+    std::ostringstream ss;
+    ss << "<WWKS Version=\"2.0\" TimeStamp=\"" << OldTimestamp(now) << "\">";
+    ss << "<OutputRequest Id=\"" << id << "\" Source=\"" << source << "\" Destination=\"999\">";
+    ss << "<Details OutputDestination=\"1\" Priority=\"Normal\" />";
+    ss << "<Criteria ArticleId=\"" << articleId << "\" Quantity=\"" << quantity << "\" />";
+    ss << "</OutputRequest></WWKS>";
+    return ss.str();
+}
+
+static std::string_view NewOutputRequest(WwksMessageBuilder& builder, std::time_t now, const std::string& id, int source,
+    const std::string& articleId, int quantity)
+{
+    builder.Begin(now)
+        .Element("OutputRequest").Attribute("Id", id).Attribute("Source", source).AttributeRaw("Destination", "999").Children()
+        .Element("Details").AttributeRaw("OutputDestination", "1").AttributeRaw("Priority", "Normal").Empty()
+        .Element("Criteria").Attribute("ArticleId", articleId).Attribute("Quantity", quantity).Empty()
+        .Close("OutputRequest");
+    return builder.End();
+}
+
+struct Result
+{
+    double messagesPerSecond = 0;
+    double allocationsPerMessage = 0;
+};
+
+// count calls of build(now, i); the clock advances one second every 1000 messages
+template <typename Build>
+static Result Measure(long count, Build&& build)
+{
+    const std::time_t start = std::time(nullptr);
+    size_t bytes = 0;
+    uint64_t allocations = g_allocations.load();
+    Bench::Clock::time_point begin = Bench::Clock::now();
+    for (long i = 0; i < count; i++) bytes += build(start + i / 1000, i);
+    double seconds = Bench::Seconds(Bench::Clock::now() - begin);
+    Result result;
+    result.messagesPerSecond = static_cast<double>(count) / seconds;
+    result.allocationsPerMessage = static_cast<double>(g_allocations.load() - allocations) / static_cast<double>(count);
+    Bench::Keep(bytes);
+    return result;
+}
+
+static void Print(const char* name, const Result& result)
+{
+    std::printf("%-40s %12.0f %14.2f\n", name, result.messagesPerSecond, result.allocationsPerMessage);
+}
+
+int main(int argc, char* argv[])
+{
+    const long messages = Bench::Option(argc, argv, "--messages", 2000000);
+    int failures = 0;
+
+    const std::string id = "123456789";
+    const std::string articleId = "RoWa00020556";
+    WwksMessageBuilder builder;
+
+    // Same bytes as before, for a range of quantities and across second boundaries
+    const std::time_t now = std::time(nullptr);
+    for (int i = 0; i < 3000; i++)
+    {
+        if (OldOutputRequest(now + i / 1000, id, 101, articleId, i % 50) != NewOutputRequest(builder, now + i / 1000, id, 101, articleId, i % 50))
+        {
+            std::printf("CHECK FAILED: the builder's OutputRequest differs from the old one (quantity %d)\n", i % 50);
+            failures++;
+            break;
+        }
+    }
+    std::string escaped;
+    WwksMessageBuilder::AppendEscaped(escaped, std::string_view("a&b<c>\"d'e\tf\ng\x01h", 17));
+    if (escaped != "a&amp;b&lt;c&gt;&quot;d&apos;e&#9;f&#10;gh")
+    {
+        std::printf("CHECK FAILED: escaped as %s\n", escaped.c_str());
+        failures++;
+    }
+
+    std::printf("%ld messages, %zu-byte OutputRequest\n", messages, OldOutputRequest(now, id, 101, articleId, 1).size());
+    std::printf("%-40s %12s %14s\n", "", "msgs/s", "allocs/msg");
+
+    Result old = Measure(messages / 4, [&](std::time_t t, long i) {
+        return OldOutputRequest(t, id, 101, articleId, static_cast<int>(i % 50)).size();
+    });
+    Print("OutputRequest, ostringstream (old)", old);
+
+    Result built = Measure(messages, [&](std::time_t t, long i) {
+        return NewOutputRequest(builder, t, id, 101, articleId, static_cast<int>(i % 50)).size();
+    });
+    Print("OutputRequest, WwksMessageBuilder", built);
+    if (built.allocationsPerMessage != 0)
+    {
+        std::printf("CHECK FAILED: the builder allocated in steady state\n");
+        failures++;
+    }
+
+    // KeepAliveResponse from the request's start tag, into a reused string
+    KeepAliveReply keepAlive;
+    std::string request = "<WWKS Version=\"2.0\" TimeStamp=\"2026-01-01T00:00:00Z\"><KeepAliveRequest Id=\"77\" Source=\"999\" Destination=\"101\" /></WWKS>";
+    std::string_view tag;
+    ClassifyWwksFrame(request, &tag);
+    std::string reply;
+    keepAlive.Render(tag, now, reply);
+    Result keepAlives = Measure(messages, [&](std::time_t t, long) {
+        keepAlive.Render(tag, t, reply);
+        return reply.size();
+    });
+    Print("KeepAliveResponse, KeepAliveReply", keepAlives);
+    if (keepAlives.allocationsPerMessage != 0)
+    {
+        std::printf("CHECK FAILED: KeepAliveReply allocated in steady state\n");
+        failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+// WwksMessageParserBenchmark.cpp
+// ns and heap allocations per received message parsed into a DOM: WwksMessageParser (in place,
+// pugixml allocating from a reused ParseArena) against the old receive path (a copy of the frame
+// in a new shared message, load_string copying it again into pugixml pages from the heap).
+// The frames are a fixed mix of what the robot sends besides KeepAlives and StockInfoResponses:
+// Output/Status/Hello/TaskInfo responses and OutputMessages with 1 to 40 articles.
+// Allocations are counted by replacing malloc in this binary (glibc), which sees pugixml's pages
+// as well as operator new; elsewhere only operator new is counted.
+// Checks that both paths read the same message and that the parser does not allocate in steady state.
+//
+// Build: ./build.sh WwksMessageParserBenchmark    Run: bin/WwksMessageParserBenchmark [--rounds 50]
+
+#include "BenchmarkUtil.h"
+#include "WwksMessage.h"
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace RowaPickupSlim;
+
+static std::atomic<uint64_t> g_allocations{ 0 };
+
+#if defined(__GLIBC__)
+#define COUNTED "malloc"
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* p, size_t size);
+
+extern "C" void* malloc(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* p, size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(p, size);
+}
+#else
+#define COUNTED "operator new"
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+#endif
+
+static std::string Frame(const std::string& body)
+{
+    return "<WWKS Version=\"2.0\" TimeStamp=\"2026-01-15T10:20:30Z\">" + body + "</WWKS>";
+}
+
+static std::string Route(int id)
+{
+    return " Id=\"" + std::to_string(id) + "\" Source=\"999\" Destination=\"100\"";
+}
+
+static std::string Articles(int count, int seed)
+{
+    std::string xml;
+    for (int a = 0; a < count; a++)
+    {
+        xml += "<Article Id=\"RoWa-" + std::to_string(100000 + (seed * 31 + a) % 5000) + "\" Name=\"Article &amp; " +
+               std::to_string(a) + "\" Quantity=\"2\">";
+        for (int p = 0; p < 2; p++)
+            xml += "<Pack Id=\"" + std::to_string(seed * 100 + a * 2 + p) + "\" ExpiryDate=\"2027-0" + std::to_string(1 + p) +
+                   "-15\" BatchNumber=\"B" + std::to_string(a) + "\" />";
+        xml += "</Article>";
+    }
+    return xml;
+}
+
+struct Received
+{
+    std::string frame;
+    WwksMessageType type;
+};
+
+// The same mix every run
+static std::vector<Received> Mix()
+{
+    std::vector<Received> mix;
+    for (int i = 0; i < 200; i++)
+    {
+        switch (i % 5)
+        {
+        case 0:
+            mix.push_back({ Frame("<OutputResponse" + Route(i) + "><Details OutputDestination=\"1\" Status=\"Queued\" />"
+                                  "<Criteria ArticleId=\"RoWa-100001\" Quantity=\"1\" /></OutputResponse>"), WwksMessageType::OutputResponse });
+            break;
+        case 1:
+            mix.push_back({ Frame("<OutputMessage" + Route(i) + "><Details OutputDestination=\"1\" Status=\"Completed\" />" +
+                                  Articles(1 + (i * 7) % 40, i) + "</OutputMessage>"), WwksMessageType::OutputMessage });
+            break;
+        case 2:
+            mix.push_back({ Frame("<StatusResponse" + Route(i) + " State=\"Ready\"><Component Type=\"StorageSystem\" "
+                                  "Description=\"Robot 999\" State=\"Ready\" StateText=\"Ready\" /></StatusResponse>"), WwksMessageType::StatusResponse });
+            break;
+        case 3:
+            mix.push_back({ Frame("<TaskInfoResponse" + Route(i) + "><Task Type=\"Output\" Id=\"" + std::to_string(i) +
+                                  "\" Status=\"InProcess\">" + Articles(1 + i % 5, i) + "</Task></TaskInfoResponse>"), WwksMessageType::TaskInfoResponse });
+            break;
+        default:
+            mix.push_back({ Frame("<HelloResponse Id=\"" + std::to_string(i) + "\"><Subscriber Id=\"999\" Type=\"StorageSystem\">"
+                                  "<Capability Name=\"Output\" /><Capability Name=\"TaskInfo\" /></Subscriber></HelloResponse>"), WwksMessageType::HelloResponse });
+            break;
+        }
+    }
+    return mix;
+}
+
+// The old receive path: the closure's copy of the frame becomes a new shared message, parsed by load_string
+struct OldMessage
+{
+    std::string xml;
+    pugi::xml_document document;
+    pugi::xml_node root;
+    pugi::xml_node body;
+};
+
+static std::shared_ptr<OldMessage> OldParse(const std::string& frame, WwksMessageType type)
+{
+    auto message = std::make_shared<OldMessage>();
+    message->xml = frame;
+    if (!message->document.load_string(message->xml.c_str())) return message;
+    message->root = message->document.child("WWKS");
+    if (message->root) message->body = message->root.child(ToString(type));
+    return message;
+}
+
+// Pack elements of the articles below node
+static size_t Packs(pugi::xml_node node)
+{
+    size_t packs = 0;
+    for (pugi::xml_node article : node.children("Article"))
+    {
+        for (pugi::xml_node pack : article.children("Pack"))
+        {
+            if (pack.attribute("ExpiryDate")) packs++;
+        }
+    }
+    return packs;
+}
+
+// What a handler reads: element name, Id, the first article's (unescaped) name and the packs
+static std::string Summary(pugi::xml_node body)
+{
+    size_t packs = Packs(body) + Packs(body.child("Task"));
+    return std::string(body.name()) + "/" + body.attribute("Id").value() + "/" + body.child("Article").attribute("Name").value() + "/" +
+           std::to_string(packs);
+}
+
+int main(int argc, char* argv[])
+{
+    const long rounds = Bench::Option(argc, argv, "--rounds", 50);
+    int failures = 0;
+
+    const std::vector<Received> mix = Mix();
+    size_t bytes = 0;
+    for (const Received& r : mix) bytes += r.frame.size();
+
+    // Both paths read the same message
+    WwksMessageParser parser;
+    std::string frame;
+    for (const Received& r : mix)
+    {
+        std::shared_ptr<OldMessage> old = OldParse(r.frame, r.type);
+        frame.assign(r.frame);
+        const WwksMessage& message = parser.Parse(frame, r.type);
+        if (!message.body || Summary(old->body) != Summary(message.body))
+        {
+            std::printf("CHECK FAILED: %s parsed differently\n", ToString(r.type));
+            failures++;
+            break;
+        }
+    }
+
+    const double messages = static_cast<double>(mix.size() * static_cast<size_t>(rounds));
+    std::printf("%zu frames, %zu bytes on average, %ld rounds; allocations counted through %s\n", mix.size(), bytes / mix.size(),
+                rounds, COUNTED);
+    std::printf("%-44s %10s %12s\n", "", "ns/msg", "allocs/msg");
+
+    // Best of 3 runs of rounds x the mix; allocations are per message over all runs
+    const int runs = 3;
+    size_t found = 0;
+    uint64_t allocations = g_allocations.load();
+    double seconds = Bench::BestOf(runs, [&]() {
+        for (long round = 0; round < rounds; round++)
+        {
+            for (const Received& r : mix)
+            {
+                std::string copy(r.frame);      // The frame copied into the dispatch closure
+                std::shared_ptr<OldMessage> old = OldParse(copy, r.type);
+                if (old->body) found++;
+            }
+        }
+    });
+    std::printf("%-44s %10.0f %12.2f\n", "copy + shared message + load_string (old)", seconds * 1e9 / messages,
+                static_cast<double>(g_allocations.load() - allocations) / (messages * runs));
+
+    // The receive buffer is reused: Parse() swaps it with the previous message's
+    allocations = g_allocations.load();
+    seconds = Bench::BestOf(runs, [&]() {
+        for (long round = 0; round < rounds; round++)
+        {
+            for (const Received& r : mix)
+            {
+                frame.assign(r.frame);
+                if (parser.Parse(frame, r.type).body) found++;
+            }
+        }
+    });
+    uint64_t allocated = g_allocations.load() - allocations;
+    Bench::Keep(found);
+    std::printf("%-44s %10.0f %12.2f\n", "WwksMessageParser, in place in the arena", seconds * 1e9 / messages,
+                static_cast<double>(allocated) / (messages * runs));
+    ParseArena::Counters arena = parser.GetArenaCounters();
+    std::printf("  arena: %zu KB, high water %zu KB, %llu blocks added\n", arena.capacity / 1024, arena.highWater / 1024,
+                static_cast<unsigned long long>(arena.blocksAdded));
+    if (allocated != 0)
+    {
+        std::printf("CHECK FAILED: %llu heap allocations in steady state\n", static_cast<unsigned long long>(allocated));
+        failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+#!/bin/sh
+# Build the benchmarks on Linux (g++ or clang++ with C++20).
+# Usage: ./build.sh [name...]      (default: all; binaries go to ./bin)
+# One benchmark per module, <Module>Benchmark.cpp, linked with the RowaPickupSlim sources it measures.
+
+set -e
+cd "$(dirname "$0")"
+
+SRC=../RowaPickupSlim
+CXX="${CXX:-g++}"
+CXXFLAGS="-std=c++20 -O2 -Wall -Wextra -pthread -I$SRC"
+WANTED="$*"
+
+mkdir -p bin
+
+# pugixml is compiled once and shared by the benchmarks that parse XML
+pugixml()
+{
+    if [ ! -f bin/pugixml.o ] || [ "$SRC/pugixml.cpp" -nt bin/pugixml.o ]; then
+        $CXX $CXXFLAGS -c "$SRC/pugixml.cpp" -o bin/pugixml.o
+    fi
+    echo bin/pugixml.o
+}
+
+# benchmark <name> <sources...>
+benchmark()
+{
+    name="$1"
+    shift
+    if [ -n "$WANTED" ]; then
+        case " $WANTED " in
+            *" $name "*) ;;
+            *) return 0 ;;
+        esac
+    fi
+    $CXX $CXXFLAGS "$name.cpp" "$@" -o "bin/$name"
+    echo "Built bin/$name"
+}
+
+benchmark FrameSplitterBenchmark "$SRC/WwksFrameSplitter.cpp"
+benchmark ClassifierBenchmark "$SRC/WwksClassifier.cpp" "$(pugixml)"
+benchmark StockInfoStreamParserBenchmark "$SRC/StockInfoStreamParser.cpp" "$SRC/WwksClassifier.cpp" "$(pugixml)"
+benchmark OrderTableBenchmark "$SRC/OrderTable.cpp"
+benchmark StateSnapshotBenchmark "$SRC/StateSnapshot.cpp" "$SRC/ArticleStore.cpp" "$SRC/OrderTable.cpp"
+benchmark AsyncLoggerBenchmark "$SRC/AsyncLogger.cpp" "$SRC/IsoTimestamp.cpp"
+benchmark WwksMessageBuilderBenchmark "$SRC/WwksMessageBuilder.cpp" "$SRC/KeepAliveReply.cpp" "$SRC/IsoTimestamp.cpp" \
+    "$SRC/WwksClassifier.cpp"
+benchmark IsoTimestampBenchmark "$SRC/IsoTimestamp.cpp"
+benchmark WwksMessageParserBenchmark "$SRC/WwksMessage.cpp" "$SRC/ParseArena.cpp" "$SRC/WwksClassifier.cpp" "$(pugixml)"
+benchmark LoopbackBenchmark "$SRC/LoopbackTransport.cpp" \
+    "$SRC/networkclient_fixed.cpp" "$SRC/Reactor.cpp" "$SRC/SendQueue.cpp" "$SRC/Handshake.cpp" "$SRC/RequestTracker.cpp" \
+    "$SRC/ReconnectPolicy.cpp" "$SRC/TcpConnector.cpp" "$SRC/LivenessMonitor.cpp" "$SRC/KeepAliveReply.cpp" \
+    "$SRC/WwksMessageBuilder.cpp" "$SRC/IsoTimestamp.cpp" "$SRC/LatencyHistogram.cpp" "$SRC/MessageDispatcher.cpp" \
+    "$SRC/TcpTransport.cpp" "$SRC/TrafficCapture.cpp" "$SRC/WwksFrameSplitter.cpp" "$SRC/WwksClassifier.cpp" \
+    "$SRC/WwksMessage.cpp" "$SRC/ParseArena.cpp" "$(pugixml)"
@@ -0,0 +1,20 @@
+#!/bin/sh
+# Build the capture tool on Linux (g++ or clang++ with C++20).
+# Usage: ./build.sh [output]      (default: ./wwkscap)
+# Links the capture / replay modules and the portable state stores; none of them depend on Windows.
+
+set -e
+cd "$(dirname "$0")"
+
+SRC=../RowaPickupSlim
+CXX="${CXX:-g++}"
+OUT="${1:-wwkscap}"
+
+"$CXX" -std=c++20 -O2 -Wall -Wextra -pthread -I"$SRC" \
+    main.cpp \
+    "$SRC/TrafficCapture.cpp" "$SRC/TrafficReplay.cpp" "$SRC/LatencyHistogram.cpp" "$SRC/WwksClassifier.cpp" \
+    "$SRC/WwksMessage.cpp" "$SRC/ParseArena.cpp" "$SRC/StockInfoStreamParser.cpp" "$SRC/ArticleStore.cpp" "$SRC/OrderTable.cpp" \
+    "$SRC/pugixml.cpp" \
+    -o "$OUT"
+
+echo "Built $OUT"
@@ -0,0 +1,436 @@
+// main.cpp
+// WWKS traffic capture tool (Linux): inspects captures written by NetworkClient::SetCapture
+// (RowaPickupSlim /capture), converts Protocol .log files into captures, and replays a capture
+// into the portable state stores to measure messages per second.
+//
+// Build: ./build.sh    Run: ./wwkscap replay 20260101_080000.wwkscap --speed 0 --repeat 10
+
+#include "ArticleStore.h"
+#include "OrderTable.h"
+#include "StockInfoStreamParser.h"
+#include "TrafficCapture.h"
+#include "TrafficReplay.h"
+#include "WwksClassifier.h"
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <csignal>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace RowaPickupSlim;
+
+static TrafficReplay* g_running = nullptr;
+
+static void on_signal(int)
+{
+    if (g_running) g_running->Stop();
+}
+
+static void print_usage()
+{
+    std::printf(
+        "usage: wwkscap <command> ...\n"
+        "  info <capture>                     records and bytes per direction and message type\n"
+        "  dump <capture> [--max N]           one line per record: time, direction, type, Id, size\n"
+        "  import <protocol.log> <capture>    convert the INCOMING / OUTGOING blocks of a Protocol log\n"
+        "  replay <capture> [options]         feed the inbound messages into the state stores\n"
+        "      --speed X      1 = recorded pace, 0 = as fast as possible (1)\n"
+        "      --repeat N     replay N times (1)\n"
+        "      --parse-only   classify and parse only, no state update\n");
+}
+
+static long long us(std::chrono::nanoseconds d)
+{
+    return static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+}
+
+static bool open_capture(const std::string& path, TrafficCaptureReader& reader)
+{
+    std::string error;
+    if (reader.Open(path, error)) return true;
+
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return false;
+}
+
+static void report_truncated(const TrafficCaptureReader& reader)
+{
+    if (reader.IsTruncated())
+        std::printf("warning: the capture ends in an incomplete record\n");
+}
+
+// ============================================================================
+// info / dump
+// ============================================================================
+
+static int run_info(const std::string& path)
+{
+    TrafficCaptureReader reader;
+    if (!open_capture(path, reader)) return 1;
+
+    struct Totals
+    {
+        uint64_t records = 0;
+        uint64_t bytes = 0;
+        uint64_t largest = 0;
+    };
+    std::array<std::array<Totals, static_cast<size_t>(WwksMessageType::KeepAliveResponse) + 1>, 2> totals{};
+
+    TrafficRecord record;
+    std::chrono::nanoseconds last{};
+    uint64_t records = 0;
+    uint64_t gaps = 0;
+    while (reader.Next(record))
+    {
+        last = record.time;
+        if (record.direction == TrafficDirection::Gap)
+        {
+            gaps++;
+            continue;
+        }
+
+        Totals& t = totals[static_cast<size_t>(record.direction)][static_cast<size_t>(ClassifyWwksFrame(record.frame))];
+        t.records++;
+        t.bytes += record.frame.size();
+        if (record.frame.size() > t.largest) t.largest = record.frame.size();
+        records++;
+    }
+
+    std::time_t started = std::chrono::system_clock::to_time_t(reader.StartTime());
+    char when[64];
+    std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S UTC", std::gmtime(&started));
+    std::printf("%s: %llu records over %.3f s, started %s\n", path.c_str(), (unsigned long long)records,
+                std::chrono::duration<double>(last).count(), when);
+
+    std::printf("%-4s %-18s %10s %12s %10s\n", "dir", "type", "records", "bytes", "largest");
+    for (size_t d = 0; d < totals.size(); d++)
+    {
+        for (size_t type = 0; type < totals[d].size(); type++)
+        {
+            const Totals& t = totals[d][type];
+            if (t.records == 0) continue;
+            const char* name = type == 0 ? "(unknown)" : ToString(static_cast<WwksMessageType>(type));
+            std::printf("%-4s %-18s %10llu %12llu %10llu\n", d == 0 ? "in" : "out", name,
+                        (unsigned long long)t.records, (unsigned long long)t.bytes, (unsigned long long)t.largest);
+        }
+    }
+    if (gaps > 0)
+        std::printf("warning: %llu gaps where frames were dropped while capturing (see dump)\n", (unsigned long long)gaps);
+    report_truncated(reader);
+    return 0;
+}
+
+static int run_dump(const std::string& path, uint64_t max)
+{
+    TrafficCaptureReader reader;
+    if (!open_capture(path, reader)) return 1;
+
+    TrafficRecord record;
+    for (uint64_t n = 0; (max == 0 || n < max) && reader.Next(record); n++)
+    {
+        if (record.direction == TrafficDirection::Gap)
+        {
+            std::printf("%14.6f gap %s\n", std::chrono::duration<double>(record.time).count(), record.frame.c_str());
+            continue;
+        }
+
+        std::string_view bodyTag;
+        WwksMessageType type = ClassifyWwksFrame(record.frame, &bodyTag);
+        std::string_view id;
+        FindTagAttribute(bodyTag, "Id", id);
+
+        std::printf("%14.6f %-3s %-18s %-24.*s %zu\n", std::chrono::duration<double>(record.time).count(),
+                    record.direction == TrafficDirection::Inbound ? "in" : "out",
+                    type == WwksMessageType::Unknown ? "(unknown)" : ToString(type),
+                    static_cast<int>(id.size()), id.data(), record.frame.size());
+    }
+    report_truncated(reader);
+    return 0;
+}
+
+// ============================================================================
+// import: Protocol .log -> capture
+// ============================================================================
+
+// Log lines start with "[HH:MM:SS] " (AsyncLogger::FormatLine); the message blocks are
+//   [HH:MM:SS] \n<<< INCOMING MESSAGE <<<\n<xml>\n<<< END INCOMING <<<\n   (and >>> OUTGOING ... for sent frames)
+// The log has one-second resolution, so frames logged in the same second get the same timestamp.
+static bool parse_log_time(const std::string& line, int& secondOfDay)
+{
+    if (line.size() < 10 || line[0] != '[' || line[3] != ':' || line[6] != ':' || line[9] != ']') return false;
+    for (int i : { 1, 2, 4, 5, 7, 8 })
+    {
+        if (!std::isdigit(static_cast<unsigned char>(line[i]))) return false;
+    }
+    secondOfDay = ((line[1] - '0') * 10 + (line[2] - '0')) * 3600 + ((line[4] - '0') * 10 + (line[5] - '0')) * 60 +
+                  (line[7] - '0') * 10 + (line[8] - '0');
+    return true;
+}
+
+static int run_import(const std::string& logPath, const std::string& capturePath)
+{
+    std::ifstream log(logPath, std::ios::binary);
+    if (!log)
+    {
+        std::fprintf(stderr, "cannot open %s\n", logPath.c_str());
+        return 1;
+    }
+
+    TrafficCaptureWriter writer(1024 * 1024 * 1024);
+    if (!writer.Open(capturePath))
+    {
+        std::fprintf(stderr, "cannot create %s\n", capturePath.c_str());
+        return 1;
+    }
+    const auto base = TrafficCaptureWriter::Clock::now();
+
+    std::string line;
+    std::string frame;
+    bool inFrame = false;
+    TrafficDirection direction = TrafficDirection::Inbound;
+    int firstSecond = -1;
+    int lastSecond = 0;
+    int days = 0;
+    uint64_t frames = 0;
+
+    while (std::getline(log, line))
+    {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        if (inFrame)
+        {
+            bool end = direction == TrafficDirection::Inbound ? line == "<<< END INCOMING <<<" : line == ">>> END OUTGOING <<<";
+            if (!end)
+            {
+                if (!frame.empty()) frame.push_back('\n');
+                frame += line;
+                continue;
+            }
+
+            int seconds = days * 86400 + lastSecond - (firstSecond < 0 ? lastSecond : firstSecond);
+            writer.Record(direction, frame, base + std::chrono::seconds(seconds));
+            frames++;
+            inFrame = false;
+            continue;
+        }
+
+        int second = 0;
+        if (parse_log_time(line, second))
+        {
+            if (firstSecond < 0) firstSecond = second;
+            if (second < lastSecond) days++;    // Past midnight
+            lastSecond = second;
+        }
+        else if (line == "<<< INCOMING MESSAGE <<<" || line == ">>> OUTGOING MESSAGE <<<")
+        {
+            direction = line[0] == '<' ? TrafficDirection::Inbound : TrafficDirection::Outbound;
+            frame.clear();
+            inFrame = true;
+        }
+    }
+
+    writer.Stop();
+    TrafficCaptureWriter::Counters c = writer.GetCounters();
+    std::printf("%s: %llu frames -> %s (%llu bytes)%s\n", logPath.c_str(), (unsigned long long)frames, capturePath.c_str(),
+                (unsigned long long)c.bytes, inFrame ? ", last block not terminated" : "");
+    return c.dropped == 0 ? 0 : 1;
+}
+
+// ============================================================================
+// replay
+// ============================================================================
+
+// The parts of the application's state update that do not depend on Windows: the article list
+// from StockInfoResponse and the order table from OutputResponse / OutputMessage / TaskInfoResponse
+class ReplayState
+{
+public:
+    void Apply(const WwksMessage& message)
+    {
+        switch (message.type)
+        {
+        case WwksMessageType::StockInfoResponse:
+            ApplyStock(message);
+            break;
+        case WwksMessageType::OutputResponse:
+        case WwksMessageType::OutputMessage:
+        case WwksMessageType::TaskInfoResponse:
+            ApplyOrder(message);
+            break;
+        default:
+            break;
+        }
+    }
+
+    size_t Articles() const { return _articles.Size(); }
+    size_t Orders() const { return _orders.Size(); }
+
+private:
+    void ApplyStock(const WwksMessage& message)
+    {
+        std::vector<Article> list;
+        StockInfoStreamParser parser([&list](std::string_view id, int qty) {
+            // Same filter as the application: only articles starting with "RoWa" (case-insensitive)
+            if (id.size() >= 4 && std::toupper((unsigned char)id[0]) == 'R' && std::toupper((unsigned char)id[1]) == 'O' &&
+                std::toupper((unsigned char)id[2]) == 'W' && std::toupper((unsigned char)id[3]) == 'A')
+            {
+                list.emplace_back(std::string(id), qty);
+            }
+        });
+        parser.Feed(message.xml.data(), message.xml.size());
+        if (parser.IsComplete()) _articles.Assign(std::move(list));
+    }
+
+    void ApplyOrder(const WwksMessage& message)
+    {
+        if (!message.body) return;
+
+        pugi::xml_node details = message.body.child("Details");
+        pugi::xml_node task = message.body.child("Task");
+        OutputRecord record;
+        record.orderId = message.body.attribute("Id").value();
+        std::string status = task ? task.attribute("Status").value() : details.attribute("Status").value();
+        record.status = ParseOutputStatus(status);
+
+        pugi::xml_node criteria = message.body.child("Criteria");
+        if (criteria)
+        {
+            record.articleId = criteria.attribute("ArticleId").value();
+            record.quantityRequested = criteria.attribute("Quantity").as_int(1);
+        }
+        for (pugi::xml_node article : message.body.children("Article"))
+        {
+            record.articleId = article.attribute("Id").value();
+            int packs = 0;
+            for (pugi::xml_node pack : article.children("Pack"))
+            {
+                (void)pack;
+                packs++;
+            }
+            record.packsDelivered = packs;
+
+            // A completed output takes its packs out of the article list
+            int index = _articles.FindArticleIndexIgnoreCase(record.articleId);
+            if (record.status == OutputStatus::Completed && index >= 0)
+            {
+                const Article& a = _articles.Items()[static_cast<size_t>(index)];
+                _articles.SetQuantity(static_cast<size_t>(index), a.second > packs ? a.second - packs : 0);
+            }
+        }
+
+        if (record.status == OutputStatus::Completed || record.status == OutputStatus::Rejected ||
+            record.status == OutputStatus::Incomplete)
+            _orders.RemoveOrder(record.orderId);
+        else
+            _orders.SetOrder(record);
+    }
+
+    ArticleStore _articles;
+    OrderTable _orders;
+};
+
+static int run_replay(const std::string& path, const TrafficReplay::Options& options, bool parseOnly)
+{
+    TrafficReplay replay;
+    std::string error;
+    if (!replay.Load(path, error))
+    {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    std::printf("%s: %zu inbound messages over %.3f s, speed %g, %zu pass(es)%s\n", path.c_str(), replay.Size(),
+                std::chrono::duration<double>(replay.Duration()).count(), options.speed, options.repeat,
+                parseOnly ? ", parse only" : "");
+    if (replay.Gaps() > 0)
+        std::printf("warning: %zu gaps where frames were dropped while capturing\n", replay.Gaps());
+    std::fflush(stdout);
+
+    ReplayState state;
+    TrafficReplay::Handler handler;
+    if (!parseOnly) handler = [&state](const WwksMessage& message) { state.Apply(message); };
+
+    g_running = &replay;
+    TrafficReplay::Result r = replay.Run(options, handler);
+    g_running = nullptr;
+
+    std::printf("messages=%llu bytes=%llu keepAlivesSkipped=%llu invalid=%llu%s\n", (unsigned long long)r.messages,
+                (unsigned long long)r.bytes, (unsigned long long)r.keepAlives, (unsigned long long)r.invalid,
+                r.stopped ? " (stopped)" : "");
+    std::printf("elapsed=%.3f s busy=%.3f s msgs/s=%.0f MB/s=%.1f maxLag=%.3f ms\n",
+                std::chrono::duration<double>(r.elapsed).count(), std::chrono::duration<double>(r.busy).count(),
+                r.MessagesPerSecond(), std::chrono::duration<double>(r.elapsed).count() > 0
+                    ? r.bytes / 1e6 / std::chrono::duration<double>(r.elapsed).count() : 0.0,
+                std::chrono::duration<double, std::milli>(r.maxLag).count());
+    std::printf("per message (us): p50=%lld p99=%lld p999=%lld max=%lld\n", us(r.perMessage.p50), us(r.perMessage.p99),
+                us(r.perMessage.p999), us(r.perMessage.max));
+    if (!parseOnly)
+        std::printf("state: articles=%zu activeOrders=%zu\n", state.Articles(), state.Orders());
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        print_usage();
+        return argc == 2 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h") ? 0 : 2;
+    }
+
+    std::string command = argv[1];
+    std::string path = argv[2];
+
+    if (command == "import")
+    {
+        if (argc != 4)
+        {
+            print_usage();
+            return 2;
+        }
+        return run_import(path, argv[3]);
+    }
+
+    TrafficReplay::Options options;
+    uint64_t max = 0;
+    bool parseOnly = false;
+    for (int i = 3; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc)
+            {
+                std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--speed") options.speed = std::strtod(value(), nullptr);
+        else if (arg == "--repeat") options.repeat = static_cast<size_t>(std::strtoul(value(), nullptr, 10));
+        else if (arg == "--max") max = std::strtoull(value(), nullptr, 10);
+        else if (arg == "--parse-only") parseOnly = true;
+        else
+        {
+            print_usage();
+            return 2;
+        }
+    }
+
+    if (command == "info") return run_info(path);
+    if (command == "dump") return run_dump(path, max);
+    if (command == "replay")
+    {
+        std::signal(SIGINT, on_signal);
+        std::signal(SIGTERM, on_signal);
+        return run_replay(path, options, parseOnly);
+    }
+
+    print_usage();
+    return 2;
+}
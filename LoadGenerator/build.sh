@@ -0,0 +1,23 @@
+#!/bin/sh
+# Build the load generator on Linux (g++ or clang++ with C++20).
+# Usage: ./build.sh [output]      (default: ./loadgen)
+# Links NetworkClient and the RobotSimulator it runs against; none of them depend on Windows.
+
+set -e
+cd "$(dirname "$0")"
+
+SRC=../RowaPickupSlim
+SIM=../RobotSimulator
+CXX="${CXX:-g++}"
+OUT="${1:-loadgen}"
+
+"$CXX" -std=c++20 -O2 -Wall -Wextra -pthread -I"$SRC" -I"$SIM" \
+    main.cpp "$SIM/RobotSimulator.cpp" \
+    "$SRC/networkclient_fixed.cpp" "$SRC/Reactor.cpp" "$SRC/SendQueue.cpp" "$SRC/Handshake.cpp" \
+    "$SRC/RequestTracker.cpp" "$SRC/ReconnectPolicy.cpp" "$SRC/TcpConnector.cpp" "$SRC/LivenessMonitor.cpp" \
+    "$SRC/KeepAliveReply.cpp" "$SRC/WwksMessageBuilder.cpp" "$SRC/IsoTimestamp.cpp" "$SRC/LatencyHistogram.cpp" "$SRC/MessageDispatcher.cpp" "$SRC/TcpTransport.cpp" \
+    "$SRC/LoopbackTransport.cpp" "$SRC/TrafficCapture.cpp" "$SRC/WwksFrameSplitter.cpp" "$SRC/WwksClassifier.cpp" "$SRC/WwksMessage.cpp" "$SRC/ParseArena.cpp" \
+    "$SRC/pugixml.cpp" \
+    -o "$OUT"
+
+echo "Built $OUT"
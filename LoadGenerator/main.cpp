@@ -0,0 +1,445 @@
+// main.cpp
+// Headless load generator (Linux): N NetworkClients in one process, each a pickup terminal with
+// its own SourceNumber, scanning articles and sending OutputRequests at a configurable rate.
+// Runs against an embedded RobotSimulator (default) or an external server, and reports
+// throughput, request -> OutputResponse / request -> Completed latency and reconnects.
+//
+// Build: ./build.sh    Run: ./loadgen --clients 30 --rate 0.5 --duration 60 --outage-at 20
+
+#include "networkclient.h"
+#include "RobotSimulator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace RowaPickupSlim;
+using Clock = std::chrono::steady_clock;
+
+static volatile std::sig_atomic_t g_stop = 0;
+
+static void on_signal(int)
+{
+    g_stop = 1;
+}
+
+struct LoadOptions
+{
+    int clients = 30;
+    int firstSource = 101;              // SourceNumber of the first terminal
+    double rate = 0.5;                  // Scans per second per terminal (exponential gaps)
+    int burst = 3;                      // Articles per scan: 1..burst, sent back to back
+    int maxQuantity = 2;                // Packs per OutputRequest: 1..maxQuantity
+    int duration = 30;                  // Seconds of scanning
+    int drain = 5;                      // Seconds to wait for outstanding outputs afterwards
+    int reportSeconds = 5;
+    std::string host = "127.0.0.1";
+    int port = 16050;
+    bool embedded = true;               // Run the RobotSimulator in this process
+    int outageAt = 0;                   // Embedded: drop all connections and refuse new ones at this second (0 = never)
+    int outageSeconds = 3;
+    uint32_t seed = 1;
+    bool verbose = false;               // Client log lines
+};
+
+// Shared results of all terminals
+struct Results
+{
+    std::atomic<uint64_t> scans{ 0 };
+    std::atomic<uint64_t> sent{ 0 };
+    std::atomic<uint64_t> skipped{ 0 };         // Scans while the terminal was not connected
+    std::atomic<uint64_t> responses{ 0 };       // OutputResponse Queued
+    std::atomic<uint64_t> rejected{ 0 };
+    std::atomic<uint64_t> completed{ 0 };       // Completed or Incomplete
+    std::atomic<uint64_t> failed{ 0 };          // No OutputResponse: timed out, disconnected, not sent
+    std::atomic<uint64_t> disconnects{ 0 };
+    std::atomic<uint64_t> connects{ 0 };
+    LatencyHistogram responseLatency;           // OutputRequest -> OutputResponse
+    LatencyHistogram completedLatency;          // OutputRequest -> OutputMessage Completed
+    LatencyHistogram reconnectLatency;          // Connection lost -> connected again
+};
+
+// One pickup terminal
+struct Terminal
+{
+    int source = 0;
+    std::unique_ptr<NetworkClient> client;
+    std::mutex mtx;
+    std::unordered_map<std::string, Clock::time_point> outstanding;    // Order Id -> sent
+    Clock::time_point lostAt{};                                         // Guarded by mtx
+    bool wasConnected = false;                                          // Guarded by mtx
+    uint64_t nextOrder = 1;                                             // Driver thread only
+};
+
+static void print_usage()
+{
+    std::printf(
+        "usage: loadgen [options]\n"
+        "  --clients N         terminals (30)\n"
+        "  --first-source N    SourceNumber of the first terminal (101)\n"
+        "  --rate R            scans per second per terminal (0.5)\n"
+        "  --burst N           articles per scan, 1..N (3)\n"
+        "  --max-quantity N    packs per OutputRequest, 1..N (2)\n"
+        "  --duration S        seconds of scanning (30)\n"
+        "  --drain S           seconds to wait for outstanding outputs (5)\n"
+        "  --report-s S        progress report interval (5)\n"
+        "  --server HOST:PORT  use an external server instead of the embedded simulator\n"
+        "  --port N            port of the embedded simulator (16050)\n"
+        "  --outage-at S       embedded: drop all connections at second S (off)\n"
+        "  --outage-s S        embedded: refuse connections for S seconds (3)\n"
+        "  --articles N --response-ms N --inprocess-ms N --completed-ms N --keepalive-ms N\n"
+        "                      embedded simulator options (see robotsim --help)\n"
+        "  --seed N            scan pattern / stock (1)\n"
+        "  --verbose           print client log lines\n");
+}
+
+static long long us(LatencyHistogram::Duration d)
+{
+    return static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+}
+
+static void print_latency(const char* name, const LatencyHistogram& histogram)
+{
+    LatencyHistogram::Summary s = histogram.GetSummary();
+    std::printf("  %-22s count=%-8llu p50=%-9lld p99=%-9lld p999=%-9lld max=%lld us\n", name, (unsigned long long)s.count,
+                us(s.p50), us(s.p99), us(s.p999), us(s.max));
+}
+
+static void print_report(const char* title, Results& r, double seconds, const std::vector<std::unique_ptr<Terminal>>& terminals)
+{
+    size_t connected = 0;
+    for (const auto& t : terminals)
+    {
+        if (t->client->IsHandshakeComplete() && t->client->IsConnected()) connected++;
+    }
+
+    std::printf("%s after %.1f s: %zu/%zu connected\n", title, seconds, connected, terminals.size());
+    std::printf("  scans=%llu sent=%llu skipped=%llu responses=%llu rejected=%llu completed=%llu failed=%llu (%.1f completed/s)\n",
+                (unsigned long long)r.scans.load(), (unsigned long long)r.sent.load(), (unsigned long long)r.skipped.load(),
+                (unsigned long long)r.responses.load(), (unsigned long long)r.rejected.load(), (unsigned long long)r.completed.load(),
+                (unsigned long long)r.failed.load(), seconds > 0 ? r.completed.load() / seconds : 0.0);
+    print_latency("request -> response", r.responseLatency);
+    print_latency("request -> completed", r.completedLatency);
+    std::fflush(stdout);
+}
+
+int main(int argc, char* argv[])
+{
+    LoadOptions options;
+    RobotSimulator::Options simOptions;
+    simOptions.inProcessDelay = std::chrono::milliseconds(100);
+    simOptions.completedDelay = std::chrono::milliseconds(400);
+    simOptions.logRequests = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        auto text = [&]() -> std::string {
+            if (i + 1 >= argc)
+            {
+                std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        auto value = [&]() -> long { return std::strtol(text().c_str(), nullptr, 10); };
+
+        if (arg == "--clients") options.clients = static_cast<int>(value());
+        else if (arg == "--first-source") options.firstSource = static_cast<int>(value());
+        else if (arg == "--rate") options.rate = std::strtod(text().c_str(), nullptr);
+        else if (arg == "--burst") options.burst = std::max(1, static_cast<int>(value()));
+        else if (arg == "--max-quantity") options.maxQuantity = std::max(1, static_cast<int>(value()));
+        else if (arg == "--duration") options.duration = static_cast<int>(value());
+        else if (arg == "--drain") options.drain = static_cast<int>(value());
+        else if (arg == "--report-s") options.reportSeconds = static_cast<int>(value());
+        else if (arg == "--port") options.port = static_cast<int>(value());
+        else if (arg == "--outage-at") options.outageAt = static_cast<int>(value());
+        else if (arg == "--outage-s") options.outageSeconds = static_cast<int>(value());
+        else if (arg == "--seed") options.seed = simOptions.seed = static_cast<uint32_t>(value());
+        else if (arg == "--verbose") options.verbose = true;
+        else if (arg == "--articles") simOptions.articles = static_cast<size_t>(value());
+        else if (arg == "--response-ms") simOptions.responseDelay = std::chrono::milliseconds(value());
+        else if (arg == "--inprocess-ms") simOptions.inProcessDelay = std::chrono::milliseconds(value());
+        else if (arg == "--completed-ms") simOptions.completedDelay = std::chrono::milliseconds(value());
+        else if (arg == "--keepalive-ms") simOptions.keepAliveInterval = std::chrono::milliseconds(value());
+        else if (arg == "--server")
+        {
+            std::string server = text();
+            size_t colon = server.rfind(':');
+            if (colon == std::string::npos)
+            {
+                std::fprintf(stderr, "--server expects HOST:PORT\n");
+                return 2;
+            }
+            options.host = server.substr(0, colon);
+            options.port = std::atoi(server.c_str() + colon + 1);
+            options.embedded = false;
+        }
+        else
+        {
+            print_usage();
+            return arg == "--help" || arg == "-h" ? 0 : 2;
+        }
+    }
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::mutex outputMtx;
+    auto log = [&outputMtx](const std::string& message) {
+        std::lock_guard<std::mutex> lk(outputMtx);
+        std::printf("%s\n", message.c_str());
+    };
+
+    std::unique_ptr<RobotSimulator> simulator;
+    if (options.embedded)
+    {
+        simulator = std::make_unique<RobotSimulator>(simOptions);
+        int error = 0;
+        if (!simulator->Listen(options.port, error))
+        {
+            std::fprintf(stderr, "cannot listen on port %d: %s\n", options.port, std::strerror(error));
+            return 1;
+        }
+    }
+
+    std::printf("%d terminals, %.2f scans/s each (1-%d articles per scan), %d s against %s:%d%s\n", options.clients, options.rate,
+                options.burst, options.duration, options.host.c_str(), options.port, options.embedded ? " (embedded simulator)" : "");
+    std::fflush(stdout);
+
+    Results results;
+    std::vector<std::unique_ptr<Terminal>> terminals;
+    for (int i = 0; i < options.clients; i++)
+    {
+        auto terminal = std::make_unique<Terminal>();
+        Terminal* t = terminal.get();
+        t->source = options.firstSource + i;
+        t->client = std::make_unique<NetworkClient>();
+
+        int source = t->source;
+        t->client->Identity = [source]() {
+            ClientIdentity identity;
+            identity.sourceNumber = source;
+            identity.stockLocation = "LoadTest";
+            return identity;
+        };
+        if (options.verbose)
+        {
+            t->client->LogMessage = [&log, source](const std::string& message) {
+                if (message.find(">>> OUTGOING") == std::string::npos && message.find("<<< INCOMING") == std::string::npos)
+                    log("[" + std::to_string(source) + "] " + message);
+            };
+        }
+
+        t->client->ConnectionStateChanged = [t, &results](ConnectionState state, ConnectionError, const std::string&) {
+            std::lock_guard<std::mutex> lk(t->mtx);
+            if (state == ConnectionState::Connected)
+            {
+                results.connects++;
+                if (t->wasConnected && t->lostAt != Clock::time_point())
+                    results.reconnectLatency.Record(Clock::now() - t->lostAt);
+                t->wasConnected = true;
+                t->lostAt = Clock::time_point();
+            }
+            else if (state == ConnectionState::NotConnected && t->wasConnected && t->lostAt == Clock::time_point())
+            {
+                results.disconnects++;
+                t->lostAt = Clock::now();
+            }
+        };
+
+        t->client->MessageReceived = [t, &results](const WwksMessage& message) {
+            if (!message.body) return;
+
+            std::string status = message.body.child("Details").attribute("Status").value();
+            bool rejected = message.type == WwksMessageType::OutputResponse && status == "Rejected";
+            bool completed = message.type == WwksMessageType::OutputMessage && (status == "Completed" || status == "Incomplete");
+            if (!rejected && !completed) return;
+
+            std::lock_guard<std::mutex> lk(t->mtx);
+            auto order = t->outstanding.find(message.body.attribute("Id").value());
+            if (order == t->outstanding.end()) return;
+            if (rejected)
+            {
+                results.rejected++;
+                t->outstanding.erase(order);
+                return;
+            }
+            results.completed++;
+            results.completedLatency.Record(Clock::now() - order->second);
+            t->outstanding.erase(order);
+        };
+
+        t->client->StartConnectionPolling(options.host, options.port);
+        terminals.push_back(std::move(terminal));
+    }
+
+    // Scan schedule: one driver thread, terminals ordered by their next scan
+    std::mt19937 random(options.seed);
+    std::exponential_distribution<double> gap(options.rate > 0 ? options.rate : 1.0);
+    std::uniform_int_distribution<int> articlesPerScan(1, options.burst);
+    std::uniform_int_distribution<int> quantity(1, options.maxQuantity);
+    std::uniform_int_distribution<size_t> article(1, std::max<size_t>(1, simOptions.articles));
+
+    using Due = std::pair<Clock::time_point, size_t>;
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> schedule;
+    Clock::time_point start = Clock::now();
+    auto after = [&](double seconds) { return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)); };
+    for (size_t i = 0; i < terminals.size(); i++)
+        schedule.push({ start + after(gap(random)), i });
+
+    Clock::time_point end = start + std::chrono::seconds(options.duration);
+    Clock::time_point nextReport = start + std::chrono::seconds(options.reportSeconds);
+    Clock::time_point outageStart = options.outageAt > 0 ? start + std::chrono::seconds(options.outageAt) : Clock::time_point::max();
+    Clock::time_point outageEnd = Clock::time_point::max();
+
+    while (!g_stop && options.rate > 0)
+    {
+        Clock::time_point now = Clock::now();
+        if (now >= end) break;
+
+        if (simulator && now >= outageStart)
+        {
+            log("--- outage: dropping all connections for " + std::to_string(options.outageSeconds) + " s ---");
+            simulator->StopListening();
+            simulator->DisconnectAll();
+            outageStart = Clock::time_point::max();
+            outageEnd = now + std::chrono::seconds(options.outageSeconds);
+        }
+        if (simulator && now >= outageEnd)
+        {
+            int error = 0;
+            if (!simulator->Listen(options.port, error))
+                log("--- cannot listen again: " + std::string(std::strerror(error)) + " ---");
+            else
+                log("--- outage over ---");
+            outageEnd = Clock::time_point::max();
+        }
+
+        if (options.reportSeconds > 0 && now >= nextReport)
+        {
+            std::lock_guard<std::mutex> lk(outputMtx);
+            print_report("progress", results, std::chrono::duration<double>(now - start).count(), terminals);
+            nextReport += std::chrono::seconds(options.reportSeconds);
+        }
+
+        Due due = schedule.top();
+        if (due.first > now)
+        {
+            std::this_thread::sleep_until(std::min({ due.first, now + std::chrono::milliseconds(50) }));
+            continue;
+        }
+        schedule.pop();
+        schedule.push({ due.first + after(gap(random)), due.second });
+
+        // One scan: a prescription with a few articles, each an OutputRequest
+        Terminal& t = *terminals[due.second];
+        results.scans++;
+        if (!t.client->IsConnected() || !t.client->IsHandshakeComplete())
+        {
+            results.skipped++;
+            continue;
+        }
+
+        int count = articlesPerScan(random);
+        for (int a = 0; a < count; a++)
+        {
+            std::string id = std::to_string(t.source) + std::to_string(1000000 + t.nextOrder++).substr(1);
+            char articleId[32];
+            std::snprintf(articleId, sizeof(articleId), "RoWa-%06zu", article(random));
+            std::string request = "<WWKS Version=\"2.0\" TimeStamp=\"2026-01-01T00:00:00Z\"><OutputRequest Id=\"" + id +
+                                  "\" Source=\"" + std::to_string(t.source) + "\" Destination=\"999\"><Details OutputDestination=\"1\" "
+                                  "Priority=\"Normal\" /><Criteria ArticleId=\"" + articleId + "\" Quantity=\"" +
+                                  std::to_string(quantity(random)) + "\" /></OutputRequest></WWKS>";
+
+            Clock::time_point sent = Clock::now();
+            {
+                std::lock_guard<std::mutex> lk(t.mtx);
+                t.outstanding[id] = sent;
+            }
+            results.sent++;
+
+            Terminal* terminal = &t;
+            t.client->SendRequest(request, WwksMessageType::OutputRequest, id, [terminal, id, &results](const RequestTracker::Result& r) {
+                if (r.outcome == RequestOutcome::Answered)
+                {
+                    results.responses++;
+                    results.responseLatency.Record(r.latency);
+                    return;
+                }
+                results.failed++;
+                std::lock_guard<std::mutex> lk(terminal->mtx);
+                terminal->outstanding.erase(id);
+            });
+        }
+    }
+
+    // Outstanding outputs may still complete
+    Clock::time_point drainEnd = Clock::now() + std::chrono::seconds(options.drain);
+    while (!g_stop && Clock::now() < drainEnd)
+    {
+        size_t outstanding = 0;
+        for (const auto& t : terminals)
+        {
+            std::lock_guard<std::mutex> lk(t->mtx);
+            outstanding += t->outstanding.size();
+        }
+        if (outstanding == 0) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    size_t lost = 0;
+    ReconnectPolicy::Metrics worst;
+    uint64_t attempts = 0;
+    for (const auto& t : terminals)
+    {
+        {
+            std::lock_guard<std::mutex> lk(t->mtx);
+            lost += t->outstanding.size();
+        }
+        ReconnectPolicy::Metrics m = t->client->GetReconnectMetrics();
+        attempts += m.totalAttempts;
+        if (m.longestOutage > worst.longestOutage) worst = m;
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(outputMtx);
+        print_report("result", results, seconds, terminals);
+        std::printf("  outstanding at end=%zu (never completed)\n", lost);
+        std::printf("  connections: connects=%llu disconnects=%llu reconnects=%llu connect attempts=%llu longest outage=%lld ms\n",
+                    (unsigned long long)results.connects.load(), (unsigned long long)results.disconnects.load(),
+                    (unsigned long long)results.reconnectLatency.GetSummary().count, (unsigned long long)attempts,
+                    (long long)std::chrono::duration_cast<std::chrono::milliseconds>(worst.longestOutage).count());
+        print_latency("lost -> reconnected", results.reconnectLatency);
+
+        for (WwksMessageType type : { WwksMessageType::HelloRequest, WwksMessageType::StatusRequest,
+                                      WwksMessageType::StockInfoRequest, WwksMessageType::OutputRequest })
+        {
+            if (!simulator) break;
+            LatencyHistogram::Summary s = simulator->GetServiceTime(type);
+            if (s.count == 0) continue;
+            std::printf("  server %-15s count=%-8llu p50=%-9lld p99=%-9lld max=%lld us\n", ToString(type),
+                        (unsigned long long)s.count, us(s.p50), us(s.p99), us(s.max));
+        }
+        std::fflush(stdout);
+    }
+
+    for (auto& t : terminals)
+        t->client->Close();
+    terminals.clear();
+    if (simulator) simulator->Stop();
+    return 0;
+}
@@ -0,0 +1,574 @@
+// RobotSimulator.cpp
+// WWKS storage system simulator implementation
+
+#include "RobotSimulator.h"
+#include "SendQueue.h"
+#include "TcpTransport.h"
+#include "WwksFrameSplitter.h"
+#include "WwksMessage.h"
+#include <algorithm>
+#include <ctime>
+#include <random>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace RowaPickupSlim
+{
+    using Clock = Reactor::Clock;
+
+    static std::string UtcTimestamp()
+    {
+        std::time_t t = std::time(nullptr);
+        std::tm tm{};
+#ifdef _WIN32
+        gmtime_s(&tm, &t);
+#else
+        gmtime_r(&t, &tm);
+#endif
+        char buf[32];
+        strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        return buf;
+    }
+
+    // Attribute values echoed back from the client
+    static std::string Escape(std::string_view value)
+    {
+        std::string out;
+        out.reserve(value.size());
+        for (char c : value)
+        {
+            switch (c)
+            {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            default: out.push_back(c); break;
+            }
+        }
+        return out;
+    }
+
+    static std::string Attribute(pugi::xml_node node, const char* name)
+    {
+        return node.attribute(name).value();
+    }
+
+    static std::string Micros(LatencyHistogram::Duration d)
+    {
+        return std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+    }
+
+    // One connected client: reactor thread for receiving and timers, SendQueue writer for sending
+    class RobotSimulator::Session
+    {
+    public:
+        Session(RobotSimulator& simulator, std::unique_ptr<Transport> transport)
+            : _sim(simulator), _transport(std::move(transport))
+        {
+            _thread = std::thread(&Session::Run, this);
+        }
+
+        ~Session()
+        {
+            Stop();
+            if (_thread.joinable())
+                _thread.join();
+        }
+
+        void Stop() { _reactor.Stop(); }
+
+        bool IsFinished() const { return _finished.load(); }
+
+    private:
+        struct Order
+        {
+            std::string status;         // Queued, InProcess, Completed, Incomplete, Rejected
+            std::string destination;
+            std::vector<std::pair<std::string, int>> criteria;     // Article, packs requested
+        };
+
+        void Run()
+        {
+            std::string peer = _transport->Describe();
+            _sim.Log("[SIM] Client connected: " + peer);
+
+            _sendQueue.Start(*_transport);
+
+            Transport::Receiver receiver;
+            receiver.Prepare = [this](size_t size) { return _splitter.PrepareWrite(size); };
+            receiver.Commit = [this](size_t bytes) {
+                Clock::time_point received = Clock::now();
+                _splitter.Commit(bytes);
+                std::string_view frame;
+                while (_splitter.NextFrame(frame))
+                    OnFrame(frame, received);
+            };
+            receiver.Closed = [this](int error) {
+                _sim.Log(error == 0 ? "[SIM] Client closed the connection" : "[SIM] Connection error " + std::to_string(error));
+                _reactor.Stop();
+            };
+
+            if (_transport->Start(_reactor, std::move(receiver)))
+            {
+                if (_sim._options.keepAliveInterval.count() > 0)
+                    _reactor.AddTimer(_sim._options.keepAliveInterval, [this]() { SendKeepAlive(); });
+                _reactor.Run();
+            }
+            _transport->Stop();
+            _transport->Shutdown();
+            _sendQueue.Stop();
+
+            SendQueue::Counters sc = _sendQueue.GetCounters();
+            _sim.Log("[SIM] Client disconnected: " + peer + " (" + std::to_string(_served) + " requests, " +
+                     std::to_string(sc.messagesSent) + " messages sent)");
+            _sim.Count(&Counters::activeSessions, -1);
+            _finished.store(true);
+        }
+
+        void OnFrame(std::string_view frame, Clock::time_point received)
+        {
+            std::string_view bodyTag;
+            WwksMessageType type = ClassifyWwksFrame(frame, &bodyTag);
+
+            std::string_view value;
+            std::string id = FindTagAttribute(bodyTag, "Id", value) ? std::string(value) : std::string();
+            if (FindTagAttribute(bodyTag, "Source", value) && !value.empty())
+                _client.assign(value);
+
+            switch (type)
+            {
+            case WwksMessageType::HelloRequest:
+            {
+                const WwksMessage& message = Parse(frame, type);
+                pugi::xml_node subscriber = message.body.child("Subscriber");
+                if (subscriber.attribute("Id"))
+                    _client = Attribute(subscriber, "Id");
+                Reply(type, id, received,
+                      "<HelloResponse Id=\"" + Escape(id) + "\"><Subscriber Id=\"" + std::to_string(_sim._options.sourceNumber) +
+                      "\" Type=\"StorageSystem\" Manufacturer=\"RowaPickupSlim\" ProductInfo=\"RobotSimulator\" VersionInfo=\"1.0\">"
+                      "<Capability Name=\"KeepAlive\" /><Capability Name=\"Status\" /><Capability Name=\"StockInfo\" />"
+                      "<Capability Name=\"Output\" /><Capability Name=\"TaskInfo\" /></Subscriber></HelloResponse>");
+                break;
+            }
+            case WwksMessageType::StatusRequest:
+                Reply(type, id, received,
+                      "<StatusResponse Id=\"" + Escape(id) + "\"" + Route() + " State=\"Ready\">"
+                      "<Component Type=\"StorageSystem\" Description=\"Simulator " + std::to_string(_sim._options.sourceNumber) +
+                      "\" State=\"Ready\" StateText=\"Ready\" /></StatusResponse>");
+                break;
+            case WwksMessageType::StockInfoRequest:
+                Reply(type, id, received,
+                      "<StockInfoResponse Id=\"" + Escape(id) + "\"" + Route() + ">" + _sim.StockXml() + "</StockInfoResponse>");
+                break;
+            case WwksMessageType::OutputRequest:
+                OnOutputRequest(Parse(frame, type), id, received);
+                break;
+            case WwksMessageType::TaskInfoRequest:
+                OnTaskInfoRequest(Parse(frame, type), id, received);
+                break;
+            case WwksMessageType::KeepAliveRequest:
+                Reply(type, id, received, "<KeepAliveResponse Id=\"" + Escape(id) + "\"" + Route() + " />");
+                break;
+            case WwksMessageType::KeepAliveResponse:
+            {
+                auto sent = _keepAlives.find(id);
+                if (sent != _keepAlives.end())
+                {
+                    _sim.RecordServiceTime(type, received - sent->second);
+                    _keepAlives.erase(sent);
+                }
+                break;
+            }
+            default:
+                _sim.Count(&Counters::unknownFrames);
+                _sim.Log(std::string("[SIM] Ignored ") + (type == WwksMessageType::Unknown ? "unknown frame" : ToString(type)));
+                break;
+            }
+        }
+
+        // Frames are parsed in place, so the reused copy is parsed rather than the splitter's buffer
+        const WwksMessage& Parse(std::string_view frame, WwksMessageType type)
+        {
+            _frameCopy.assign(frame);
+            return _parser.Parse(_frameCopy, type);
+        }
+
+        void OnOutputRequest(const WwksMessage& message, const std::string& id, Clock::time_point received)
+        {
+            Order order;
+            order.destination = Attribute(message.body.child("Details"), "OutputDestination");
+            bool known = true;
+            for (pugi::xml_node criteria : message.body.children("Criteria"))
+            {
+                std::string article = Attribute(criteria, "ArticleId");
+                known = known && _sim.GetQuantity(article) >= 0;
+                order.criteria.emplace_back(article, std::max(1, criteria.attribute("Quantity").as_int(1)));
+            }
+
+            std::string criteriaXml;
+            for (const auto& [article, quantity] : order.criteria)
+                criteriaXml += "<Criteria ArticleId=\"" + Escape(article) + "\" Quantity=\"" + std::to_string(quantity) + "\" />";
+
+            if (!known || order.criteria.empty())
+            {
+                order.status = "Rejected";
+                _orders[id] = order;
+                _sim.Count(&Counters::outputsRejected);
+                Reply(WwksMessageType::OutputRequest, id, received,
+                      "<OutputResponse Id=\"" + Escape(id) + "\"" + Route() + "><Details OutputDestination=\"" + Escape(order.destination) +
+                      "\" Status=\"Rejected\" />" + criteriaXml + "</OutputResponse>");
+                return;
+            }
+
+            order.status = "Queued";
+            _orders[id] = order;
+            std::string response = "<OutputResponse Id=\"" + Escape(id) + "\"" + Route() + "><Details OutputDestination=\"" +
+                                   Escape(order.destination) + "\" Status=\"Queued\" />" + criteriaXml + "</OutputResponse>";
+
+            auto queued = [this, id, received, response]() {
+                Reply(WwksMessageType::OutputRequest, id, received, response);
+                _reactor.AddTimer(_sim._options.inProcessDelay, [this, id]() {
+                    SetOutputStatus(id, "InProcess");
+                    _reactor.AddTimer(_sim._options.completedDelay, [this, id]() { CompleteOutput(id); });
+                });
+            };
+            if (_sim._options.responseDelay.count() > 0)
+                _reactor.AddTimer(_sim._options.responseDelay, queued);
+            else
+                queued();
+        }
+
+        void SetOutputStatus(const std::string& id, const char* status)
+        {
+            Order& order = _orders[id];
+            order.status = status;
+            Send("<OutputMessage Id=\"" + Escape(id) + "\"" + Route() + "><Details OutputDestination=\"" + Escape(order.destination) +
+                 "\" Status=\"" + status + "\" /></OutputMessage>");
+        }
+
+        void CompleteOutput(const std::string& id)
+        {
+            Order& order = _orders[id];
+            bool complete = true;
+            std::string articles;
+            for (const auto& [article, quantity] : order.criteria)
+            {
+                int delivered = _sim.TakePacks(article, quantity);
+                complete = complete && delivered == quantity;
+                articles += "<Article Id=\"" + Escape(article) + "\">";
+                for (int i = 0; i < delivered; i++)
+                {
+                    articles += "<Pack Id=\"" + std::to_string(_sim._nextPackId.fetch_add(1)) + "\" OutputDestination=\"" +
+                                Escape(order.destination) + "\" />";
+                }
+                articles += "</Article>";
+            }
+
+            order.status = complete ? "Completed" : "Incomplete";
+            _sim.Count(&Counters::outputsCompleted);
+            Send("<OutputMessage Id=\"" + Escape(id) + "\"" + Route() + "><Details OutputDestination=\"" + Escape(order.destination) +
+                 "\" Status=\"" + order.status + "\" />" + articles + "</OutputMessage>");
+        }
+
+        void OnTaskInfoRequest(const WwksMessage& message, const std::string& id, Clock::time_point received)
+        {
+            pugi::xml_node task = message.body.child("Task");
+            std::string taskId = Attribute(task, "Id");
+            std::string type = task.attribute("Type") ? Attribute(task, "Type") : "Output";
+
+            std::string status = "Unknown";
+            std::string articles;
+            auto order = _orders.find(taskId);
+            if (order != _orders.end())
+            {
+                status = order->second.status;
+                for (const auto& criteria : order->second.criteria)
+                    articles += "<Article Id=\"" + Escape(criteria.first) + "\" />";
+            }
+            Reply(WwksMessageType::TaskInfoRequest, id, received,
+                  "<TaskInfoResponse Id=\"" + Escape(id) + "\"" + Route() + "><Task Type=\"" + Escape(type) + "\" Id=\"" +
+                  Escape(taskId) + "\" Status=\"" + status + "\">" + articles + "</Task></TaskInfoResponse>");
+        }
+
+        void SendKeepAlive()
+        {
+            std::string id = std::to_string(_nextKeepAlive++);
+            _keepAlives[id] = Clock::now();
+            _sim.Count(&Counters::keepAlivesSent);
+            Send("<KeepAliveRequest Id=\"" + id + "\"" + Route() + " />");
+            _reactor.AddTimer(_sim._options.keepAliveInterval, [this]() { SendKeepAlive(); });
+        }
+
+        // Source / Destination attributes of our messages
+        std::string Route() const
+        {
+            return " Source=\"" + std::to_string(_sim._options.sourceNumber) + "\" Destination=\"" + Escape(_client) + "\"";
+        }
+
+        // Answer a request; its service time ends when the response was handed to the transport
+        void Reply(WwksMessageType requestType, const std::string& id, Clock::time_point received, const std::string& body)
+        {
+            _served++;
+            _sim.Count(&Counters::requests);
+            RobotSimulator& sim = _sim;
+            Send(body, [&sim, requestType, id, received](bool ok) {
+                if (!ok) return;
+                LatencyHistogram::Duration elapsed = Clock::now() - received;
+                sim.RecordServiceTime(requestType, elapsed);
+                if (sim._options.logRequests)
+                    sim.Log(std::string("[SIM] ") + ToString(requestType) + " Id=" + id + " served in " + Micros(elapsed) + " us");
+            });
+        }
+
+        void Send(const std::string& body, SendQueue::WrittenCallback written = nullptr)
+        {
+            _sendQueue.Enqueue("<WWKS Version=\"2.0\" TimeStamp=\"" + UtcTimestamp() + "\">" + body + "</WWKS>\n",
+                               SendQueue::Lane::Normal, std::move(written));
+        }
+
+        RobotSimulator& _sim;
+        std::unique_ptr<Transport> _transport;
+        Reactor _reactor;
+        SendQueue _sendQueue;
+        WwksFrameSplitter _splitter;
+        std::thread _thread;
+        std::atomic<bool> _finished{ false };
+
+        // Reactor thread only
+        std::string _client = "100";        // Destination of our messages, from the client's Source / Subscriber Id
+        std::unordered_map<std::string, Order> _orders;
+        std::unordered_map<std::string, Clock::time_point> _keepAlives;
+        uint64_t _nextKeepAlive = 1;
+        uint64_t _served = 0;
+        WwksMessageParser _parser;
+        std::string _frameCopy;
+    };
+
+    RobotSimulator::RobotSimulator()
+        : RobotSimulator(Options())
+    {
+    }
+
+    RobotSimulator::RobotSimulator(const Options& options)
+        : _options(options)
+    {
+        std::mt19937 random(options.seed);
+        std::uniform_int_distribution<int> quantity(1, std::max(1, options.maxQuantity));
+        _stock.reserve(options.articles);
+        for (size_t i = 0; i < options.articles; i++)
+        {
+            char id[32];
+            snprintf(id, sizeof(id), "RoWa-%06zu", i + 1);
+            Article article;
+            article.id = id;
+            article.name = "Synthetic article " + std::to_string(i + 1);
+            article.quantity = quantity(random);
+            _stockIndex.emplace(article.id, _stock.size());
+            _stock.push_back(std::move(article));
+        }
+    }
+
+    RobotSimulator::~RobotSimulator()
+    {
+        Stop();
+    }
+
+    void RobotSimulator::Serve(std::unique_ptr<Transport> transport)
+    {
+        if (!transport) return;
+        Count(&Counters::sessions);
+        Count(&Counters::activeSessions);
+
+        std::lock_guard<std::mutex> lk(_sessionsMtx);
+        ReapLocked();
+        _sessions.push_back(std::make_unique<Session>(*this, std::move(transport)));
+    }
+
+    void RobotSimulator::Stop()
+    {
+        StopListening();
+        DisconnectAll();
+    }
+
+    bool RobotSimulator::Listen(int port, int& error)
+    {
+        StopListening();
+        std::lock_guard<std::mutex> lk(_listenMtx);
+
+        // One dual-stack socket takes IPv4 clients as well
+        SocketHandle listener = ::socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+        if (listener == INVALID_SOCKET_HANDLE)
+        {
+            error = TcpTransport::LastError();
+            return false;
+        }
+        int off = 0, on = 1;
+        ::setsockopt(listener, IPPROTO_IPV6, IPV6_V6ONLY, reinterpret_cast<const char*>(&off), sizeof(off));
+        ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&on), sizeof(on));
+
+        sockaddr_in6 address{};
+        address.sin6_family = AF_INET6;
+        address.sin6_addr = in6addr_any;
+        address.sin6_port = htons(static_cast<uint16_t>(port));
+        auto reactor = std::make_unique<Reactor>();
+        if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listener, 64) != 0 ||
+            !reactor->IsValid() || !reactor->Add(listener, Reactor::Readable, [this](uint32_t) { Accept(); }))
+        {
+            error = TcpTransport::LastError();
+#ifdef _WIN32
+            closesocket(listener);
+#else
+            close(listener);
+#endif
+            return false;
+        }
+
+        _listener = listener;
+        _acceptReactor = std::move(reactor);
+        _acceptThread = std::thread([reactor = _acceptReactor.get()]() { reactor->Run(); });
+        return true;
+    }
+
+    void RobotSimulator::StopListening()
+    {
+        std::lock_guard<std::mutex> lk(_listenMtx);
+        if (!_acceptReactor) return;
+
+        _acceptReactor->Stop();
+        if (_acceptThread.joinable())
+            _acceptThread.join();
+        _acceptReactor->Remove(_listener);
+        _acceptReactor.reset();
+#ifdef _WIN32
+        closesocket(_listener);
+#else
+        close(_listener);
+#endif
+        _listener = INVALID_SOCKET_HANDLE;
+    }
+
+    // Runs on the accept thread when the listener is readable
+    void RobotSimulator::Accept()
+    {
+        sockaddr_storage peer{};
+        socklen_t peerLength = sizeof(peer);
+        SocketHandle client = ::accept(_listener, reinterpret_cast<sockaddr*>(&peer), &peerLength);
+        if (client == INVALID_SOCKET_HANDLE) return;
+
+        char host[INET6_ADDRSTRLEN] = "?";
+        uint16_t peerPort = 0;
+        if (peer.ss_family == AF_INET6)
+        {
+            const sockaddr_in6& a = reinterpret_cast<const sockaddr_in6&>(peer);
+            ::inet_ntop(AF_INET6, &a.sin6_addr, host, sizeof(host));
+            peerPort = ntohs(a.sin6_port);
+        }
+        else if (peer.ss_family == AF_INET)
+        {
+            const sockaddr_in& a = reinterpret_cast<const sockaddr_in&>(peer);
+            ::inet_ntop(AF_INET, &a.sin_addr, host, sizeof(host));
+            peerPort = ntohs(a.sin_port);
+        }
+        auto transport = std::make_unique<TcpTransport>(client, std::string(host) + ":" + std::to_string(peerPort));
+        int error = 0;
+        transport->SetNoDelay(true, error);     // Responses are written as they are ready
+        Serve(std::move(transport));
+    }
+
+    void RobotSimulator::DisconnectAll()
+    {
+        std::list<std::unique_ptr<Session>> sessions;
+        {
+            std::lock_guard<std::mutex> lk(_sessionsMtx);
+            sessions.swap(_sessions);
+        }
+        sessions.clear();       // Each session stops its reactor and joins its thread
+    }
+
+    // Join the threads of clients that disconnected (_sessionsMtx held)
+    void RobotSimulator::ReapLocked()
+    {
+        _sessions.remove_if([](const std::unique_ptr<Session>& session) { return session->IsFinished(); });
+    }
+
+    LatencyHistogram::Summary RobotSimulator::GetServiceTime(WwksMessageType requestType) const
+    {
+        size_t index = static_cast<size_t>(requestType);
+        return index < _serviceTimes.size() ? _serviceTimes[index].GetSummary() : LatencyHistogram::Summary();
+    }
+
+    RobotSimulator::Counters RobotSimulator::GetCounters() const
+    {
+        std::lock_guard<std::mutex> lk(_countersMtx);
+        return _counters;
+    }
+
+    int RobotSimulator::GetQuantity(const std::string& articleId) const
+    {
+        std::lock_guard<std::mutex> lk(_stockMtx);
+        auto it = _stockIndex.find(articleId);
+        return it == _stockIndex.end() ? -1 : _stock[it->second].quantity;
+    }
+
+    // Take up to quantity packs of an article out of stock, returns the packs taken
+    int RobotSimulator::TakePacks(const std::string& articleId, int quantity)
+    {
+        std::lock_guard<std::mutex> lk(_stockMtx);
+        auto it = _stockIndex.find(articleId);
+        if (it == _stockIndex.end()) return 0;
+
+        Article& article = _stock[it->second];
+        int taken = std::min(quantity, article.quantity);
+        article.quantity -= taken;
+        if (taken > 0) _stockXmlValid = false;
+        return taken;
+    }
+
+    // <Article .../> elements of the whole stock, formatted once per stock change
+    std::string RobotSimulator::StockXml()
+    {
+        std::lock_guard<std::mutex> lk(_stockMtx);
+        if (!_stockXmlValid)
+        {
+            _stockXml.clear();
+            for (const Article& article : _stock)
+            {
+                _stockXml += "<Article Id=\"" + article.id + "\" Name=\"" + article.name +
+                             "\" DosageForm=\"Tablet\" PackagingUnit=\"Box\" MaxSubItemQuantity=\"0\" Quantity=\"" +
+                             std::to_string(article.quantity) + "\" />";
+            }
+            _stockXmlValid = true;
+        }
+        return _stockXml;
+    }
+
+    void RobotSimulator::RecordServiceTime(WwksMessageType requestType, LatencyHistogram::Duration elapsed)
+    {
+        size_t index = static_cast<size_t>(requestType);
+        if (index < _serviceTimes.size())
+            _serviceTimes[index].Record(elapsed);
+    }
+
+    void RobotSimulator::Count(uint64_t Counters::* field, int64_t delta)
+    {
+        std::lock_guard<std::mutex> lk(_countersMtx);
+        _counters.*field += static_cast<uint64_t>(delta);
+    }
+
+    void RobotSimulator::Log(const std::string& message)
+    {
+        if (LogMessage)
+        {
+            try { LogMessage(message); } catch (...) {}
+        }
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+// RobotSimulator.h
+// Stand-in for the server side of WWKS 2.0: a storage system with a synthetic stock that
+// answers Hello / Status / StockInfo / Output / TaskInfo requests, runs outputs through
+// Queued -> InProcess -> Completed with configurable delays and sends KeepAliveRequests.
+// Each client is served over a Transport (TCP clients accepted by Listen(), or one end of a
+// LoopbackTransport pair in-process), so NetworkClient can be benchmarked end to end.
+// Service time (request received -> response written) is recorded per request type.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "LatencyHistogram.h"
+#include "Reactor.h"
+#include "Transport.h"
+#include "WwksClassifier.h"
+
+namespace RowaPickupSlim
+{
+    class RobotSimulator
+    {
+    public:
+        struct Options
+        {
+            int sourceNumber = 999;                             // Subscriber Id of the storage system
+            size_t articles = 1000;                             // Synthetic stock size
+            int maxQuantity = 50;                               // Packs per article: 1..maxQuantity
+            uint32_t seed = 1;                                  // Stock quantities
+            std::chrono::milliseconds responseDelay{ 0 };       // OutputRequest -> OutputResponse (Queued)
+            std::chrono::milliseconds inProcessDelay{ 200 };    // OutputResponse -> OutputMessage InProcess
+            std::chrono::milliseconds completedDelay{ 1000 };   // InProcess -> OutputMessage Completed
+            std::chrono::milliseconds keepAliveInterval{ 10000 }; // KeepAliveRequest to each client (0 = never)
+            bool logRequests = true;                            // One log line per request served
+        };
+
+        struct Counters
+        {
+            uint64_t sessions = 0;          // Clients served (total)
+            uint64_t activeSessions = 0;
+            uint64_t requests = 0;          // Requests answered
+            uint64_t outputsCompleted = 0;  // Completed or Incomplete
+            uint64_t outputsRejected = 0;   // Unknown article
+            uint64_t keepAlivesSent = 0;
+            uint64_t unknownFrames = 0;     // Frames that were not a request we serve
+        };
+
+        RobotSimulator();
+        explicit RobotSimulator(const Options& options);
+        ~RobotSimulator();
+
+        /// Serve one connected client on its own thread until it disconnects or Stop() is called
+        void Serve(std::unique_ptr<Transport> transport);
+
+        /// Accept TCP clients on port (all addresses, IPv4 and IPv6) on a thread of its own
+        /// @return false with error set if the port could not be opened
+        bool Listen(int port, int& error);
+
+        /// Stop accepting; connected clients stay connected
+        void StopListening();
+
+        /// Disconnect all clients and wait for their threads
+        void DisconnectAll();
+
+        /// StopListening() + DisconnectAll()
+        void Stop();
+
+        /// Request received -> response written, all clients (KeepAliveResponse: our request -> their response)
+        LatencyHistogram::Summary GetServiceTime(WwksMessageType requestType) const;
+
+        Counters GetCounters() const;
+
+        /// Packs in stock of an article (-1 if unknown)
+        int GetQuantity(const std::string& articleId) const;
+
+        /// Called from the client threads
+        std::function<void(const std::string&)> LogMessage;
+
+    private:
+        class Session;
+
+        struct Article
+        {
+            std::string id;
+            std::string name;
+            int quantity = 0;
+        };
+
+        int TakePacks(const std::string& articleId, int quantity);
+        std::string StockXml();
+        void Log(const std::string& message);
+        void RecordServiceTime(WwksMessageType requestType, LatencyHistogram::Duration elapsed);
+        void Count(uint64_t Counters::* field, int64_t delta = 1);
+        void ReapLocked();
+        void Accept();
+
+        Options _options;
+
+        // Shared by all clients; outputs take packs out of it
+        mutable std::mutex _stockMtx;
+        std::vector<Article> _stock;
+        std::unordered_map<std::string, size_t> _stockIndex;
+        std::string _stockXml;              // <Article .../> elements, rebuilt after a completed output
+        bool _stockXmlValid = false;
+
+        std::array<LatencyHistogram, static_cast<size_t>(WwksMessageType::KeepAliveResponse) + 1> _serviceTimes;
+
+        mutable std::mutex _countersMtx;
+        Counters _counters;
+
+        std::mutex _sessionsMtx;
+        std::list<std::unique_ptr<Session>> _sessions;
+        std::atomic<uint64_t> _nextPackId{ 1 };
+
+        // Listen(): accepting reactor and its thread
+        std::mutex _listenMtx;
+        std::unique_ptr<Reactor> _acceptReactor;
+        std::thread _acceptThread;
+        SocketHandle _listener = INVALID_SOCKET_HANDLE;
+
+        // non-copyable
+        RobotSimulator(const RobotSimulator&) = delete;
+        RobotSimulator& operator=(const RobotSimulator&) = delete;
+    };
+}
@@ -0,0 +1,19 @@
+#!/bin/sh
+# Build the WWKS robot simulator on Linux (g++ or clang++ with C++20).
+# Usage: ./build.sh [output]      (default: ./robotsim)
+# Shares the protocol modules of RowaPickupSlim; none of them depend on Windows.
+
+set -e
+cd "$(dirname "$0")"
+
+SRC=../RowaPickupSlim
+CXX="${CXX:-g++}"
+OUT="${1:-robotsim}"
+
+"$CXX" -std=c++20 -O2 -Wall -Wextra -pthread -I"$SRC" \
+    main.cpp RobotSimulator.cpp \
+    "$SRC/Reactor.cpp" "$SRC/SendQueue.cpp" "$SRC/TcpTransport.cpp" "$SRC/LatencyHistogram.cpp" \
+    "$SRC/WwksFrameSplitter.cpp" "$SRC/WwksClassifier.cpp" "$SRC/WwksMessage.cpp" "$SRC/ParseArena.cpp" "$SRC/pugixml.cpp" \
+    -o "$OUT"
+
+echo "Built $OUT"
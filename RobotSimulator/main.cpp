@@ -0,0 +1,149 @@
+// main.cpp
+// RobotSimulator command line tool (Linux): listens for WWKS clients and serves each with a
+// RobotSimulator session until interrupted, then prints the service times.
+//
+// Build: ./build.sh    Run: ./robotsim --port 6050 --articles 5000 --completed-ms 500
+
+#include "RobotSimulator.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace RowaPickupSlim;
+
+static volatile std::sig_atomic_t g_stop = 0;
+
+static void on_signal(int)
+{
+    g_stop = 1;
+}
+
+static void print_usage()
+{
+    std::printf(
+        "usage: robotsim [options]\n"
+        "  --port N            listen port (6050)\n"
+        "  --source N          subscriber id of the storage system (999)\n"
+        "  --articles N        synthetic stock size (1000)\n"
+        "  --max-quantity N    packs per article, 1..N (50)\n"
+        "  --seed N            stock quantities (1)\n"
+        "  --response-ms N     OutputRequest -> OutputResponse Queued (0)\n"
+        "  --inprocess-ms N    -> OutputMessage InProcess (200)\n"
+        "  --completed-ms N    -> OutputMessage Completed (1000)\n"
+        "  --keepalive-ms N    KeepAliveRequest interval, 0 = off (10000)\n"
+        "  --report-s N        print service times every N seconds, 0 = only at exit (0)\n"
+        "  --quiet             no log line per request\n");
+}
+
+static void print_service_times(const RobotSimulator& simulator)
+{
+    auto us = [](LatencyHistogram::Duration d) {
+        return static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+    };
+
+    RobotSimulator::Counters c = simulator.GetCounters();
+    std::printf("sessions=%llu active=%llu requests=%llu outputsCompleted=%llu outputsRejected=%llu keepAlivesSent=%llu unknown=%llu\n",
+                (unsigned long long)c.sessions, (unsigned long long)c.activeSessions, (unsigned long long)c.requests,
+                (unsigned long long)c.outputsCompleted, (unsigned long long)c.outputsRejected,
+                (unsigned long long)c.keepAlivesSent, (unsigned long long)c.unknownFrames);
+    std::printf("%-18s %10s %10s %10s %10s %10s\n", "service time (us)", "count", "p50", "p99", "p999", "max");
+
+    for (WwksMessageType type : { WwksMessageType::HelloRequest, WwksMessageType::StatusRequest, WwksMessageType::StockInfoRequest,
+                                  WwksMessageType::OutputRequest, WwksMessageType::TaskInfoRequest, WwksMessageType::KeepAliveRequest,
+                                  WwksMessageType::KeepAliveResponse })
+    {
+        LatencyHistogram::Summary s = simulator.GetServiceTime(type);
+        if (s.count == 0) continue;
+        std::printf("%-18s %10llu %10lld %10lld %10lld %10lld\n", ToString(type), (unsigned long long)s.count,
+                    us(s.p50), us(s.p99), us(s.p999), us(s.max));
+    }
+    std::fflush(stdout);
+}
+
+int main(int argc, char* argv[])
+{
+    RobotSimulator::Options options;
+    int port = 6050;
+    int reportSeconds = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> long {
+            if (i + 1 >= argc)
+            {
+                std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+                std::exit(2);
+            }
+            return std::strtol(argv[++i], nullptr, 10);
+        };
+
+        if (arg == "--port") port = static_cast<int>(value());
+        else if (arg == "--source") options.sourceNumber = static_cast<int>(value());
+        else if (arg == "--articles") options.articles = static_cast<size_t>(value());
+        else if (arg == "--max-quantity") options.maxQuantity = static_cast<int>(value());
+        else if (arg == "--seed") options.seed = static_cast<uint32_t>(value());
+        else if (arg == "--response-ms") options.responseDelay = std::chrono::milliseconds(value());
+        else if (arg == "--inprocess-ms") options.inProcessDelay = std::chrono::milliseconds(value());
+        else if (arg == "--completed-ms") options.completedDelay = std::chrono::milliseconds(value());
+        else if (arg == "--keepalive-ms") options.keepAliveInterval = std::chrono::milliseconds(value());
+        else if (arg == "--report-s") reportSeconds = static_cast<int>(value());
+        else if (arg == "--quiet") options.logRequests = false;
+        else
+        {
+            print_usage();
+            return arg == "--help" || arg == "-h" ? 0 : 2;
+        }
+    }
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    RobotSimulator simulator(options);
+    std::mutex outputMtx;
+    simulator.LogMessage = [&outputMtx](const std::string& message) {
+        auto now = std::chrono::system_clock::now();
+        std::time_t t = std::chrono::system_clock::to_time_t(now);
+        int ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000);
+        std::tm tm{};
+        localtime_r(&t, &tm);
+        std::lock_guard<std::mutex> lk(outputMtx);
+        std::printf("%02d:%02d:%02d.%03d %s\n", tm.tm_hour, tm.tm_min, tm.tm_sec, ms, message.c_str());
+        std::fflush(stdout);
+    };
+
+    int error = 0;
+    if (!simulator.Listen(port, error))
+    {
+        std::fprintf(stderr, "cannot listen on port %d: %s\n", port, std::strerror(error));
+        return 1;
+    }
+
+    std::printf("WWKS robot simulator on port %d: %zu articles, output %lld/%lld/%lld ms, KeepAlive every %lld ms\n",
+                port, options.articles, (long long)options.responseDelay.count(), (long long)options.inProcessDelay.count(),
+                (long long)options.completedDelay.count(), (long long)options.keepAliveInterval.count());
+    std::fflush(stdout);
+
+    auto nextReport = std::chrono::steady_clock::now() + std::chrono::seconds(reportSeconds);
+    while (!g_stop)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        if (reportSeconds > 0 && std::chrono::steady_clock::now() >= nextReport)
+        {
+            print_service_times(simulator);
+            nextReport += std::chrono::seconds(reportSeconds);
+        }
+    }
+
+    simulator.Stop();
+    print_service_times(simulator);
+    return 0;
+}
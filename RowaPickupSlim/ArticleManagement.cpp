@@ -12,6 +12,11 @@
 //   - ToCompleteArticleCode() - Convert to standard format
 //   - FindArticleByCompleteCode() - Find article by complete code
 //
+// Lookups and quantity updates go through ArticleStore (ArticleStore.h),
+// which keeps an open-addressing hash index from article ID to list index.
+// The filtered list is an ArticleView holding indices into that single store,
+// so a quantity update only has to be applied once ("both lists" are one list).
+//
 // This file remains in the project for reference/documentation purposes only.
 // Remove from .vcxproj.filters ClCompile section to prevent compilation.
 
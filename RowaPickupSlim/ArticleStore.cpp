@@ -0,0 +1,154 @@
+// ArticleStore.cpp
+// Hash-indexed article list implementation
+
+#include "ArticleStore.h"
+#include <algorithm>
+
+namespace RowaPickupSlim
+{
+    static inline char ToUpperAscii(char c)
+    {
+        return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+
+    static bool EqualsIgnoreCase(std::string_view a, std::string_view b)
+    {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (ToUpperAscii(a[i]) != ToUpperAscii(b[i])) return false;
+        }
+        return true;
+    }
+
+    uint32_t ArticleStore::HashIgnoreCase(std::string_view s)
+    {
+        // FNV-1a over the upper-cased bytes, so exact and case-insensitive lookups share one table
+        uint32_t hash = 2166136261u;
+        for (char c : s)
+        {
+            hash ^= static_cast<unsigned char>(ToUpperAscii(c));
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    void ArticleStore::Assign(std::vector<Article> articles)
+    {
+        _articles = std::move(articles);
+        Rebuild();
+    }
+
+    void ArticleStore::Clear()
+    {
+        _articles.clear();
+        _hashes.clear();
+        _table.clear();
+    }
+
+    void ArticleStore::Rebuild()
+    {
+        _hashes.resize(_articles.size());
+
+        // Keep the load factor at or below 0.5 so probe chains stay short
+        size_t capacity = 16;
+        while (capacity < _articles.size() * 2)
+            capacity *= 2;
+        _table.assign(capacity, -1);
+
+        size_t mask = capacity - 1;
+        for (size_t i = 0; i < _articles.size(); i++)
+        {
+            uint32_t hash = HashIgnoreCase(_articles[i].first);
+            _hashes[i] = hash;
+
+            // Linear probing without deletions: earlier duplicates stay first in their chain,
+            // so lookups return the first occurrence like the old linear scan did
+            size_t pos = hash & mask;
+            while (_table[pos] >= 0)
+                pos = (pos + 1) & mask;
+            _table[pos] = static_cast<int32_t>(i);
+        }
+    }
+
+    int ArticleStore::FindArticleIndex(std::string_view articleId) const
+    {
+        if (_table.empty()) return -1;
+
+        uint32_t hash = HashIgnoreCase(articleId);
+        size_t mask = _table.size() - 1;
+        for (size_t pos = hash & mask; _table[pos] >= 0; pos = (pos + 1) & mask)
+        {
+            int32_t index = _table[pos];
+            if (_hashes[index] == hash && _articles[index].first == articleId)
+                return index;
+        }
+        return -1;
+    }
+
+    int ArticleStore::FindArticleIndexIgnoreCase(std::string_view articleId) const
+    {
+        if (_table.empty()) return -1;
+
+        uint32_t hash = HashIgnoreCase(articleId);
+        size_t mask = _table.size() - 1;
+        for (size_t pos = hash & mask; _table[pos] >= 0; pos = (pos + 1) & mask)
+        {
+            int32_t index = _table[pos];
+            if (_hashes[index] == hash && EqualsIgnoreCase(_articles[index].first, articleId))
+                return index;
+        }
+        return -1;
+    }
+
+    void ArticleStore::SetQuantity(size_t index, int newQty)
+    {
+        if (index < _articles.size())
+            _articles[index].second = (newQty < 0) ? 0 : newQty;
+    }
+
+    bool ArticleStore::UpdateQuantity(std::string_view articleId, int newQty)
+    {
+        int index = FindArticleIndex(articleId);
+        if (index < 0) return false;
+        SetQuantity(static_cast<size_t>(index), newQty);
+        return true;
+    }
+
+    void ArticleView::ShowAll()
+    {
+        _all = true;
+        _indices.clear();
+    }
+
+    int ArticleView::ToPosition(int storeIndex) const
+    {
+        if (storeIndex < 0 || _all) return storeIndex;
+
+        // Indices are ascending, so the row position is found by binary search
+        auto it = std::lower_bound(_indices.begin(), _indices.end(), static_cast<uint32_t>(storeIndex));
+        if (it == _indices.end() || *it != static_cast<uint32_t>(storeIndex)) return -1;
+        return static_cast<int>(it - _indices.begin());
+    }
+
+    int ArticleView::FindArticleIndex(std::string_view articleId) const
+    {
+        return ToPosition(_store->FindArticleIndex(articleId));
+    }
+
+    int ArticleView::FindArticleIndexIgnoreCase(std::string_view articleId) const
+    {
+        return ToPosition(_store->FindArticleIndexIgnoreCase(articleId));
+    }
+
+    std::vector<Article> ArticleView::CopyItems() const
+    {
+        if (_all) return _store->Items();
+
+        std::vector<Article> items;
+        items.reserve(_indices.size());
+        for (uint32_t index : _indices)
+            items.push_back((*_store)[index]);
+        return items;
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+// ArticleStore.h
+// Article list (id, quantity) with an open-addressing hash index on the article ID,
+// and a filtered view that only stores indices into that list.
+// Lookups and quantity updates are O(1) instead of a linear scan per OutputMessage.
+// Only depends on the standard library.
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace RowaPickupSlim
+{
+    /// Article ID and quantity, same layout the UI code has always used
+    using Article = std::pair<std::string, int>;
+
+    class ArticleStore
+    {
+    public:
+        ArticleStore() = default;
+
+        /// Replace the contents; list order is kept and defines the indices
+        void Assign(std::vector<Article> articles);
+
+        void Clear();
+
+        size_t Size() const { return _articles.size(); }
+        bool Empty() const { return _articles.empty(); }
+
+        const Article& operator[](size_t index) const { return _articles[index]; }
+        const std::vector<Article>& Items() const { return _articles; }
+        std::vector<Article>::const_iterator begin() const { return _articles.begin(); }
+        std::vector<Article>::const_iterator end() const { return _articles.end(); }
+
+        /// Find the index of an article by exact ID
+        /// @return Index of the first article with this ID, or -1 if not found
+        int FindArticleIndex(std::string_view articleId) const;
+
+        /// Find the index of an article by ID, ignoring ASCII case (e.g. "ROWA00020556" matches "RoWa00020556")
+        /// @return Index of the first matching article, or -1 if not found
+        int FindArticleIndexIgnoreCase(std::string_view articleId) const;
+
+        /// Set the quantity of the article at index (clamped to >= 0)
+        void SetQuantity(size_t index, int newQty);
+
+        /// Set the quantity of the article with this exact ID (clamped to >= 0)
+        /// @return false if the article is not in the store
+        bool UpdateQuantity(std::string_view articleId, int newQty);
+
+    private:
+        static uint32_t HashIgnoreCase(std::string_view s);
+        void Rebuild();
+
+        std::vector<Article> _articles;
+        std::vector<uint32_t> _hashes;      // Case-folded hash per article, avoids string compares on collisions
+        std::vector<int32_t> _table;        // Open-addressing table of article indices, -1 = empty, size is a power of two
+    };
+
+    /// Filtered view on an ArticleStore: a sorted list of store indices (4 bytes per hit).
+    /// Quantities are read from the store, so an update is always visible in every view.
+    /// Positions passed to and returned from the view are row numbers within the view.
+    class ArticleView
+    {
+    public:
+        explicit ArticleView(const ArticleStore& store) : _store(&store) {}
+
+        /// Show every article of the store (no index list is allocated)
+        void ShowAll();
+
+        /// Show only the store indices for which keep(article) returns true, in store order
+        template <typename Predicate>
+        void Filter(Predicate keep)
+        {
+            _all = false;
+            _indices.clear();
+            const std::vector<Article>& items = _store->Items();
+            for (size_t i = 0; i < items.size(); i++)
+            {
+                if (keep(items[i])) _indices.push_back(static_cast<uint32_t>(i));
+            }
+        }
+
+        size_t Size() const { return _all ? _store->Size() : _indices.size(); }
+        bool Empty() const { return Size() == 0; }
+
+        /// Article shown at row position
+        const Article& operator[](size_t position) const { return (*_store)[StoreIndex(position)]; }
+
+        /// Store index of the article shown at row position
+        size_t StoreIndex(size_t position) const { return _all ? position : _indices[position]; }
+
+        /// True if no filter is active and every store article is shown
+        bool ShowsAll() const { return _all; }
+
+        /// Ascending store indices of the shown articles (empty while ShowsAll())
+        const std::vector<uint32_t>& Indices() const { return _indices; }
+
+        /// Row position of an article by exact ID, or -1 if it is not in the store or filtered out
+        int FindArticleIndex(std::string_view articleId) const;
+
+        /// Row position of an article by ID ignoring ASCII case, or -1
+        int FindArticleIndexIgnoreCase(std::string_view articleId) const;
+
+        /// Copy of the shown articles, for code that works on a snapshot outside the state lock
+        std::vector<Article> CopyItems() const;
+
+    private:
+        int ToPosition(int storeIndex) const;
+
+        const ArticleStore* _store;
+        std::vector<uint32_t> _indices;     // Ascending store indices, unused while _all is set
+        bool _all = true;
+    };
+}
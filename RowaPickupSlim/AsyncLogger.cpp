@@ -0,0 +1,244 @@
+// AsyncLogger.cpp
+// Asynchronous log file writer implementation
+
+#include "AsyncLogger.h"
+#include "IsoTimestamp.h"
+#include <ctime>
+#ifdef _WIN32
+#include <share.h>
+#endif
+
+namespace RowaPickupSlim
+{
+    static constexpr size_t MAX_BATCH_BYTES = 1024 * 1024;          // Write at least once per MB of log text
+    static constexpr size_t MAX_KEPT_SLOT_CAPACITY = 64 * 1024;     // Release slot buffers that held a huge record
+    static constexpr auto IDLE_WAIT = std::chrono::milliseconds(50);
+
+    AsyncLogger::AsyncLogger(size_t capacity, OverflowPolicy policy)
+        : _policy(policy)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+
+        _slots.reset(new Slot[size]);
+        _mask = size - 1;
+        for (size_t i = 0; i < size; i++)
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    AsyncLogger::~AsyncLogger()
+    {
+        Stop();
+    }
+
+    bool AsyncLogger::Open(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(_stopMtx);
+        if (_running.load()) return true;
+
+#ifdef _WIN32
+        // Shared so the log can be read while the application runs
+        _file = _fsopen(path.c_str(), "a", _SH_DENYNO);
+#else
+        _file = std::fopen(path.c_str(), "a");
+#endif
+        if (!_file) return false;
+
+        _stopping.store(false);
+        _running.store(true, std::memory_order_release);
+        _writer = std::thread(&AsyncLogger::WriterLoop, this);
+        return true;
+    }
+
+    // Keeps a Push() counted in _producersInPush until it returns
+    struct ProducerInPush
+    {
+        std::atomic<int>& count;
+        explicit ProducerInPush(std::atomic<int>& c) : count(c) { count.fetch_add(1, std::memory_order_seq_cst); }
+        ~ProducerInPush() { count.fetch_sub(1, std::memory_order_release); }
+    };
+
+    bool AsyncLogger::Push(std::string_view message)
+    {
+        // Counted before _running is checked: either Stop() has not begun and the writer waits for this
+        // call before its final drain, or this call sees _running false and rejects the record
+        ProducerInPush inPush(_producersInPush);
+        if (!_running.load(std::memory_order_seq_cst)) return false;
+
+        auto now = std::chrono::system_clock::now();
+
+        // Bounded MPMC ring (Vyukov): a slot is free for position pos when its sequence equals pos
+        size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;)
+        {
+            slot = &_slots[pos & _mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+            if (diff == 0)
+            {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // Ring full
+                if (_policy == OverflowPolicy::Drop || _stopping.load(std::memory_order_relaxed))
+                {
+                    _dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                _wake.notify_one();
+                std::this_thread::yield();
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->time = now;
+        slot->text.assign(message.data(), message.size());
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        _pushed.fetch_add(1, std::memory_order_relaxed);
+
+        // The writer also wakes up on its own every IDLE_WAIT, so a missed signal only delays the write
+        if (_writerIdle.load(std::memory_order_acquire))
+            _wake.notify_one();
+        return true;
+    }
+
+    void AsyncLogger::Flush()
+    {
+        size_t target = _enqueuePos.load(std::memory_order_acquire);
+
+        std::unique_lock<std::mutex> lock(_wakeMtx);
+        _wake.notify_one();
+        _flushed.wait(lock, [&]() {
+            return _writtenPos.load(std::memory_order_acquire) >= target || !_running.load(std::memory_order_acquire);
+        });
+    }
+
+    void AsyncLogger::Stop()
+    {
+        std::lock_guard<std::mutex> lock(_stopMtx);
+        if (!_running.load()) return;
+
+        // New pushes are rejected; the writer waits for the pushes already under way, drains
+        // everything they claimed, then exits
+        _running.store(false, std::memory_order_seq_cst);
+        _stopping.store(true);
+        {
+            std::lock_guard<std::mutex> wakeLock(_wakeMtx);
+            _wake.notify_one();
+        }
+        if (_writer.joinable()) _writer.join();
+
+        std::fclose(_file);
+        _file = nullptr;
+
+        std::lock_guard<std::mutex> wakeLock(_wakeMtx);
+        _flushed.notify_all();
+    }
+
+    AsyncLogger::Counters AsyncLogger::GetCounters() const
+    {
+        Counters c;
+        c.pushed = _pushed.load(std::memory_order_relaxed);
+        c.dropped = _dropped.load(std::memory_order_relaxed);
+        c.written = _writtenPos.load(std::memory_order_relaxed);
+        c.batches = _batches.load(std::memory_order_relaxed);
+        c.maxBatch = _maxBatch.load(std::memory_order_relaxed);
+        return c;
+    }
+
+    void AsyncLogger::FormatLine(std::string& out, std::chrono::system_clock::time_point time, std::string_view message)
+    {
+        // localtime is only evaluated once per second
+        thread_local IsoTimestampFormatter stamp(IsoTimestampFormatter::Zone::Local, IsoTimestampFormatter::Layout::Time);
+
+        out.push_back('[');
+        out.append(stamp.Format(time));
+        out.append("] ", 2);
+        out.append(message.data(), message.size());
+        out.push_back('\n');
+    }
+
+    size_t AsyncLogger::DrainBatch(std::string& batch)
+    {
+        size_t count = 0;
+        while (batch.size() < MAX_BATCH_BYTES)
+        {
+            Slot& slot = _slots[_dequeuePos & _mask];
+            if (slot.sequence.load(std::memory_order_acquire) != _dequeuePos + 1)
+                break;      // Empty, or claimed but not yet filled in
+
+            FormatLine(batch, slot.time, slot.text);
+            if (slot.text.capacity() > MAX_KEPT_SLOT_CAPACITY)
+                std::string().swap(slot.text);
+
+            slot.sequence.store(_dequeuePos + _mask + 1, std::memory_order_release);
+            _dequeuePos++;
+            count++;
+        }
+
+        uint64_t dropped = _dropped.load(std::memory_order_relaxed);
+        if (dropped != _droppedReported)
+        {
+            FormatLine(batch, std::chrono::system_clock::now(),
+                "[LOG] " + std::to_string(dropped - _droppedReported) + " log records dropped (queue full)");
+            _droppedReported = dropped;
+        }
+        return count;
+    }
+
+    void AsyncLogger::WriterLoop()
+    {
+        std::string batch;
+        batch.reserve(64 * 1024);
+
+        for (;;)
+        {
+            batch.clear();
+            size_t count = DrainBatch(batch);
+
+            if (!batch.empty())
+            {
+                std::fwrite(batch.data(), 1, batch.size(), _file);
+                std::fflush(_file);
+
+                _batches.fetch_add(1, std::memory_order_relaxed);
+                if (count > _maxBatch.load(std::memory_order_relaxed))
+                    _maxBatch.store(count, std::memory_order_relaxed);
+
+                {
+                    std::lock_guard<std::mutex> lock(_wakeMtx);
+                    _writtenPos.store(_dequeuePos, std::memory_order_release);
+                }
+                _flushed.notify_all();
+
+                if (BatchWritten)
+                {
+                    try { BatchWritten(batch); } catch (...) {}
+                }
+                continue;
+            }
+
+            if (_stopping.load() && _producersInPush.load(std::memory_order_seq_cst) == 0 &&
+                _dequeuePos == _enqueuePos.load(std::memory_order_acquire))
+                break;
+
+            std::unique_lock<std::mutex> lock(_wakeMtx);
+            _writerIdle.store(true, std::memory_order_release);
+            if (_slots[_dequeuePos & _mask].sequence.load(std::memory_order_acquire) != _dequeuePos + 1)
+            {
+                // While stopping, a producer may still be claiming or filling in a slot: poll briefly
+                _wake.wait_for(lock, _stopping.load() ? std::chrono::milliseconds(1) : IDLE_WAIT);
+            }
+            _writerIdle.store(false, std::memory_order_relaxed);
+        }
+    }
+}
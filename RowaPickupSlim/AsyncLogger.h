@@ -0,0 +1,109 @@
+#pragma once
+// AsyncLogger.h
+// Asynchronous log file writer.
+// Producers push records into a bounded lock-free multi-producer ring; one background
+// thread formats them, writes them in batches to a file that stays open, and flushes.
+// Only depends on the standard library.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace RowaPickupSlim
+{
+    class AsyncLogger
+    {
+    public:
+        /// What Push() does when the ring is full
+        enum class OverflowPolicy
+        {
+            Drop,       // Discard the record and count it; producers never wait
+            Block       // Wait (yield) until the writer made room
+        };
+
+        struct Counters
+        {
+            uint64_t pushed = 0;        // Records accepted
+            uint64_t dropped = 0;       // Records discarded because the ring was full
+            uint64_t written = 0;       // Records written to the file
+            uint64_t batches = 0;       // File writes (one per batch)
+            uint64_t maxBatch = 0;      // Most records written in one batch
+        };
+
+        /// @param capacity Ring size in records, rounded up to a power of two
+        explicit AsyncLogger(size_t capacity = 4096, OverflowPolicy policy = OverflowPolicy::Drop);
+        ~AsyncLogger();
+
+        AsyncLogger(const AsyncLogger&) = delete;
+        AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+        /// Open (append) the log file and start the writer thread
+        /// @return false if the file could not be opened
+        bool Open(const std::string& path);
+
+        /// Queue one log line; the timestamp is taken here, formatting happens on the writer thread.
+        /// @return false if the record was dropped or the logger is not running
+        bool Push(std::string_view message);
+
+        /// Block until every record pushed before this call is written and flushed to the file
+        void Flush();
+
+        /// Write all queued records, close the file and stop the writer thread.
+        /// Called by the destructor; safe to call more than once.
+        void Stop();
+
+        bool IsRunning() const { return _running.load(std::memory_order_acquire); }
+
+        Counters GetCounters() const;
+
+        /// Called on the writer thread with every formatted batch after it was written (e.g. debug output)
+        std::function<void(const std::string& batch)> BatchWritten;
+
+        /// Format one line as the writer does: "[HH:MM:SS] message\n" in local time
+        static void FormatLine(std::string& out, std::chrono::system_clock::time_point time, std::string_view message);
+
+    private:
+        struct Slot
+        {
+            std::atomic<size_t> sequence{ 0 };
+            std::chrono::system_clock::time_point time;
+            std::string text;               // Capacity is kept between uses, so steady-state pushes do not allocate
+        };
+
+        void WriterLoop();
+        size_t DrainBatch(std::string& batch);
+
+        std::unique_ptr<Slot[]> _slots;
+        size_t _mask;
+        OverflowPolicy _policy;
+
+        alignas(64) std::atomic<size_t> _enqueuePos{ 0 };     // Next position claimed by a producer
+        alignas(64) std::atomic<size_t> _writtenPos{ 0 };     // All positions below this are written and flushed
+        size_t _dequeuePos = 0;                                // Writer thread only
+
+        std::atomic<uint64_t> _pushed{ 0 };
+        std::atomic<uint64_t> _dropped{ 0 };
+        std::atomic<uint64_t> _batches{ 0 };
+        std::atomic<uint64_t> _maxBatch{ 0 };
+        uint64_t _droppedReported = 0;                         // Writer thread only
+
+        std::FILE* _file = nullptr;
+        std::thread _writer;
+        std::atomic<bool> _running{ false };
+        std::atomic<bool> _stopping{ false };
+        std::atomic<int> _producersInPush{ 0 };                // Push() calls past their _running check; Stop() waits for them
+        std::atomic<bool> _writerIdle{ false };                // Producers only signal while the writer sleeps
+        std::mutex _wakeMtx;
+        std::condition_variable _wake;                         // Wakes the writer
+        std::condition_variable _flushed;                      // Wakes Flush() callers
+        std::mutex _stopMtx;                                   // Serializes Open() / Stop()
+    };
+}
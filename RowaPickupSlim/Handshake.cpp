@@ -0,0 +1,150 @@
+// Handshake.cpp
+// WWKS handshake state machine implementation
+
+#include "Handshake.h"
+
+namespace RowaPickupSlim
+{
+    static size_t Index(Handshake::Step step)
+    {
+        return static_cast<size_t>(step);
+    }
+
+    Handshake::Handshake(Reactor& reactor, const Options& options)
+        : _reactor(reactor), _options(options)
+    {
+        if (_options.maxAttempts < 1) _options.maxAttempts = 1;
+    }
+
+    Handshake::~Handshake()
+    {
+        CancelTimers();
+    }
+
+    const char* Handshake::StepName(Step step)
+    {
+        switch (step)
+        {
+        case Step::Hello: return "Hello";
+        case Step::Status: return "Status";
+        case Step::StockInfo: return "StockInfo";
+        }
+        return "";
+    }
+
+    void Handshake::Start()
+    {
+        if (_state != State::Idle) return;
+
+        _state = State::Running;
+        _started = Reactor::Clock::now();
+        SendStep(Step::Hello);
+    }
+
+    bool Handshake::OnMessage(WwksMessageType type)
+    {
+        if (_state != State::Running) return false;
+
+        Step step;
+        switch (type)
+        {
+        case WwksMessageType::HelloResponse: step = Step::Hello; break;
+        case WwksMessageType::StatusResponse: step = Step::Status; break;
+        case WwksMessageType::StockInfoResponse: step = Step::StockInfo; break;
+        default: return false;
+        }
+
+        // Only a response to a request of this handshake counts (not one that arrives before it was sent)
+        StepState& state = _steps[Index(step)];
+        StepResult& result = _results[Index(step)];
+        if (!state.sent || result.answered) return false;
+
+        Reactor::Clock::time_point now = Reactor::Clock::now();
+        result.answered = true;
+        result.duration = now - state.firstSent;
+        _reactor.CancelTimer(state.timer);
+        state.timer = 0;
+
+        if (step == Step::Hello)
+        {
+            SendStep(Step::Status);
+            if (_options.pipelined)
+                SendStep(Step::StockInfo);
+        }
+        else if (step == Step::Status && !_options.pipelined)
+        {
+            SendStep(Step::StockInfo);
+        }
+
+        if (_results[Index(Step::Hello)].answered && _results[Index(Step::Status)].answered &&
+            _results[Index(Step::StockInfo)].answered)
+        {
+            _totalDuration = now - _started;
+            Finish(true, Step::StockInfo);
+        }
+        return true;
+    }
+
+    void Handshake::SendStep(Step step)
+    {
+        StepState& state = _steps[Index(step)];
+        StepResult& result = _results[Index(step)];
+        if (!state.sent)
+        {
+            state.sent = true;
+            state.firstSent = Reactor::Clock::now();
+        }
+        result.attempts++;
+
+        if (SendRequest)
+        {
+            try { SendRequest(step); } catch (...) {}
+        }
+
+        state.timer = _reactor.AddTimer(_options.timeouts[Index(step)], [this, step]() { OnTimeout(step); });
+    }
+
+    void Handshake::OnTimeout(Step step)
+    {
+        StepState& state = _steps[Index(step)];
+        StepResult& result = _results[Index(step)];
+        state.timer = 0;
+        if (_state != State::Running || result.answered) return;
+
+        if (result.attempts >= _options.maxAttempts)
+        {
+            result.duration = Reactor::Clock::now() - state.firstSent;
+            Finish(false, step);
+            return;
+        }
+
+        if (Retrying)
+        {
+            try { Retrying(step, result.attempts + 1); } catch (...) {}
+        }
+        SendStep(step);
+    }
+
+    void Handshake::Finish(bool ok, Step step)
+    {
+        _state = ok ? State::Complete : State::Failed;
+        CancelTimers();
+
+        if (Finished)
+        {
+            try { Finished(ok, step); } catch (...) {}
+        }
+    }
+
+    void Handshake::CancelTimers()
+    {
+        for (StepState& state : _steps)
+        {
+            if (state.timer != 0)
+            {
+                _reactor.CancelTimer(state.timer);
+                state.timer = 0;
+            }
+        }
+    }
+}
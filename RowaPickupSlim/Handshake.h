@@ -0,0 +1,101 @@
+#pragma once
+// Handshake.h
+// WWKS connection handshake: HelloRequest -> StatusRequest -> StockInfoRequest.
+// Each request is sent the moment the response it depends on arrives; every step has its
+// own timeout and retry count, and its duration (first send -> response) is recorded.
+// Runs on the reactor thread of the connection.
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include "Reactor.h"
+#include "WwksClassifier.h"
+
+namespace RowaPickupSlim
+{
+    class Handshake
+    {
+    public:
+        enum class Step
+        {
+            Hello = 0,
+            Status,
+            StockInfo
+        };
+        static constexpr size_t STEP_COUNT = 3;
+
+        struct Options
+        {
+            /// Time to wait for each step's response before the request is sent again (by Step)
+            std::array<std::chrono::milliseconds, STEP_COUNT> timeouts{
+                std::chrono::milliseconds(5000), std::chrono::milliseconds(5000), std::chrono::milliseconds(30000) };
+            /// Requests sent per step, including the first, before the handshake fails
+            int maxAttempts = 3;
+            /// Send StatusRequest and StockInfoRequest together right after HelloResponse,
+            /// instead of waiting for StatusResponse before sending StockInfoRequest
+            bool pipelined = false;
+        };
+
+        struct StepResult
+        {
+            int attempts = 0;                   // Requests sent
+            bool answered = false;
+            Reactor::Clock::duration duration{};    // First request -> response (or -> giving up)
+        };
+
+        Handshake(Reactor& reactor, const Options& options);
+        ~Handshake();
+
+        Handshake(const Handshake&) = delete;
+        Handshake& operator=(const Handshake&) = delete;
+
+        /// Sends the request of a step (wired to NetworkClient::SendHelloRequest etc.)
+        std::function<void(Step step)> SendRequest;
+
+        /// Called once: ok = every step answered, otherwise failedStep ran out of attempts
+        std::function<void(bool ok, Step failedStep)> Finished;
+
+        /// Called when a request is sent again after a timeout
+        std::function<void(Step step, int attempt)> Retrying;
+
+        /// Send HelloRequest
+        void Start();
+
+        /// Feed the type of every received message
+        /// @return true if it answered a pending step
+        bool OnMessage(WwksMessageType type);
+
+        bool IsComplete() const { return _state == State::Complete; }
+        bool IsFailed() const { return _state == State::Failed; }
+
+        const StepResult& GetResult(Step step) const { return _results[static_cast<size_t>(step)]; }
+
+        /// Start() -> last response (zero until complete)
+        Reactor::Clock::duration GetTotalDuration() const { return _totalDuration; }
+
+        static const char* StepName(Step step);
+
+    private:
+        enum class State { Idle, Running, Complete, Failed };
+
+        struct StepState
+        {
+            bool sent = false;
+            Reactor::Clock::time_point firstSent;
+            Reactor::TimerId timer = 0;
+        };
+
+        void SendStep(Step step);
+        void OnTimeout(Step step);
+        void Finish(bool ok, Step step);
+        void CancelTimers();
+
+        Reactor& _reactor;
+        Options _options;
+        State _state = State::Idle;
+        Reactor::Clock::time_point _started;
+        Reactor::Clock::duration _totalDuration{};
+        std::array<StepState, STEP_COUNT> _steps;
+        std::array<StepResult, STEP_COUNT> _results;
+    };
+}
@@ -0,0 +1,272 @@
+// IsoTimestamp.cpp
+// Cached ISO-8601 formatting and allocation-free parsing
+
+#include "IsoTimestamp.h"
+
+namespace RowaPickupSlim
+{
+    static constexpr int64_t NANOS_PER_SECOND = 1000000000;
+    static constexpr int64_t SECONDS_PER_DAY = 86400;
+
+    int64_t DaysFromCivil(int year, unsigned month, unsigned day)
+    {
+        // Howard Hinnant's days_from_civil: 400-year eras starting on March 1st
+        year -= month <= 2;
+        const int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const unsigned yoe = static_cast<unsigned>(year - era * 400);
+        const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+    static void CivilFromDays(int64_t days, int& year, unsigned& month, unsigned& day)
+    {
+        days += 719468;
+        const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const unsigned doe = static_cast<unsigned>(days - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+        day = doy - (153 * mp + 2) / 5 + 1;
+        month = mp < 10 ? mp + 3 : mp - 9;
+        year = static_cast<int>(static_cast<int64_t>(yoe) + era * 400 + (month <= 2));
+    }
+
+    static bool IsLeapYear(int year)
+    {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+
+    static unsigned DaysInMonth(int year, unsigned month)
+    {
+        static const unsigned days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        return month == 2 && IsLeapYear(year) ? 29 : days[month - 1];
+    }
+
+    static void PutDigits(char* out, unsigned value, int count)
+    {
+        for (int i = count - 1; i >= 0; i--)
+        {
+            out[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    }
+
+    // ========================================================================
+    // IsoTimestampFormatter
+    // ========================================================================
+
+    IsoTimestampFormatter::IsoTimestampFormatter(Zone zone, Layout layout, int fractionDigits)
+        : _zone(zone), _layout(layout), _fractionDigits(fractionDigits < 0 ? 0 : fractionDigits > 9 ? 9 : fractionDigits)
+    {
+    }
+
+    std::string_view IsoTimestampFormatter::Format(std::chrono::system_clock::time_point time)
+    {
+        int64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+        int64_t second = nanos / NANOS_PER_SECOND;
+        int64_t fraction = nanos % NANOS_PER_SECOND;
+        if (fraction < 0)
+        {
+            second--;
+            fraction += NANOS_PER_SECOND;
+        }
+
+        if (second != _second) FormatSecond(second);
+
+        // Within the second only the fraction digits change
+        if (_fractionDigits > 0)
+        {
+            for (int i = _fractionDigits; i < 9; i++)
+                fraction /= 10;
+            PutDigits(_text + _fractionOffset, static_cast<unsigned>(fraction), _fractionDigits);
+        }
+        return std::string_view(_text, _length);
+    }
+
+    std::string_view IsoTimestampFormatter::Format(std::time_t seconds)
+    {
+        return Format(std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::seconds(static_cast<int64_t>(seconds)))));
+    }
+
+    void IsoTimestampFormatter::FormatSecond(int64_t seconds)
+    {
+        int year = 1970;
+        unsigned month = 1, day = 1, hour = 0, minute = 0, second = 0;
+
+        if (_zone == Zone::Utc)
+        {
+            int64_t days = seconds / SECONDS_PER_DAY;
+            int64_t secondOfDay = seconds % SECONDS_PER_DAY;
+            if (secondOfDay < 0)
+            {
+                days--;
+                secondOfDay += SECONDS_PER_DAY;
+            }
+            CivilFromDays(days, year, month, day);
+            hour = static_cast<unsigned>(secondOfDay / 3600);
+            minute = static_cast<unsigned>(secondOfDay / 60 % 60);
+            second = static_cast<unsigned>(secondOfDay % 60);
+        }
+        else
+        {
+            std::time_t t = static_cast<std::time_t>(seconds);
+            std::tm tm{};
+#ifdef _WIN32
+            localtime_s(&tm, &t);
+#else
+            localtime_r(&t, &tm);
+#endif
+            year = tm.tm_year + 1900;
+            month = static_cast<unsigned>(tm.tm_mon + 1);
+            day = static_cast<unsigned>(tm.tm_mday);
+            hour = static_cast<unsigned>(tm.tm_hour);
+            minute = static_cast<unsigned>(tm.tm_min);
+            second = static_cast<unsigned>(tm.tm_sec);
+        }
+
+        char* p = _text;
+        if (_layout == Layout::DateTime)
+        {
+            PutDigits(p, static_cast<unsigned>(year < 0 ? 0 : year > 9999 ? 9999 : year), 4);
+            p[4] = '-';
+            PutDigits(p + 5, month, 2);
+            p[7] = '-';
+            PutDigits(p + 8, day, 2);
+            p[10] = 'T';
+            p += 11;
+        }
+        PutDigits(p, hour, 2);
+        p[2] = ':';
+        PutDigits(p + 3, minute, 2);
+        p[5] = ':';
+        PutDigits(p + 6, second, 2);
+        p += 8;
+
+        if (_fractionDigits > 0)
+        {
+            *p++ = '.';
+            _fractionOffset = static_cast<size_t>(p - _text);
+            p += _fractionDigits;
+        }
+        if (_layout == Layout::DateTime && _zone == Zone::Utc)
+            *p++ = 'Z';
+
+        _length = static_cast<size_t>(p - _text);
+        _second = seconds;
+    }
+
+    // ========================================================================
+    // ParseIsoTimestamp
+    // ========================================================================
+
+    // count digits at pos; false if any is not a digit or text is too short
+    static bool ReadDigits(std::string_view text, size_t pos, size_t count, unsigned& value)
+    {
+        if (pos + count > text.size()) return false;
+
+        value = 0;
+        for (size_t i = pos; i < pos + count; i++)
+        {
+            unsigned digit = static_cast<unsigned>(text[i] - '0');
+            if (digit > 9) return false;
+            value = value * 10 + digit;
+        }
+        return true;
+    }
+
+    bool ParseIsoTimestamp(std::string_view text, std::chrono::system_clock::time_point& time, bool* hasZone)
+    {
+        // YYYY-MM-DD
+        unsigned year, month, day;
+        if (!ReadDigits(text, 0, 4, year) || text.size() < 10 || text[4] != '-' || text[7] != '-' ||
+            !ReadDigits(text, 5, 2, month) || !ReadDigits(text, 8, 2, day))
+            return false;
+        if (month < 1 || month > 12 || day < 1 || day > DaysInMonth(static_cast<int>(year), month))
+            return false;
+
+        unsigned hour = 0, minute = 0, second = 0;
+        int64_t fraction = 0;
+        int64_t offsetSeconds = 0;
+        bool zone = false;
+        size_t pos = 10;
+
+        if (pos < text.size())
+        {
+            // THH:MM[:SS[.fraction]]
+            char separator = text[pos];
+            if ((separator != 'T' && separator != 't' && separator != ' ') ||
+                !ReadDigits(text, pos + 1, 2, hour) || pos + 3 >= text.size() || text[pos + 3] != ':' ||
+                !ReadDigits(text, pos + 4, 2, minute))
+                return false;
+            pos += 6;
+
+            if (pos < text.size() && text[pos] == ':')
+            {
+                if (!ReadDigits(text, pos + 1, 2, second)) return false;
+                pos += 3;
+
+                if (pos < text.size() && (text[pos] == '.' || text[pos] == ','))
+                {
+                    size_t digits = 0;
+                    int64_t scale = NANOS_PER_SECOND;
+                    for (pos++; pos < text.size() && static_cast<unsigned>(text[pos] - '0') <= 9; pos++, digits++)
+                    {
+                        if (scale > 1)
+                        {
+                            scale /= 10;
+                            fraction += (text[pos] - '0') * scale;
+                        }
+                    }
+                    if (digits == 0) return false;
+                }
+            }
+            if (hour > 23 || minute > 59 || second > 60) return false;     // 60: leap second
+
+            // Z | +HH[:MM] | -HH[:MM]
+            if (pos < text.size())
+            {
+                char sign = text[pos];
+                if (sign == 'Z' || sign == 'z')
+                {
+                    pos++;
+                }
+                else if (sign == '+' || sign == '-')
+                {
+                    unsigned offsetHours, offsetMinutes = 0;
+                    if (!ReadDigits(text, pos + 1, 2, offsetHours)) return false;
+                    pos += 3;
+                    if (pos < text.size() && text[pos] == ':') pos++;
+                    if (pos < text.size())
+                    {
+                        if (!ReadDigits(text, pos, 2, offsetMinutes)) return false;
+                        pos += 2;
+                    }
+                    if (offsetHours > 23 || offsetMinutes > 59) return false;
+                    offsetSeconds = (sign == '+' ? 1 : -1) * static_cast<int64_t>(offsetHours * 3600 + offsetMinutes * 60);
+                }
+                else
+                {
+                    return false;
+                }
+                zone = true;
+            }
+            if (pos != text.size()) return false;
+        }
+
+        int64_t seconds = DaysFromCivil(static_cast<int>(year), month, day) * SECONDS_PER_DAY +
+                          hour * 3600 + minute * 60 + second - offsetSeconds;
+
+        // Dates the clock cannot represent (e.g. 9999-12-31 with a nanosecond system_clock)
+        using Duration = std::chrono::system_clock::duration;
+        const int64_t maxSeconds = std::chrono::duration_cast<std::chrono::seconds>(Duration::max()).count() - 1;
+        const int64_t minSeconds = std::chrono::duration_cast<std::chrono::seconds>(Duration::min()).count() + 1;
+        if (seconds > maxSeconds || seconds < minSeconds) return false;
+
+        time = std::chrono::system_clock::time_point(std::chrono::duration_cast<Duration>(std::chrono::seconds(seconds)) +
+                                                     std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(fraction)));
+        if (hasZone) *hasZone = zone;
+        return true;
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+// IsoTimestamp.h
+// ISO-8601 timestamps without the C library on the hot path.
+// IsoTimestampFormatter keeps the text of the current second and only patches the sub-second
+// digits while the second stays the same; the calendar conversion runs at most once per second
+// (UTC is converted arithmetically, local time through localtime once per second).
+// ParseIsoTimestamp reads WWKS TimeStamp / ExpiryDate values into a time point without
+// allocating and without mktime / timegm.
+// Only depends on the standard library.
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string_view>
+
+namespace RowaPickupSlim
+{
+    class IsoTimestampFormatter
+    {
+    public:
+        enum class Zone
+        {
+            Utc,        // DateTime layout ends in 'Z'
+            Local
+        };
+
+        enum class Layout
+        {
+            DateTime,   // YYYY-MM-DDTHH:MM:SS[.fff][Z]
+            Time        // HH:MM:SS[.fff]
+        };
+
+        /// @param fractionDigits Sub-second digits (0..9), e.g. 3 for milliseconds
+        explicit IsoTimestampFormatter(Zone zone = Zone::Utc, Layout layout = Layout::DateTime, int fractionDigits = 0);
+
+        /// Text of the given time; valid until the next call. Not thread-safe: one formatter per thread.
+        std::string_view Format(std::chrono::system_clock::time_point time);
+
+        /// Whole seconds (fraction digits are zero)
+        std::string_view Format(std::time_t seconds);
+
+    private:
+        void FormatSecond(int64_t seconds);
+
+        Zone _zone;
+        Layout _layout;
+        int _fractionDigits;
+        int64_t _second = INT64_MIN;        // Second the text holds
+        char _text[40] = {};
+        size_t _fractionOffset = 0;         // Position of the first fraction digit
+        size_t _length = 0;
+    };
+
+    /// Parse an ISO-8601 date or date-time as used in WWKS:
+    ///   YYYY-MM-DD, or YYYY-MM-DDTHH:MM[:SS[.fraction]] followed by nothing, 'Z' or +HH[:MM] / -HH[:MM].
+    /// A space is accepted instead of 'T'; fraction digits beyond nanoseconds are ignored.
+    /// A value without a zone is taken as UTC; hasZone (optional) tells the two apart.
+    /// @return false if text is not in that form or a field is out of range
+    bool ParseIsoTimestamp(std::string_view text, std::chrono::system_clock::time_point& time, bool* hasZone = nullptr);
+
+    /// Days since 1970-01-01 of a proleptic Gregorian date (no range check)
+    int64_t DaysFromCivil(int year, unsigned month, unsigned day);
+}
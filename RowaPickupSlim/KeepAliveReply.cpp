@@ -0,0 +1,30 @@
+// KeepAliveReply.cpp
+// KeepAliveResponse rendering
+
+#include "KeepAliveReply.h"
+#include "WwksClassifier.h"
+
+namespace RowaPickupSlim
+{
+    bool KeepAliveReply::Render(std::string_view requestTag, std::time_t now, std::string& out)
+    {
+        std::string_view id, source, destination;
+        if (!FindTagAttribute(requestTag, "Id", id) ||
+            !FindTagAttribute(requestTag, "Source", source) ||
+            !FindTagAttribute(requestTag, "Destination", destination))
+            return false;
+
+        // The values are copied raw: they are attribute text of the request already.
+        // We answer: the request's Destination (us) becomes the Source
+        std::string_view frame = _builder.Begin(now)
+            .Element("KeepAliveResponse").AttributeRaw("Id", id).AttributeRaw("Source", destination)
+            .AttributeRaw("Destination", source).Empty()
+            .End();
+
+        out.clear();
+        out.reserve(frame.size() + 1);
+        out.append(frame);
+        out.push_back('\n');
+        return true;
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+// KeepAliveReply.h
+// Fast path for answering the robot's KeepAliveRequest.
+// The KeepAliveResponse is built with a WwksMessageBuilder owned by the reply: only the Id,
+// the swapped Source / Destination and the timestamp are spliced in, the timestamp text is
+// formatted once per second. No DOM, no stream; one allocation sized up front.
+// Only depends on the standard library.
+
+#include <ctime>
+#include <string>
+#include <string_view>
+#include "WwksMessageBuilder.h"
+
+namespace RowaPickupSlim
+{
+    class KeepAliveReply
+    {
+    public:
+        /// Render the response to a KeepAliveRequest
+        /// @param requestTag The request's start tag (bodyTag from ClassifyWwksFrame)
+        /// @param now Current UTC time for the WWKS TimeStamp
+        /// @param out Replaced with the complete frame, including the line terminator
+        /// @return false if the request lacks Id, Source or Destination
+        bool Render(std::string_view requestTag, std::time_t now, std::string& out);
+
+    private:
+        WwksMessageBuilder _builder{ 256 };
+    };
+}
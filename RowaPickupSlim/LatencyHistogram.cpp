@@ -0,0 +1,106 @@
+// LatencyHistogram.cpp
+// Log-linear histogram implementation
+
+#include "LatencyHistogram.h"
+#include <algorithm>
+
+namespace RowaPickupSlim
+{
+    static unsigned HighestBit(uint64_t value)
+    {
+        unsigned bit = 0;
+        while (value >>= 1) bit++;
+        return bit;
+    }
+
+    // Values below SUB_COUNT get one bucket each; above, each power of two is split into SUB_COUNT buckets
+    size_t LatencyHistogram::BucketOf(uint64_t value)
+    {
+        if (value < SUB_COUNT) return static_cast<size_t>(value);
+        unsigned shift = HighestBit(value) - SUB_BITS;
+        return static_cast<size_t>((shift + 1) * SUB_COUNT + ((value >> shift) & (SUB_COUNT - 1)));
+    }
+
+    uint64_t LatencyHistogram::BucketUpperBound(size_t bucket)
+    {
+        if (bucket < SUB_COUNT) return bucket;
+        uint64_t shift = bucket / SUB_COUNT - 1;
+        uint64_t mantissa = SUB_COUNT + bucket % SUB_COUNT;
+        return (mantissa << shift) + ((1ull << shift) - 1);
+    }
+
+    void LatencyHistogram::Record(Duration latency)
+    {
+        uint64_t value = latency.count() > 0 ? static_cast<uint64_t>(latency.count()) : 0;
+        size_t bucket = BucketOf(value);
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        _buckets[bucket]++;
+        _count++;
+        _sum += value;
+        _min = std::min(_min, value);
+        _max = std::max(_max, value);
+    }
+
+    void LatencyHistogram::Merge(const LatencyHistogram& other)
+    {
+        if (&other == this) return;
+        std::scoped_lock lock(_mtx, other._mtx);
+        for (size_t i = 0; i < BUCKETS; i++)
+            _buckets[i] += other._buckets[i];
+        _count += other._count;
+        _sum += other._sum;
+        _min = std::min(_min, other._min);
+        _max = std::max(_max, other._max);
+    }
+
+    LatencyHistogram::Duration LatencyHistogram::PercentileLocked(double fraction) const
+    {
+        if (_count == 0) return Duration::zero();
+
+        // Rank of the sample, 1-based, rounded up
+        fraction = std::clamp(fraction, 0.0, 1.0);
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(_count) + 0.999999));
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; i++)
+        {
+            seen += _buckets[i];
+            if (seen >= rank)
+                return Duration(static_cast<Duration::rep>(std::min(BucketUpperBound(i), _max)));
+        }
+        return Duration(static_cast<Duration::rep>(_max));
+    }
+
+    LatencyHistogram::Duration LatencyHistogram::Percentile(double fraction) const
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return PercentileLocked(fraction);
+    }
+
+    LatencyHistogram::Summary LatencyHistogram::GetSummary() const
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        Summary summary;
+        summary.count = _count;
+        if (_count == 0) return summary;
+
+        summary.min = Duration(static_cast<Duration::rep>(_min));
+        summary.max = Duration(static_cast<Duration::rep>(_max));
+        summary.mean = Duration(static_cast<Duration::rep>(_sum / _count));
+        summary.p50 = PercentileLocked(0.50);
+        summary.p99 = PercentileLocked(0.99);
+        summary.p999 = PercentileLocked(0.999);
+        return summary;
+    }
+
+    void LatencyHistogram::Reset()
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _buckets.fill(0);
+        _count = 0;
+        _sum = 0;
+        _min = UINT64_MAX;
+        _max = 0;
+    }
+}
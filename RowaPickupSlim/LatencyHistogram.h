@@ -0,0 +1,61 @@
+#pragma once
+// LatencyHistogram.h
+// Fixed-size log-linear latency histogram (16 sub-buckets per power of two, ~6% resolution)
+// for percentile reporting without storing samples. Record() is O(1) and never allocates.
+// Only depends on the standard library.
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace RowaPickupSlim
+{
+    class LatencyHistogram
+    {
+    public:
+        using Duration = std::chrono::nanoseconds;
+
+        struct Summary
+        {
+            uint64_t count = 0;
+            Duration min{};
+            Duration max{};
+            Duration mean{};
+            Duration p50{};
+            Duration p99{};
+            Duration p999{};
+        };
+
+        LatencyHistogram() = default;
+
+        /// Thread-safe
+        void Record(Duration latency);
+
+        /// Add every sample of other
+        void Merge(const LatencyHistogram& other);
+
+        /// Upper bound of the bucket that holds the given fraction (0..1) of the samples
+        Duration Percentile(double fraction) const;
+
+        Summary GetSummary() const;
+
+        void Reset();
+
+    private:
+        static constexpr unsigned SUB_BITS = 4;
+        static constexpr uint64_t SUB_COUNT = 1ull << SUB_BITS;
+        static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+        static size_t BucketOf(uint64_t value);
+        static uint64_t BucketUpperBound(size_t bucket);
+        Duration PercentileLocked(double fraction) const;
+
+        mutable std::mutex _mtx;
+        std::array<uint64_t, BUCKETS> _buckets{};
+        uint64_t _count = 0;
+        uint64_t _sum = 0;
+        uint64_t _min = UINT64_MAX;
+        uint64_t _max = 0;
+    };
+}
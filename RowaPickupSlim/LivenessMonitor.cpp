@@ -0,0 +1,98 @@
+// LivenessMonitor.cpp
+// KeepAlive cadence learning and dead-peer verdicts
+
+#include "LivenessMonitor.h"
+#include <algorithm>
+
+namespace RowaPickupSlim
+{
+    LivenessMonitor::LivenessMonitor()
+        : LivenessMonitor(Options())
+    {
+    }
+
+    LivenessMonitor::LivenessMonitor(const Options& options)
+        : _options(options)
+    {
+        _options.missedIntervals = std::max<uint32_t>(_options.missedIntervals, 1);
+        _options.smoothing = std::clamp(_options.smoothing, 0.0, 1.0);
+        _metrics.interval = std::clamp(_options.initialInterval, _options.minInterval, _options.maxInterval);
+        _lastReceive = Clock::now();
+    }
+
+    void LivenessMonitor::Reset(Clock::time_point now)
+    {
+        _lastReceive = now;
+        _haveKeepAlive = false;     // A gap across a reconnect is not a KeepAlive interval
+        _probed = false;
+    }
+
+    void LivenessMonitor::OnReceive(Clock::time_point now, bool keepAlive)
+    {
+        _metrics.longestSilence = std::max(_metrics.longestSilence, now - _lastReceive);
+        _lastReceive = now;
+        _probed = false;
+
+        if (!keepAlive) return;
+
+        _metrics.keepAlives++;
+        if (_haveKeepAlive)
+        {
+            Duration gap = std::clamp(now - _lastKeepAlive, _options.minInterval, _options.maxInterval);
+            if (!_metrics.learned)
+            {
+                _metrics.interval = gap;
+                _metrics.learned = true;
+            }
+            else
+            {
+                double smoothed = static_cast<double>(_metrics.interval.count()) * (1.0 - _options.smoothing) +
+                                  static_cast<double>(gap.count()) * _options.smoothing;
+                _metrics.interval = Duration(static_cast<Duration::rep>(smoothed));
+            }
+        }
+        _lastKeepAlive = now;
+        _haveKeepAlive = true;
+    }
+
+    LivenessMonitor::Verdict LivenessMonitor::Check(Clock::time_point now)
+    {
+        Duration silence = now - _lastReceive;
+        if (silence >= DeadAfter())
+            return Verdict::Dead;
+
+        if (_options.probe && !_probed && silence >= _metrics.interval * _options.probeAfter)
+        {
+            _probed = true;
+            _metrics.probes++;
+            return Verdict::Probe;
+        }
+        return Verdict::Alive;
+    }
+
+    LivenessMonitor::Clock::time_point LivenessMonitor::NextCheck() const
+    {
+        Clock::time_point dead = _lastReceive + DeadAfter();
+        if (_options.probe && !_probed)
+        {
+            auto probeAt = _lastReceive + std::chrono::duration_cast<Duration>(_metrics.interval * _options.probeAfter);
+            return std::min(probeAt, dead);
+        }
+        return dead;
+    }
+
+    LivenessMonitor::Duration LivenessMonitor::DeadAfter() const
+    {
+        return _metrics.interval * _options.missedIntervals;
+    }
+
+    LivenessMonitor::Duration LivenessMonitor::Interval() const
+    {
+        return _metrics.interval;
+    }
+
+    LivenessMonitor::Metrics LivenessMonitor::GetMetrics() const
+    {
+        return _metrics;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+// LivenessMonitor.h
+// Dead-peer detection from the robot's KeepAliveRequest cadence.
+// The interval between KeepAliveRequests is learned (smoothed); the peer is declared dead
+// when nothing at all was received for missedIntervals of it. One probe (a request the
+// robot has to answer) may be sent when a KeepAlive is overdue, before giving up.
+// Time is passed in by the caller. Not thread-safe: use it from the receive thread.
+// Only depends on the standard library.
+
+#include <chrono>
+#include <cstdint>
+
+namespace RowaPickupSlim
+{
+    class LivenessMonitor
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Duration = Clock::duration;
+
+        struct Options
+        {
+            uint32_t missedIntervals = 3;       // Silence of this many intervals means dead
+            Duration initialInterval = std::chrono::seconds(40);    // Until two KeepAlives were seen
+            Duration minInterval = std::chrono::seconds(1);     // Learned interval is clamped to [min, max]
+            Duration maxInterval = std::chrono::seconds(60);
+            double smoothing = 0.25;            // Weight of the newest KeepAlive gap
+            bool probe = true;                  // Send a probe once a KeepAlive is overdue
+            double probeAfter = 1.5;            // ... after this many intervals of silence
+        };
+
+        enum class Verdict
+        {
+            Alive,
+            Probe,      // Send a probe now (reported once per silence)
+            Dead
+        };
+
+        struct Metrics
+        {
+            uint64_t keepAlives = 0;
+            uint64_t probes = 0;
+            bool learned = false;               // interval comes from observed KeepAlives
+            Duration interval{};
+            Duration longestSilence{};
+        };
+
+        LivenessMonitor();
+        explicit LivenessMonitor(const Options& options);
+
+        /// Connection (re)started: forget the silence, keep the learned interval
+        void Reset(Clock::time_point now);
+
+        /// Any data received; keepAlive when it was a KeepAliveRequest
+        void OnReceive(Clock::time_point now, bool keepAlive);
+
+        /// Evaluate at now (call at NextCheck())
+        Verdict Check(Clock::time_point now);
+
+        /// When Check() has to run next
+        Clock::time_point NextCheck() const;
+
+        /// Silence after which the peer is declared dead
+        Duration DeadAfter() const;
+
+        Duration Interval() const;
+
+        Metrics GetMetrics() const;
+
+    private:
+        Options _options;
+        Clock::time_point _lastReceive{};
+        Clock::time_point _lastKeepAlive{};
+        bool _haveKeepAlive = false;
+        bool _probed = false;               // Probe sent during the current silence
+        Metrics _metrics;
+    };
+}
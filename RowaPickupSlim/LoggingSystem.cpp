@@ -2,6 +2,7 @@
 // Logging system implementation
 
 #include "LoggingSystem.h"
+#include "AsyncLogger.h"
 #include <fstream>
 #include <iostream>
 #include <windows.h>
@@ -16,6 +17,10 @@ namespace RowaPickupSlim::LoggingSystem
     static std::string g_logDirectory;
     static bool g_initialized = false;
 
+    // Bounded ring of 8192 records; when full, records are dropped (and counted) rather than
+    // blocking network or UI threads. Its destructor writes whatever is still queued.
+    static AsyncLogger g_logger(8192, AsyncLogger::OverflowPolicy::Drop);
+
     void Initialize()
     {
         if (g_initialized) return;
@@ -42,6 +47,10 @@ namespace RowaPickupSlim::LoggingSystem
             
             g_logFilePath = filename.str();
             g_initialized = true;
+
+            // Debug output is written per batch on the logger thread
+            g_logger.BatchWritten = [](const std::string& batch) { OutputDebugStringA(batch.c_str()); };
+            g_logger.Open(g_logFilePath);
         }
     }
 
@@ -49,28 +58,31 @@ namespace RowaPickupSlim::LoggingSystem
     {
         if (!g_initialized) return;
 
-        // Get current timestamp
-        auto now = std::chrono::system_clock::now();
-        auto time = std::chrono::system_clock::to_time_t(now);
-        std::tm tm{};
-        localtime_s(&tm, &time);
+        // Normal path: queue for the background writer (dropped if the queue is full)
+        if (g_logger.Push(message) || g_logger.IsRunning()) return;
 
-        std::ostringstream formattedMessage;
-        formattedMessage << "["
-                        << std::put_time(&tm, "%H:%M:%S")
-                        << "] "
-                        << message;
+        // Logger not running (file could not be opened, or after Shutdown): write synchronously
+        std::string formattedMessage;
+        AsyncLogger::FormatLine(formattedMessage, std::chrono::system_clock::now(), message);
 
-        // Write to file
         std::ofstream logFile(g_logFilePath, std::ios::app);
         if (logFile.is_open())
         {
-            logFile << formattedMessage.str() << std::endl;
+            logFile << formattedMessage;
             logFile.close();
         }
 
-        // Also write to debug output
-        OutputDebugStringA((formattedMessage.str() + "\n").c_str());
+        OutputDebugStringA(formattedMessage.c_str());
+    }
+
+    void Flush()
+    {
+        g_logger.Flush();
+    }
+
+    void Shutdown()
+    {
+        g_logger.Stop();
     }
 
     void CleanupOldLogFiles()
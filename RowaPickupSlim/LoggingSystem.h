@@ -13,10 +13,19 @@ namespace RowaPickupSlim::LoggingSystem
     void Initialize();
 
     /// Write a message to both the debug window and log file
-    /// Message is automatically timestamped
+    /// Message is automatically timestamped; the file write happens on a background thread
     /// Reusable: Yes - standard logging function
     void LogMessage(const std::string& message);
 
+    /// Block until every message logged so far is written to the log file
+    /// Reusable: Yes - standard flush pattern
+    void Flush();
+
+    /// Write all pending messages and close the log file - call this once at app exit
+    /// Messages logged afterwards are written synchronously
+    /// Reusable: Yes - standard shutdown pattern
+    void Shutdown();
+
     /// Clean up log files older than 31 days
     /// Call this periodically to prevent log directory from growing too large
     /// Reusable: Yes - standard cleanup pattern
@@ -0,0 +1,269 @@
+// LoopbackTransport.cpp
+// In-memory transport pair implementation
+
+#include "LoopbackTransport.h"
+#include "Reactor.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace RowaPickupSlim
+{
+    const int LoopbackTransport::RESET_ERROR = ECONNRESET;
+
+    std::pair<std::unique_ptr<LoopbackTransport>, std::unique_ptr<LoopbackTransport>> LoopbackTransport::CreatePair()
+    {
+        return CreatePair(Options(), Options());
+    }
+
+    std::pair<std::unique_ptr<LoopbackTransport>, std::unique_ptr<LoopbackTransport>> LoopbackTransport::CreatePair(
+        const Options& aReceives, const Options& bReceives)
+    {
+        auto toA = std::make_shared<Pipe>();
+        toA->options = aReceives;
+        toA->random.seed(aReceives.seed);
+        auto toB = std::make_shared<Pipe>();
+        toB->options = bReceives;
+        toB->random.seed(bReceives.seed);
+
+        std::unique_ptr<LoopbackTransport> a(new LoopbackTransport(toA, toB, "loopback a"));
+        std::unique_ptr<LoopbackTransport> b(new LoopbackTransport(toB, toA, "loopback b"));
+        return { std::move(a), std::move(b) };
+    }
+
+    LoopbackTransport::LoopbackTransport(std::shared_ptr<Pipe> in, std::shared_ptr<Pipe> out, std::string name)
+        : _in(std::move(in)), _out(std::move(out)), _name(std::move(name))
+    {
+    }
+
+    LoopbackTransport::~LoopbackTransport()
+    {
+        Shutdown();
+        std::lock_guard<std::mutex> lock(_in->mtx);
+        _in->reactor = nullptr;
+    }
+
+    bool LoopbackTransport::Start(Reactor& reactor, Receiver receiver)
+    {
+        std::lock_guard<std::mutex> lock(_in->mtx);
+        _in->reactor = &reactor;
+        _in->receiver = std::move(receiver);
+        _in->paused = false;
+        ScheduleLocked(_in);        // Whatever was written before Start()
+        return true;
+    }
+
+    void LoopbackTransport::Stop()
+    {
+        // The receiver itself is kept: Stop() may be called from inside one of its callbacks
+        std::lock_guard<std::mutex> lock(_in->mtx);
+        _in->reactor = nullptr;
+    }
+
+    void LoopbackTransport::PauseReceive(bool paused)
+    {
+        std::lock_guard<std::mutex> lock(_in->mtx);
+        _in->paused = paused;
+        if (!paused)
+            ScheduleLocked(_in);
+    }
+
+    bool LoopbackTransport::Write(const Buffer* buffers, size_t count, size_t& written, int& error)
+    {
+        written = 0;
+        bool reset = false;
+        {
+            std::unique_lock<std::mutex> lock(_out->mtx);
+            Pipe& pipe = *_out;
+            pipe.space.wait(lock, [&pipe]() { return pipe.closed || pipe.pending < pipe.options.capacity; });
+            if (pipe.closed)
+            {
+                error = pipe.closeError != 0 ? pipe.closeError : EPIPE;
+                return false;
+            }
+
+            size_t total = 0;
+            for (size_t i = 0; i < count; i++)
+                total += buffers[i].size;
+
+            // Injected reset: accept the bytes up to the limit, then drop the connection
+            size_t allowed = total;
+            if (pipe.options.resetAfterBytes > 0)
+            {
+                uint64_t remaining = pipe.options.resetAfterBytes > pipe.written ? pipe.options.resetAfterBytes - pipe.written : 0;
+                if (total >= remaining)
+                {
+                    allowed = static_cast<size_t>(remaining);
+                    reset = true;
+                }
+            }
+
+            Clock::time_point due = Clock::now() + pipe.options.latency;
+            size_t buffer = 0, offset = 0, left = allowed;
+            while (left > 0)
+            {
+                size_t size = left;
+                if (pipe.options.maxChunk > 0)
+                {
+                    size_t low = std::max<size_t>(1, std::min(pipe.options.minChunk, pipe.options.maxChunk));
+                    std::uniform_int_distribution<size_t> pick(low, pipe.options.maxChunk);
+                    size = std::min(left, pick(pipe.random));
+                }
+
+                Chunk chunk;
+                chunk.due = due;
+                chunk.data.reserve(size);
+                while (chunk.data.size() < size)
+                {
+                    size_t take = std::min(size - chunk.data.size(), buffers[buffer].size - offset);
+                    chunk.data.append(buffers[buffer].data + offset, take);
+                    offset += take;
+                    if (offset == buffers[buffer].size)
+                    {
+                        buffer++;
+                        offset = 0;
+                    }
+                }
+                pipe.chunks.push_back(std::move(chunk));
+                left -= size;
+            }
+
+            pipe.pending += allowed;
+            pipe.written += allowed;
+            written = allowed;
+            if (allowed > 0)
+                ScheduleLocked(_out);
+        }
+
+        if (reset)
+        {
+            Reset();
+            if (written == 0)
+            {
+                error = RESET_ERROR;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void LoopbackTransport::Shutdown()
+    {
+        Close(_out, 0, false);      // The peer still receives what was written, then sees the close
+        Close(_in, 0, true);
+    }
+
+    void LoopbackTransport::Reset()
+    {
+        Close(_out, RESET_ERROR, true);
+        Close(_in, RESET_ERROR, true);
+    }
+
+    std::string LoopbackTransport::Describe() const
+    {
+        return _name;
+    }
+
+    uint64_t LoopbackTransport::BytesWritten() const
+    {
+        std::lock_guard<std::mutex> lock(_out->mtx);
+        return _out->written;
+    }
+
+    uint64_t LoopbackTransport::BytesReceived() const
+    {
+        std::lock_guard<std::mutex> lock(_in->mtx);
+        return _in->delivered;
+    }
+
+    void LoopbackTransport::Close(const std::shared_ptr<Pipe>& pipe, int error, bool dropPending)
+    {
+        std::lock_guard<std::mutex> lock(pipe->mtx);
+        if (!pipe->closed)
+        {
+            pipe->closed = true;
+            pipe->closeError = error;
+        }
+        if (dropPending)
+        {
+            pipe->chunks.clear();
+            pipe->pending = 0;
+        }
+        pipe->space.notify_all();
+        ScheduleLocked(pipe);
+    }
+
+    // Get the receiving reactor to run Deliver (pipe->mtx held)
+    void LoopbackTransport::ScheduleLocked(const std::shared_ptr<Pipe>& pipe)
+    {
+        if (pipe->reactor == nullptr || pipe->deliverPosted) return;
+        pipe->deliverPosted = true;
+        pipe->reactor->Post([pipe]() {
+            {
+                std::lock_guard<std::mutex> lock(pipe->mtx);
+                pipe->deliverPosted = false;
+            }
+            Deliver(pipe);
+        });
+    }
+
+    // Runs on the receiving reactor thread; the receiver is called without the lock
+    void LoopbackTransport::Deliver(const std::shared_ptr<Pipe>& pipe)
+    {
+        Pipe& p = *pipe;
+        for (;;)
+        {
+            Chunk chunk;
+            bool closed = false;
+            int error = 0;
+            {
+                std::lock_guard<std::mutex> lock(p.mtx);
+                if (p.reactor == nullptr || p.paused) return;
+
+                if (p.chunks.empty())
+                {
+                    if (!p.closed || p.closeDelivered) return;
+                    p.closeDelivered = true;
+                    p.reactor = nullptr;        // Nothing more will arrive
+                    closed = true;
+                    error = p.closeError;
+                }
+                else
+                {
+                    Clock::time_point now = Clock::now();
+                    if (p.chunks.front().due > now)
+                    {
+                        if (!p.timerArmed)
+                        {
+                            p.timerArmed = true;
+                            p.reactor->AddTimer(p.chunks.front().due - now, [pipe]() {
+                                {
+                                    std::lock_guard<std::mutex> timerLock(pipe->mtx);
+                                    pipe->timerArmed = false;
+                                }
+                                Deliver(pipe);
+                            });
+                        }
+                        return;
+                    }
+
+                    chunk = std::move(p.chunks.front());
+                    p.chunks.pop_front();
+                    p.pending -= chunk.data.size();
+                    p.delivered += chunk.data.size();
+                    p.space.notify_all();
+                }
+            }
+
+            if (closed)
+            {
+                if (p.receiver.Closed) p.receiver.Closed(error);
+                return;
+            }
+
+            char* buffer = p.receiver.Prepare(chunk.data.size());
+            std::memcpy(buffer, chunk.data.data(), chunk.data.size());
+            p.receiver.Commit(chunk.data.size());
+        }
+    }
+}
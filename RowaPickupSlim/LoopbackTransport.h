@@ -0,0 +1,102 @@
+#pragma once
+// LoopbackTransport.h
+// In-memory Transport pair for tests and benchmarks: what one end writes, the other end
+// receives on its reactor thread. Faults can be injected per direction: received data is
+// re-chunked into random sizes, delivered after a fixed latency, and the connection can be
+// reset after a byte count or on demand.
+// Only depends on the standard library.
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <utility>
+#include "Transport.h"
+
+namespace RowaPickupSlim
+{
+    class LoopbackTransport : public Transport
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// Applies to the data one end receives
+        struct Options
+        {
+            size_t minChunk = 0;                // Deliver in chunks of [minChunk, maxChunk] bytes;
+            size_t maxChunk = 0;                // 0 = as written
+            Clock::duration latency{};          // Write() -> delivery
+            size_t capacity = 4 * 1024 * 1024;  // Undelivered bytes before the writer blocks
+            uint64_t resetAfterBytes = 0;       // Reset the connection once this many bytes were written (0 = never)
+            uint32_t seed = 1;                  // Chunk sizes
+        };
+
+        /// Error reported for an injected reset (ECONNRESET)
+        static const int RESET_ERROR;
+
+        /// A connected pair; first receives with aReceives, second with bReceives
+        static std::pair<std::unique_ptr<LoopbackTransport>, std::unique_ptr<LoopbackTransport>> CreatePair();
+        static std::pair<std::unique_ptr<LoopbackTransport>, std::unique_ptr<LoopbackTransport>> CreatePair(
+            const Options& aReceives, const Options& bReceives);
+
+        ~LoopbackTransport() override;
+
+        bool Start(Reactor& reactor, Receiver receiver) override;
+        void Stop() override;
+        void PauseReceive(bool paused) override;
+        bool Write(const Buffer* buffers, size_t count, size_t& written, int& error) override;
+        void Shutdown() override;
+        std::string Describe() const override;
+
+        /// Reset the connection now: undelivered data is dropped, both ends see Closed(RESET_ERROR)
+        void Reset();
+
+        /// Bytes this end has written / received
+        uint64_t BytesWritten() const;
+        uint64_t BytesReceived() const;
+
+    private:
+        struct Chunk
+        {
+            std::string data;
+            Clock::time_point due;
+        };
+
+        // One direction of the connection
+        struct Pipe
+        {
+            std::mutex mtx;
+            std::condition_variable space;      // Writer waits for the reader to catch up
+            Options options;
+            std::mt19937 random;
+            std::deque<Chunk> chunks;
+            size_t pending = 0;                 // Bytes in chunks
+            uint64_t written = 0;
+            uint64_t delivered = 0;
+            bool closed = false;
+            int closeError = 0;
+            bool closeDelivered = false;
+
+            // Receiving end, set between Start() and Stop()
+            Reactor* reactor = nullptr;
+            Receiver receiver;
+            bool deliverPosted = false;
+            bool paused = false;                // PauseReceive(): chunks (and the close) wait
+            bool timerArmed = false;
+        };
+
+        LoopbackTransport(std::shared_ptr<Pipe> in, std::shared_ptr<Pipe> out, std::string name);
+
+        static void Close(const std::shared_ptr<Pipe>& pipe, int error, bool dropPending);
+        static void ScheduleLocked(const std::shared_ptr<Pipe>& pipe);
+        static void Deliver(const std::shared_ptr<Pipe>& pipe);
+
+        std::shared_ptr<Pipe> _in;
+        std::shared_ptr<Pipe> _out;
+        std::string _name;
+    };
+}
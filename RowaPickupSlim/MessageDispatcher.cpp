@@ -0,0 +1,168 @@
+// MessageDispatcher.cpp
+// Bounded, per-key ordered dispatch queue implementation
+
+#include "MessageDispatcher.h"
+
+namespace RowaPickupSlim
+{
+    // Raise an atomic maximum without taking a lock
+    template <typename T>
+    static void UpdateMax(std::atomic<T>& target, T value)
+    {
+        T current = target.load(std::memory_order_relaxed);
+        while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    MessageDispatcher::MessageDispatcher(size_t laneCount, size_t capacityPerLane)
+        : _capacityPerLane(capacityPerLane > 0 ? capacityPerLane : 1), _stopping(false),
+          _depth(0), _maxDepth(0), _enqueued(0), _dispatched(0), _blockedPushes(0), _refusedPushes(0),
+          _totalWaitMicros(0), _maxWaitMicros(0)
+    {
+        if (laneCount == 0) laneCount = 1;
+        _lanes.reserve(laneCount);
+        for (size_t i = 0; i < laneCount; i++)
+            _lanes.push_back(std::make_unique<Lane>());
+
+        for (auto& lane : _lanes)
+        {
+            Lane* l = lane.get();
+            l->worker = std::thread([this, l]() { WorkerLoop(*l); });
+        }
+    }
+
+    MessageDispatcher::~MessageDispatcher()
+    {
+        Stop();
+    }
+
+    bool MessageDispatcher::Dispatch(std::string_view orderingKey, std::function<void()> work)
+    {
+        if (!work) return false;
+
+        Lane& lane = *_lanes[LaneOf(orderingKey)];
+
+        {
+            std::unique_lock<std::mutex> lk(lane.mtx);
+            if (lane.items.size() >= _capacityPerLane && !_stopping.load())
+            {
+                // Backpressure: the receive thread waits here instead of queuing without bound
+                _blockedPushes.fetch_add(1, std::memory_order_relaxed);
+                lane.notFull.wait(lk, [&]() { return lane.items.size() < _capacityPerLane || _stopping.load(); });
+            }
+            if (_stopping.load()) return false;
+
+            lane.items.push_back(Item{ std::move(work), std::chrono::steady_clock::now() });
+            _enqueued.fetch_add(1, std::memory_order_relaxed);
+            UpdateMax(_maxDepth, _depth.fetch_add(1, std::memory_order_relaxed) + 1);
+        }
+        lane.notEmpty.notify_one();
+        return true;
+    }
+
+    bool MessageDispatcher::TryDispatch(std::string_view orderingKey, std::function<void()>& work)
+    {
+        if (!work) return false;
+
+        Lane& lane = *_lanes[LaneOf(orderingKey)];
+
+        {
+            std::lock_guard<std::mutex> lk(lane.mtx);
+            if (_stopping.load()) return false;
+            if (lane.items.size() >= _capacityPerLane)
+            {
+                _refusedPushes.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            lane.items.push_back(Item{ std::move(work), std::chrono::steady_clock::now() });
+            _enqueued.fetch_add(1, std::memory_order_relaxed);
+            UpdateMax(_maxDepth, _depth.fetch_add(1, std::memory_order_relaxed) + 1);
+        }
+        lane.notEmpty.notify_one();
+        return true;
+    }
+
+    size_t MessageDispatcher::LaneOf(std::string_view orderingKey) const
+    {
+        if (_lanes.size() < 2 || orderingKey.empty()) return 0;
+        return std::hash<std::string_view>{}(orderingKey) % _lanes.size();
+    }
+
+    bool MessageDispatcher::Stop()
+    {
+        for (auto& lane : _lanes)
+        {
+            if (lane->worker.get_id() == std::this_thread::get_id()) return false;
+        }
+        if (_stopping.exchange(true)) return true;
+
+        for (auto& lane : _lanes)
+        {
+            {
+                std::lock_guard<std::mutex> lk(lane->mtx);
+            }
+            lane->notEmpty.notify_all();
+            lane->notFull.notify_all();
+        }
+        for (auto& lane : _lanes)
+        {
+            if (lane->worker.joinable())
+                lane->worker.join();
+        }
+        return true;
+    }
+
+    MessageDispatcher::Counters MessageDispatcher::GetCounters() const
+    {
+        Counters c;
+        c.depth = _depth.load(std::memory_order_relaxed);
+        c.maxDepth = _maxDepth.load(std::memory_order_relaxed);
+        c.enqueued = _enqueued.load(std::memory_order_relaxed);
+        c.dispatched = _dispatched.load(std::memory_order_relaxed);
+        c.blockedPushes = _blockedPushes.load(std::memory_order_relaxed);
+        c.refusedPushes = _refusedPushes.load(std::memory_order_relaxed);
+        c.totalWaitMicros = _totalWaitMicros.load(std::memory_order_relaxed);
+        c.maxWaitMicros = _maxWaitMicros.load(std::memory_order_relaxed);
+        return c;
+    }
+
+    void MessageDispatcher::WorkerLoop(Lane& lane)
+    {
+        for (;;)
+        {
+            Item item;
+            bool wasFull;
+            {
+                std::unique_lock<std::mutex> lk(lane.mtx);
+                lane.notEmpty.wait(lk, [&]() { return !lane.items.empty() || _stopping.load(); });
+
+                // Drain remaining work before honouring Stop() so no message is lost
+                if (lane.items.empty()) return;
+
+                wasFull = lane.items.size() >= _capacityPerLane;
+                item = std::move(lane.items.front());
+                lane.items.pop_front();
+            }
+            lane.notFull.notify_one();
+            if (wasFull && SpaceAvailable) SpaceAvailable();
+            _depth.fetch_sub(1, std::memory_order_relaxed);
+
+            auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - item.enqueuedAt).count();
+            _totalWaitMicros.fetch_add(static_cast<uint64_t>(waited), std::memory_order_relaxed);
+            UpdateMax(_maxWaitMicros, static_cast<uint64_t>(waited));
+
+            try
+            {
+                item.work();
+            }
+            catch (...)
+            {
+                // A failing handler must not take the lane down
+            }
+            _dispatched.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+// MessageDispatcher.h
+// Bounded work queue with a fixed number of worker lanes.
+// Work items with the same ordering key always run on the same lane, in submission order.
+// Only depends on the standard library.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace RowaPickupSlim
+{
+    class MessageDispatcher
+    {
+    public:
+        /// Snapshot of the dispatcher counters
+        struct Counters
+        {
+            size_t depth = 0;               // Items currently queued (all lanes)
+            size_t maxDepth = 0;            // Highest depth observed
+            uint64_t enqueued = 0;          // Items accepted
+            uint64_t dispatched = 0;        // Items executed
+            uint64_t blockedPushes = 0;     // Dispatch() calls that had to wait for space (backpressure)
+            uint64_t refusedPushes = 0;     // TryDispatch() calls refused because the lane was full
+            uint64_t totalWaitMicros = 0;   // Sum of queue wait times (enqueue -> start of execution)
+            uint64_t maxWaitMicros = 0;     // Longest queue wait time
+        };
+
+        /// @param laneCount Number of worker threads; 1 gives strict global ordering
+        /// @param capacityPerLane Maximum queued items per lane before Dispatch() blocks
+        explicit MessageDispatcher(size_t laneCount = 1, size_t capacityPerLane = 256);
+        ~MessageDispatcher();
+
+        /// Queue work on the lane selected by orderingKey (empty key -> lane 0).
+        /// Blocks while that lane is full.
+        /// @return false if the dispatcher is stopping and the work was not queued
+        bool Dispatch(std::string_view orderingKey, std::function<void()> work);
+
+        /// Queue work without waiting, for a thread that must not block (an event loop).
+        /// @return false if the lane is full or the dispatcher is stopping; work is left untouched
+        ///         then, try again after SpaceAvailable
+        bool TryDispatch(std::string_view orderingKey, std::function<void()>& work);
+
+        /// Called on a worker thread when a lane that was full took an item.
+        /// Set it before the first dispatch; it must not block.
+        std::function<void()> SpaceAvailable;
+
+        /// Run all queued work, then stop and join the worker threads.
+        /// @return false if called from a work item (it cannot join its own thread); nothing is stopped.
+        ///         The destructor stops too, so the dispatcher must not be destroyed from a work item.
+        bool Stop();
+
+        Counters GetCounters() const;
+
+        size_t GetLaneCount() const { return _lanes.size(); }
+
+        /// Lane that runs the work queued with this ordering key (0 .. GetLaneCount() - 1)
+        size_t LaneOf(std::string_view orderingKey) const;
+
+    private:
+        struct Item
+        {
+            std::function<void()> work;
+            std::chrono::steady_clock::time_point enqueuedAt;
+        };
+
+        struct Lane
+        {
+            std::mutex mtx;
+            std::condition_variable notEmpty;
+            std::condition_variable notFull;
+            std::deque<Item> items;
+            std::thread worker;
+        };
+
+        void WorkerLoop(Lane& lane);
+
+        std::vector<std::unique_ptr<Lane>> _lanes;
+        size_t _capacityPerLane;
+        std::atomic<bool> _stopping;
+
+        std::atomic<size_t> _depth;
+        std::atomic<size_t> _maxDepth;
+        std::atomic<uint64_t> _enqueued;
+        std::atomic<uint64_t> _dispatched;
+        std::atomic<uint64_t> _blockedPushes;
+        std::atomic<uint64_t> _refusedPushes;
+        std::atomic<uint64_t> _totalWaitMicros;
+        std::atomic<uint64_t> _maxWaitMicros;
+
+        // non-copyable
+        MessageDispatcher(const MessageDispatcher&) = delete;
+        MessageDispatcher& operator=(const MessageDispatcher&) = delete;
+    };
+}
@@ -0,0 +1,98 @@
+// OrderTable.cpp
+// Indexed output order table implementation
+
+#include "OrderTable.h"
+#include <algorithm>
+
+namespace RowaPickupSlim
+{
+    OutputStatus ParseOutputStatus(std::string_view status)
+    {
+        if (status == "Queued") return OutputStatus::Queued;
+        if (status == "InProcess") return OutputStatus::InProcess;
+        if (status == "Completed") return OutputStatus::Completed;
+        if (status == "Rejected") return OutputStatus::Rejected;
+        if (status == "Incomplete") return OutputStatus::Incomplete;
+        return OutputStatus::Other;
+    }
+
+    void OrderTable::SetOrder(const OutputRecord& record)
+    {
+        auto it = _byOrderId.find(record.orderId);
+        if (it != _byOrderId.end())
+        {
+            OutputRecord& existing = _records[it->second];
+            existing.quantityRequested = record.quantityRequested;
+            existing.packsDelivered = record.packsDelivered;
+            existing.status = record.status;
+            existing.isOurOutput = record.isOurOutput;
+            return;
+        }
+
+        uint32_t slot;
+        if (!_freeSlots.empty())
+        {
+            slot = _freeSlots.back();
+            _freeSlots.pop_back();
+            _records[slot] = record;
+        }
+        else
+        {
+            slot = static_cast<uint32_t>(_records.size());
+            _records.push_back(record);
+        }
+
+        _byOrderId.emplace(record.orderId, slot);
+        if (!record.articleId.empty())
+            _byArticle[record.articleId].push_back(slot);
+    }
+
+    bool OrderTable::RemoveOrder(const std::string& orderId)
+    {
+        auto it = _byOrderId.find(orderId);
+        if (it == _byOrderId.end()) return false;
+
+        uint32_t slot = it->second;
+        _byOrderId.erase(it);
+
+        OutputRecord& record = _records[slot];
+        auto art = _byArticle.find(record.articleId);
+        if (art != _byArticle.end())
+        {
+            // Usually one or two orders per article; erase keeps the oldest-first order
+            std::vector<uint32_t>& slots = art->second;
+            slots.erase(std::find(slots.begin(), slots.end(), slot));
+            if (slots.empty()) _byArticle.erase(art);
+        }
+
+        record = OutputRecord();
+        _freeSlots.push_back(slot);
+        return true;
+    }
+
+    const OutputRecord* OrderTable::FindOrder(const std::string& orderId) const
+    {
+        auto it = _byOrderId.find(orderId);
+        return (it != _byOrderId.end()) ? &_records[it->second] : nullptr;
+    }
+
+    const OutputRecord* OrderTable::FindArticleDisplay(const std::string& articleId, size_t* activeOrders) const
+    {
+        auto it = _byArticle.find(articleId);
+        if (it == _byArticle.end())
+        {
+            if (activeOrders) *activeOrders = 0;
+            return nullptr;
+        }
+        if (activeOrders) *activeOrders = it->second.size();
+        return &_records[it->second.front()];
+    }
+
+    void OrderTable::Clear()
+    {
+        _records.clear();
+        _freeSlots.clear();
+        _byOrderId.clear();
+        _byArticle.clear();
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+// OrderTable.h
+// Active output orders, indexed by order ID and by article ID.
+// The article index gives the display entry for a list row in O(1), independent of the number of orders.
+// Only depends on the standard library.
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace RowaPickupSlim
+{
+    /// Order status as reported by OutputResponse / OutputMessage / TaskInfoResponse
+    enum class OutputStatus : uint8_t
+    {
+        Other,          // Any status without a dedicated display state
+        Queued,
+        InProcess,
+        Completed,
+        Rejected,
+        Incomplete
+    };
+
+    /// Map a WWKS status attribute value to OutputStatus (unknown values -> Other)
+    OutputStatus ParseOutputStatus(std::string_view status);
+
+    /// One output order (the old 6-tuple, with the display colour replaced by the status)
+    struct OutputRecord
+    {
+        std::string orderId;
+        std::string articleId;
+        int quantityRequested = 0;
+        int packsDelivered = 0;
+        OutputStatus status = OutputStatus::Queued;
+        bool isOurOutput = false;
+    };
+
+    class OrderTable
+    {
+    public:
+        /// Insert a new order, or update quantity, packs, status and ownership of an existing one.
+        /// The article of an existing order is kept.
+        void SetOrder(const OutputRecord& record);
+
+        /// @return false if the order was not in the table
+        bool RemoveOrder(const std::string& orderId);
+
+        /// @return The order, or nullptr. Valid until the table is modified.
+        const OutputRecord* FindOrder(const std::string& orderId) const;
+
+        /// Display entry for an article row: the oldest active order of that article.
+        /// @param activeOrders Optional, receives the number of active orders for the article
+        /// @return The order to display, or nullptr if the article has no active order. Valid until the table is modified.
+        const OutputRecord* FindArticleDisplay(const std::string& articleId, size_t* activeOrders = nullptr) const;
+
+        size_t Size() const { return _byOrderId.size(); }
+        void Clear();
+
+    private:
+        std::vector<OutputRecord> _records;                                     // Slots; freed slots are reused
+        std::vector<uint32_t> _freeSlots;
+        std::unordered_map<std::string, uint32_t> _byOrderId;                   // Order ID -> slot
+        std::unordered_map<std::string, std::vector<uint32_t>> _byArticle;      // Article ID -> slots, oldest first
+    };
+}
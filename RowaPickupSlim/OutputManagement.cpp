@@ -9,6 +9,9 @@
 //   - SendOutputRequestForArticle() - Send individual article output request
 //   - SendOutputRequestForAllArticles() - Send batch output requests
 //
+// Output records live in an OrderTable (OrderTable.h): a hash index by order ID
+// plus a per-article index giving the row display order in O(1).
+//
 // This file remains in the project for reference/documentation purposes only.
 // Remove from .vcxproj.filters ClCompile section to prevent compilation.
 
@@ -20,14 +20,14 @@ namespace RowaPickupSlim::OutputManagement
                                       const std::string& status, bool isOurOutput);
 
     /// Send an OutputRequest for a single article
-    /// Creates a unique request ID and tracks it in g_state.ourOutputRequestIds
-    /// Adds a local output record marked as Queued (Blue) for immediate UI feedback
+    /// Creates a unique request ID and adds a local output record for it, marked as Queued (Blue) and
+    /// as ours (isOurOutput) for immediate UI feedback; the record keeps the ownership until the order completes
     /// @param articleId The article to request
     /// @param qty The quantity requested
     void SendOutputRequestForArticle(const std::string& articleId, int qty);
 
     /// Send OutputRequest for all articles with quantities > 0
-    /// Sends individual requests for each article
+    /// Sends individual requests for each article; their records are published as one state version
     void SendOutputRequestForAllArticles();
 
 } // namespace RowaPickupSlim::OutputManagement
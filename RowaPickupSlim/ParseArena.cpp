@@ -0,0 +1,118 @@
+// ParseArena.cpp
+// Arena for pugixml documents implementation
+
+#include "ParseArena.h"
+#include <cstdlib>
+#include <new>
+#include "pugixml.hpp"
+
+namespace RowaPickupSlim
+{
+    static constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+
+    // Every pugixml allocation starts with the arena it came from (nullptr: malloc)
+    static constexpr size_t HEADER_SIZE = (sizeof(ParseArena*) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    static thread_local ParseArena* t_arena = nullptr;
+
+    static void* PugiAllocate(size_t size)
+    {
+        ParseArena* arena = t_arena;
+        void* raw = nullptr;
+        if (arena)
+        {
+            try { raw = arena->Allocate(HEADER_SIZE + size); } catch (const std::bad_alloc&) {}
+        }
+        else
+        {
+            raw = std::malloc(HEADER_SIZE + size);
+        }
+        if (!raw) return nullptr;
+
+        *static_cast<ParseArena**>(raw) = arena;
+        return static_cast<unsigned char*>(raw) + HEADER_SIZE;
+    }
+
+    static void PugiDeallocate(void* ptr)
+    {
+        if (!ptr) return;
+
+        // Arena memory is released by ParseArena::Reset()
+        void* raw = static_cast<unsigned char*>(ptr) - HEADER_SIZE;
+        if (*static_cast<ParseArena**>(raw) == nullptr)
+            std::free(raw);
+    }
+
+    // Installed before main(), so no block pugixml allocated without a header can reach PugiDeallocate
+    static struct PugiHooks
+    {
+        PugiHooks() { pugi::set_memory_management_functions(PugiAllocate, PugiDeallocate); }
+    } s_pugiHooks;
+
+    // ========================================================================
+    // ParseArena
+    // ========================================================================
+
+    ParseArena::Scope::Scope(ParseArena& arena)
+        : _previous(t_arena)
+    {
+        t_arena = &arena;
+    }
+
+    ParseArena::Scope::~Scope()
+    {
+        t_arena = _previous;
+    }
+
+    ParseArena::ParseArena(size_t blockSize)
+        : _blockSize(blockSize < 4096 ? 4096 : blockSize)
+    {
+    }
+
+    void* ParseArena::Allocate(size_t size)
+    {
+        size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+        if (_blocks.empty() || _used + size > _blocks.back().size)
+            AddBlock(size > _blockSize ? size : _blockSize);
+
+        void* p = _blocks.back().data.get() + _used;
+        _used += size;
+        _inUse += size;
+        if (_inUse > _counters.highWater) _counters.highWater = _inUse;
+        return p;
+    }
+
+    void ParseArena::Reset()
+    {
+        // The message overflowed the first block: replace all blocks by one that holds the largest
+        // message so far (the tails the overflow left unused are not carried over)
+        if (_blocks.size() > 1)
+        {
+            _blocks.clear();
+            _counters.capacity = 0;
+            AddBlock(_counters.highWater > _blockSize ? _counters.highWater : _blockSize);
+        }
+
+        _used = 0;
+        _inUse = 0;
+        _counters.resets++;
+    }
+
+    ParseArena::Counters ParseArena::GetCounters() const
+    {
+        return _counters;
+    }
+
+    void ParseArena::AddBlock(size_t size)
+    {
+        Block block;
+        block.data.reset(new unsigned char[size]);
+        block.size = size;
+        _blocks.push_back(std::move(block));
+
+        _used = 0;
+        _counters.blocksAdded++;
+        _counters.capacity += size;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+// ParseArena.h
+// Bump allocator for the pugixml DOM of received messages.
+// While a ParseArena::Scope is active on a thread, every pugixml allocation made by that thread
+// (document pages, copied buffers, long strings) is taken from the arena; freeing it is a no-op and
+// Reset() releases everything at once. The memory is kept, so once the arena has grown to the
+// largest message, parsing does not touch the heap. Outside a scope pugixml uses malloc / free as
+// before; each allocation carries a small header that tells the two apart, so a document may be
+// reset or destroyed on any thread (as long as its arena is still alive).
+// The pugixml hooks are installed during static initialization, before any document allocates.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace RowaPickupSlim
+{
+    class ParseArena
+    {
+    public:
+        /// Snapshot of the arena counters
+        struct Counters
+        {
+            uint64_t resets = 0;            // Reset() calls
+            uint64_t blocksAdded = 0;       // Blocks taken from the heap (growth); constant in steady state
+            size_t capacity = 0;            // Bytes currently owned
+            size_t highWater = 0;           // Most bytes in use between two resets
+        };
+
+        /// Routes the pugixml allocations of the calling thread to an arena while it exists (nests)
+        class Scope
+        {
+        public:
+            explicit Scope(ParseArena& arena);
+            ~Scope();
+
+        private:
+            ParseArena* _previous;
+
+            // non-copyable
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+        };
+
+        /// @param blockSize Size of the first block; larger requests get a block of their own size
+        explicit ParseArena(size_t blockSize = 64 * 1024);
+
+        /// Memory aligned for any type; valid until the next Reset()
+        void* Allocate(size_t size);
+
+        /// Release all allocations. After an overflow into extra blocks they are merged into one block
+        /// of the high-water size, so the next message of the same size fits without growing again.
+        void Reset();
+
+        /// Not synchronized: read it on the thread that uses the arena
+        Counters GetCounters() const;
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<unsigned char[]> data;
+            size_t size = 0;
+        };
+
+        void AddBlock(size_t size);
+
+        size_t _blockSize;
+        std::vector<Block> _blocks;
+        size_t _used = 0;                   // Bytes used in _blocks.back()
+        size_t _inUse = 0;                  // Bytes used in all blocks since the last Reset()
+        Counters _counters;
+
+        // non-copyable
+        ParseArena(const ParseArena&) = delete;
+        ParseArena& operator=(const ParseArena&) = delete;
+    };
+}
@@ -0,0 +1,77 @@
+#pragma once
+// PersistentVector.h
+// Vector of fixed-size chunks that copies share. Copying a PersistentVector copies the chunk
+// pointers only; Set() on the copy clones the one chunk it touches (unless no other copy holds
+// it), so a new state version that changes a few entries costs O(size / ChunkSize + ChunkSize)
+// instead of a copy of every element. Chunks a published copy holds are never modified.
+// Single writer: only the thread that owns a copy may modify it. Only depends on the standard library.
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace RowaPickupSlim
+{
+    template <typename T, size_t ChunkSize = 1024>
+    class PersistentVector
+    {
+    public:
+        size_t Size() const { return _size; }
+        bool Empty() const { return _size == 0; }
+
+        const T& operator[](size_t index) const
+        {
+            return (*_chunks[index / ChunkSize])[index % ChunkSize];
+        }
+
+        /// Replace the entry at index (index < Size())
+        void Set(size_t index, T value)
+        {
+            Writable(index / ChunkSize)[index % ChunkSize] = std::move(value);
+        }
+
+        void PushBack(T value)
+        {
+            if (_size % ChunkSize == 0)
+            {
+                _chunks.push_back(std::make_shared<Chunk>());
+                _chunks.back()->reserve(ChunkSize);
+            }
+            Writable(_chunks.size() - 1).push_back(std::move(value));
+            _size++;
+        }
+
+        void Clear()
+        {
+            _chunks.clear();
+            _size = 0;
+        }
+
+        /// Number of chunks this copy shares with other copies (for tests and benchmarks)
+        size_t SharedChunks() const
+        {
+            size_t shared = 0;
+            for (const auto& chunk : _chunks)
+            {
+                if (chunk.use_count() > 1) shared++;
+            }
+            return shared;
+        }
+
+    private:
+        using Chunk = std::vector<T>;
+
+        // Clone the chunk first if another copy may read it
+        Chunk& Writable(size_t chunk)
+        {
+            std::shared_ptr<Chunk>& slot = _chunks[chunk];
+            if (slot.use_count() > 1)
+                slot = std::make_shared<Chunk>(*slot);
+            return *slot;
+        }
+
+        std::vector<std::shared_ptr<Chunk>> _chunks;
+        size_t _size = 0;
+    };
+}
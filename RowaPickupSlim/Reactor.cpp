@@ -0,0 +1,362 @@
+// Reactor.cpp
+// Event loop implementation
+
+#include "Reactor.h"
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <ws2tcpip.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace RowaPickupSlim
+{
+#if defined(__linux__)
+    static uint32_t ToEpoll(uint32_t interest)
+    {
+        uint32_t events = EPOLLRDHUP;
+        if (interest & Reactor::Readable) events |= EPOLLIN;
+        if (interest & Reactor::Writable) events |= EPOLLOUT;
+        return events;
+    }
+
+    static uint32_t FromEpoll(uint32_t events)
+    {
+        uint32_t result = 0;
+        if (events & EPOLLIN) result |= Reactor::Readable;
+        if (events & EPOLLOUT) result |= Reactor::Writable;
+        if (events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) result |= Reactor::Closed;
+        return result;
+    }
+#else
+#ifdef _WIN32
+    using PollFd = WSAPOLLFD;
+    // WSAPoll rejects POLLPRI / POLLRDBAND in the requested events, so only the normal bands are used
+    static constexpr short POLL_READ = POLLRDNORM;
+    static constexpr short POLL_WRITE = POLLWRNORM;
+#else
+    using PollFd = pollfd;
+    static constexpr short POLL_READ = POLLIN;
+    static constexpr short POLL_WRITE = POLLOUT;
+#endif
+
+    static short ToPoll(uint32_t interest)
+    {
+        short events = 0;
+        if (interest & Reactor::Readable) events |= POLL_READ;
+        if (interest & Reactor::Writable) events |= POLL_WRITE;
+        return events;
+    }
+
+    static uint32_t FromPoll(short revents)
+    {
+        uint32_t result = 0;
+        if (revents & POLL_READ) result |= Reactor::Readable;
+        if (revents & POLL_WRITE) result |= Reactor::Writable;
+        if (revents & (POLLERR | POLLHUP | POLLNVAL)) result |= Reactor::Closed;
+        return result;
+    }
+#endif
+
+    Reactor::Reactor()
+    {
+#if defined(__linux__)
+        _epollFd = epoll_create1(EPOLL_CLOEXEC);
+        _eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_epollFd < 0 || _eventFd < 0) return;
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = _eventFd;
+        if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, _eventFd, &ev) != 0) return;
+#elif defined(_WIN32)
+        // Windows has no eventfd/pipe that WSAPoll can wait on: use a UDP socket that sends to itself
+        _wakeSocket = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (_wakeSocket == INVALID_SOCKET) return;
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        int len = sizeof(addr);
+        if (::bind(_wakeSocket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::getsockname(_wakeSocket, reinterpret_cast<sockaddr*>(&addr), &len) != 0 ||
+            ::connect(_wakeSocket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+            return;
+
+        u_long nonBlocking = 1;
+        ::ioctlsocket(_wakeSocket, FIONBIO, &nonBlocking);
+#else
+        if (::pipe(_wakePipe) != 0) return;
+        for (int fd : _wakePipe)
+        {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+#endif
+        _valid = true;
+    }
+
+    Reactor::~Reactor()
+    {
+#if defined(__linux__)
+        if (_eventFd >= 0) ::close(_eventFd);
+        if (_epollFd >= 0) ::close(_epollFd);
+#elif defined(_WIN32)
+        if (_wakeSocket != INVALID_SOCKET) ::closesocket(_wakeSocket);
+#else
+        for (int fd : _wakePipe)
+            if (fd >= 0) ::close(fd);
+#endif
+    }
+
+    bool Reactor::Add(SocketHandle socket, uint32_t interest, IoHandler handler)
+    {
+        if (!_valid || socket == INVALID_SOCKET_HANDLE || _registrations.count(socket)) return false;
+
+#if defined(__linux__)
+        epoll_event ev{};
+        ev.events = ToEpoll(interest);
+        ev.data.fd = socket;
+        if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, socket, &ev) != 0) return false;
+#endif
+        _registrations[socket] = Registration{ interest, std::make_shared<IoHandler>(std::move(handler)) };
+        return true;
+    }
+
+    bool Reactor::Modify(SocketHandle socket, uint32_t interest)
+    {
+        auto it = _registrations.find(socket);
+        if (it == _registrations.end()) return false;
+
+#if defined(__linux__)
+        epoll_event ev{};
+        ev.events = ToEpoll(interest);
+        ev.data.fd = socket;
+        if (epoll_ctl(_epollFd, EPOLL_CTL_MOD, socket, &ev) != 0) return false;
+#endif
+        it->second.interest = interest;
+        return true;
+    }
+
+    void Reactor::Remove(SocketHandle socket)
+    {
+        auto it = _registrations.find(socket);
+        if (it == _registrations.end()) return;
+
+#if defined(__linux__)
+        epoll_ctl(_epollFd, EPOLL_CTL_DEL, socket, nullptr);
+#endif
+        _registrations.erase(it);
+    }
+
+    Reactor::TimerId Reactor::AddTimer(Clock::duration delay, TimerHandler handler)
+    {
+        TimerId id = _nextTimerId++;
+        _timers.emplace(id, std::move(handler));
+        _timerQueue.push(TimerEntry{ Clock::now() + delay, id });
+        return id;
+    }
+
+    bool Reactor::CancelTimer(TimerId id)
+    {
+        // The queue entry stays behind and is skipped when it comes due
+        return _timers.erase(id) > 0;
+    }
+
+    void Reactor::Post(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_taskMtx);
+            _tasks.push_back(std::move(task));
+        }
+        Wakeup();
+    }
+
+    void Reactor::Stop()
+    {
+        _stopped.store(true, std::memory_order_release);
+        Wakeup();
+    }
+
+    void Reactor::Run()
+    {
+        while (!IsStopped())
+            RunOnce(Clock::duration::max());
+    }
+
+    Reactor::Counters Reactor::GetCounters() const
+    {
+        std::lock_guard<std::mutex> lock(_countersMtx);
+        return _counters;
+    }
+
+    void Reactor::Wakeup()
+    {
+        // Only the first wakeup after the loop drained the handle writes to it
+        if (_wakePending.exchange(true, std::memory_order_acq_rel)) return;
+
+#if defined(__linux__)
+        uint64_t one = 1;
+        ssize_t written = ::write(_eventFd, &one, sizeof(one));
+        (void)written;
+#elif defined(_WIN32)
+        char byte = 0;
+        ::send(_wakeSocket, &byte, 1, 0);
+#else
+        char byte = 0;
+        ssize_t written = ::write(_wakePipe[1], &byte, 1);
+        (void)written;
+#endif
+    }
+
+    void Reactor::DrainWakeup()
+    {
+#if defined(__linux__)
+        uint64_t value;
+        ssize_t got = ::read(_eventFd, &value, sizeof(value));
+        (void)got;
+#elif defined(_WIN32)
+        char buffer[64];
+        while (::recv(_wakeSocket, buffer, sizeof(buffer), 0) > 0) {}
+#else
+        char buffer[64];
+        while (::read(_wakePipe[0], buffer, sizeof(buffer)) > 0) {}
+#endif
+        // Cleared after draining: a Wakeup() from now on writes again. One that came in between
+        // skipped its write, but its task / stop request is seen because tasks run after this.
+        _wakePending.store(false, std::memory_order_release);
+    }
+
+    int Reactor::WaitTimeoutMs(Clock::duration maxWait)
+    {
+        // Cancelled timers at the front would cause a wakeup with nothing to do
+        while (!_timerQueue.empty() && !_timers.count(_timerQueue.top().id))
+            _timerQueue.pop();
+
+        Clock::duration wait = maxWait;
+        if (!_timerQueue.empty())
+        {
+            Clock::duration untilTimer = _timerQueue.top().deadline - Clock::now();
+            if (untilTimer < wait) wait = untilTimer;
+        }
+        if (wait <= Clock::duration::zero()) return 0;
+        if (wait == Clock::duration::max()) return -1;
+
+        // Round up, so a timer is never polled for before it is due
+        auto ms = std::chrono::ceil<std::chrono::milliseconds>(wait).count();
+        return ms > 0x7fffffff ? -1 : static_cast<int>(ms);
+    }
+
+    void Reactor::Dispatch(SocketHandle socket, uint32_t events)
+    {
+        auto it = _registrations.find(socket);
+        if (it == _registrations.end()) return;     // Removed by an earlier handler in this round
+
+        std::shared_ptr<IoHandler> handler = it->second.handler;
+        try { (*handler)(events); } catch (...) {}
+    }
+
+    size_t Reactor::RunTimers()
+    {
+        size_t fired = 0;
+        Clock::time_point now = Clock::now();
+        while (!_timerQueue.empty() && _timerQueue.top().deadline <= now)
+        {
+            TimerId id = _timerQueue.top().id;
+            _timerQueue.pop();
+
+            auto it = _timers.find(id);
+            if (it == _timers.end()) continue;      // Cancelled
+
+            TimerHandler handler = std::move(it->second);
+            _timers.erase(it);
+            try { handler(); } catch (...) {}
+            fired++;
+        }
+        return fired;
+    }
+
+    size_t Reactor::RunTasks()
+    {
+        std::vector<std::function<void()>> tasks;
+        {
+            std::lock_guard<std::mutex> lock(_taskMtx);
+            tasks.swap(_tasks);
+        }
+        for (auto& task : tasks)
+        {
+            try { task(); } catch (...) {}
+        }
+        return tasks.size();
+    }
+
+    size_t Reactor::RunOnce(Clock::duration maxWait)
+    {
+        if (!_valid) return 0;
+
+        int timeoutMs = WaitTimeoutMs(maxWait);
+        size_t ioEvents = 0;
+        bool woken = false;
+
+#if defined(__linux__)
+        epoll_event events[64];
+        int count = epoll_wait(_epollFd, events, 64, timeoutMs);
+        for (int i = 0; i < count; i++)
+        {
+            if (events[i].data.fd == _eventFd)
+            {
+                woken = true;
+                continue;
+            }
+            Dispatch(events[i].data.fd, FromEpoll(events[i].events));
+            ioEvents++;
+        }
+#else
+        std::vector<PollFd> fds;
+        fds.reserve(_registrations.size() + 1);
+#ifdef _WIN32
+        fds.push_back(PollFd{ _wakeSocket, POLL_READ, 0 });
+#else
+        fds.push_back(PollFd{ _wakePipe[0], POLL_READ, 0 });
+#endif
+        for (const auto& entry : _registrations)
+            fds.push_back(PollFd{ entry.first, ToPoll(entry.second.interest), 0 });
+
+#ifdef _WIN32
+        int count = ::WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), timeoutMs);
+#else
+        int count = ::poll(fds.data(), static_cast<nfds_t>(fds.size()), timeoutMs);
+#endif
+        if (count > 0)
+        {
+            woken = fds[0].revents != 0;
+            for (size_t i = 1; i < fds.size(); i++)
+            {
+                if (fds[i].revents == 0) continue;
+                Dispatch(fds[i].fd, FromPoll(fds[i].revents));
+                ioEvents++;
+            }
+        }
+#endif
+
+        if (woken) DrainWakeup();
+        size_t tasks = RunTasks();
+        size_t timers = RunTimers();
+
+        std::lock_guard<std::mutex> lock(_countersMtx);
+        _counters.waits++;
+        _counters.ioEvents += ioEvents;
+        _counters.tasksRun += tasks;
+        _counters.timersFired += timers;
+        if (ioEvents + tasks + timers == 0 && !IsStopped())
+            _counters.idleWakeups++;
+        return ioEvents + tasks + timers;
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+// Reactor.h
+// Single-threaded event loop: socket readiness, one-shot timers and cross-thread wakeups.
+// Backends: epoll + eventfd on Linux, WSAPoll on Windows, poll() on other POSIX systems.
+// The loop sleeps until something happens, so an idle connection causes no wakeups.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#endif
+
+namespace RowaPickupSlim
+{
+#ifdef _WIN32
+    using SocketHandle = SOCKET;
+    constexpr SocketHandle INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+#else
+    using SocketHandle = int;
+    constexpr SocketHandle INVALID_SOCKET_HANDLE = -1;
+#endif
+
+    class Reactor
+    {
+    public:
+        /// Readiness flags for Add() / Modify() and the I/O handler
+        enum Events : uint32_t
+        {
+            Readable = 1,
+            Writable = 2,
+            Closed = 4          // Error or hang-up; reported even if not requested
+        };
+
+        using IoHandler = std::function<void(uint32_t events)>;
+        using TimerHandler = std::function<void()>;
+        using TimerId = uint64_t;
+        using Clock = std::chrono::steady_clock;
+
+        struct Counters
+        {
+            uint64_t waits = 0;             // Calls into epoll_wait / WSAPoll / poll
+            uint64_t idleWakeups = 0;       // Waits that returned with nothing to do
+            uint64_t ioEvents = 0;          // I/O handler invocations
+            uint64_t timersFired = 0;
+            uint64_t tasksRun = 0;          // Post()ed tasks executed
+        };
+
+        /// Creates the poller and the wakeup handle. On Windows, Winsock must already be initialized.
+        Reactor();
+        ~Reactor();
+
+        Reactor(const Reactor&) = delete;
+        Reactor& operator=(const Reactor&) = delete;
+
+        /// @return false if the poller or wakeup handle could not be created
+        bool IsValid() const { return _valid; }
+
+        // Registration and timers: call on the reactor thread, or before Run() starts.
+        // Other threads use Post() to get onto the reactor thread.
+
+        bool Add(SocketHandle socket, uint32_t interest, IoHandler handler);
+        bool Modify(SocketHandle socket, uint32_t interest);
+        void Remove(SocketHandle socket);
+
+        /// One-shot timer
+        TimerId AddTimer(Clock::duration delay, TimerHandler handler);
+        /// @return false if the timer already fired or was cancelled
+        bool CancelTimer(TimerId id);
+
+        // Thread-safe
+
+        /// Run task on the reactor thread (wakes the loop)
+        void Post(std::function<void()> task);
+
+        /// Make Run() return as soon as possible (wakes the loop)
+        void Stop();
+
+        /// Run until Stop() is called
+        void Run();
+
+        /// Wait at most maxWait for events, then dispatch them
+        /// @return Number of I/O events, timers and tasks handled
+        size_t RunOnce(Clock::duration maxWait);
+
+        bool IsStopped() const { return _stopped.load(std::memory_order_acquire); }
+
+        Counters GetCounters() const;
+
+    private:
+        struct Registration
+        {
+            uint32_t interest;
+            std::shared_ptr<IoHandler> handler;     // Shared so a handler may Remove() itself while running
+        };
+
+        struct TimerEntry
+        {
+            Clock::time_point deadline;
+            TimerId id;
+            bool operator>(const TimerEntry& other) const { return deadline > other.deadline; }
+        };
+
+        void Wakeup();
+        void DrainWakeup();
+        size_t RunTimers();
+        size_t RunTasks();
+        int WaitTimeoutMs(Clock::duration maxWait);
+        void Dispatch(SocketHandle socket, uint32_t events);
+
+        bool _valid = false;
+        std::atomic<bool> _stopped{ false };
+        std::atomic<bool> _wakePending{ false };    // Coalesces wakeups until the loop drained them
+
+#if defined(__linux__)
+        int _epollFd = -1;
+        int _eventFd = -1;
+#elif defined(_WIN32)
+        SocketHandle _wakeSocket = INVALID_SOCKET_HANDLE;   // UDP socket connected to itself on loopback
+#else
+        int _wakePipe[2] = { -1, -1 };
+#endif
+
+        std::unordered_map<SocketHandle, Registration> _registrations;
+
+        std::priority_queue<TimerEntry, std::vector<TimerEntry>, std::greater<TimerEntry>> _timerQueue;
+        std::unordered_map<TimerId, TimerHandler> _timers;     // Pending timers; cancelled ones are erased
+        TimerId _nextTimerId = 1;
+
+        std::mutex _taskMtx;
+        std::vector<std::function<void()>> _tasks;
+
+        Counters _counters;
+        mutable std::mutex _countersMtx;
+    };
+}
@@ -0,0 +1,137 @@
+// ReconnectPolicy.cpp
+// Reconnection backoff implementation
+
+#include "ReconnectPolicy.h"
+#include <algorithm>
+#include <cmath>
+
+namespace RowaPickupSlim
+{
+    ReconnectPolicy::ReconnectPolicy()
+        : ReconnectPolicy(Options())
+    {
+    }
+
+    ReconnectPolicy::ReconnectPolicy(const Options& options, uint32_t seed)
+        : _options(options), _random(seed)
+    {
+    }
+
+    void ReconnectPolicy::SetOptions(const Options& options)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _options = options;
+    }
+
+    ReconnectPolicy::Options ReconnectPolicy::GetOptions() const
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _options;
+    }
+
+    ReconnectPolicy::Duration ReconnectPolicy::BaseDelay(const Options& options, uint32_t attempt)
+    {
+        if (attempt == 0) attempt = 1;
+        if (options.immediateFirstRetry)
+        {
+            if (attempt == 1) return Duration::zero();
+            attempt--;
+        }
+
+        // initialDelay * multiplier^(attempt - 1), computed in double so it cannot overflow
+        double delay = static_cast<double>(options.initialDelay.count()) *
+                       std::pow(std::max(options.multiplier, 1.0), static_cast<double>(attempt - 1));
+        double cap = static_cast<double>(options.maxDelay.count());
+        return Duration(static_cast<Duration::rep>(std::min(delay, cap)));
+    }
+
+    void ReconnectPolicy::OnDisconnected(Clock::time_point now)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (_connected)
+        {
+            if (_inOutage && IsStableLocked(now))
+                EndOutageLocked(_connectedAt + _options.stableAfter);
+            else if (_inOutage)
+                _metrics.unstableConnections++;
+            _connected = false;
+        }
+        if (_inOutage) return;
+
+        _inOutage = true;
+        _outageStart = now;
+        _attempts = 0;
+        _metrics.outages++;
+    }
+
+    ReconnectPolicy::Duration ReconnectPolicy::NextDelay(Clock::time_point now)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (!_inOutage)
+        {
+            _inOutage = true;
+            _outageStart = now;
+            _attempts = 0;
+            _metrics.outages++;
+        }
+
+        _attempts++;
+        _metrics.totalAttempts++;
+
+        Duration delay = BaseDelay(_options, _attempts);
+        double jitter = std::clamp(_options.jitter, 0.0, 1.0);
+        if (delay > Duration::zero() && jitter > 0.0)
+        {
+            std::uniform_real_distribution<double> spread(1.0 - jitter, 1.0);
+            delay = Duration(static_cast<Duration::rep>(static_cast<double>(delay.count()) * spread(_random)));
+        }
+
+        _metrics.lastDelay = delay;
+        return delay;
+    }
+
+    void ReconnectPolicy::OnConnected(Clock::time_point now)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _connected = true;
+        _connectedAt = now;
+    }
+
+    void ReconnectPolicy::OnEstablished(Clock::time_point now)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (_inOutage) EndOutageLocked(now);
+    }
+
+    void ReconnectPolicy::EndOutageLocked(Clock::time_point end)
+    {
+        _inOutage = false;
+        _metrics.reconnects++;
+        _metrics.lastOutage = end - _outageStart;
+        _metrics.longestOutage = std::max(_metrics.longestOutage, _metrics.lastOutage);
+    }
+
+    bool ReconnectPolicy::IsStableLocked(Clock::time_point now) const
+    {
+        return _connected && now - _connectedAt >= _options.stableAfter;
+    }
+
+    ReconnectPolicy::Metrics ReconnectPolicy::GetMetrics(Clock::time_point now) const
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        Metrics metrics = _metrics;
+        metrics.inOutage = _inOutage;
+        metrics.attempts = _attempts;
+
+        // Connected for stableAfter: the outage is over, OnDisconnected() only records it later
+        if (_inOutage && IsStableLocked(now))
+        {
+            metrics.inOutage = false;
+            metrics.reconnects++;
+            metrics.lastOutage = _connectedAt + _options.stableAfter - _outageStart;
+            metrics.longestOutage = std::max(metrics.longestOutage, metrics.lastOutage);
+        }
+        metrics.currentOutage = metrics.inOutage ? now - _outageStart : Duration::zero();
+        return metrics;
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+// ReconnectPolicy.h
+// When to try to reconnect after the connection to the robot was lost.
+// First retry immediately, then exponential backoff with random jitter (so terminals that
+// lost the robot at the same moment spread out), capped at maxDelay and never giving up.
+// A TCP connection alone does not end the outage: a peer that accepts and drops again would
+// otherwise be retried without delay forever. The outage ends when the session is established
+// (handshake complete) or the connection has lasted stableAfter; until then the attempts count on.
+// Time is passed in by the caller, so the policy can be driven by a virtual clock.
+// Only depends on the standard library.
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+namespace RowaPickupSlim
+{
+    class ReconnectPolicy
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Duration = Clock::duration;
+
+        struct Options
+        {
+            bool immediateFirstRetry = true;
+            Duration initialDelay = std::chrono::seconds(1);    // Backoff base (first delayed retry)
+            double multiplier = 2.0;
+            Duration maxDelay = std::chrono::seconds(30);
+            double jitter = 0.5;        // Fraction of the delay that is randomized: delay * [1 - jitter, 1]
+            Duration stableAfter = std::chrono::seconds(10);    // Connected this long without OnEstablished() ends the outage too
+        };
+
+        struct Metrics
+        {
+            bool inOutage = false;
+            uint32_t attempts = 0;              // Attempts in the current (or last) outage
+            uint64_t totalAttempts = 0;
+            uint64_t outages = 0;               // Outages that started
+            uint64_t reconnects = 0;            // Outages that ended with an established session
+            uint64_t unstableConnections = 0;   // Connections lost before they ended the outage
+            Duration currentOutage{};           // Zero when connected
+            Duration lastOutage{};
+            Duration longestOutage{};
+            Duration lastDelay{};
+        };
+
+        ReconnectPolicy();
+        explicit ReconnectPolicy(const Options& options, uint32_t seed = std::random_device{}());
+
+        void SetOptions(const Options& options);
+        Options GetOptions() const;
+
+        /// The connection was lost (or the first connect failed); starts an outage unless one is running
+        void OnDisconnected(Clock::time_point now);
+
+        /// Delay to wait before the next connection attempt; counts the attempt
+        Duration NextDelay(Clock::time_point now);
+
+        /// A connection was made; the outage goes on until it proves stable
+        void OnConnected(Clock::time_point now);
+
+        /// The session is usable (handshake complete): ends the outage
+        void OnEstablished(Clock::time_point now);
+
+        Metrics GetMetrics(Clock::time_point now) const;
+
+        /// Delay before attempt n (1-based) of an outage, without jitter
+        static Duration BaseDelay(const Options& options, uint32_t attempt);
+
+    private:
+        void EndOutageLocked(Clock::time_point end);
+        bool IsStableLocked(Clock::time_point now) const;
+
+        Options _options;
+        std::mt19937 _random;
+
+        bool _inOutage = false;
+        bool _connected = false;
+        Clock::time_point _outageStart;
+        Clock::time_point _connectedAt;
+        uint32_t _attempts = 0;
+        Metrics _metrics;
+        mutable std::mutex _mtx;
+    };
+}
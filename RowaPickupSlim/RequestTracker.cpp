@@ -0,0 +1,231 @@
+// RequestTracker.cpp
+// Request/response correlation table implementation
+
+#include "RequestTracker.h"
+#include <algorithm>
+
+namespace RowaPickupSlim
+{
+    const char* ToString(RequestOutcome outcome)
+    {
+        switch (outcome)
+        {
+        case RequestOutcome::Answered: return "Answered";
+        case RequestOutcome::TimedOut: return "TimedOut";
+        case RequestOutcome::Disconnected: return "Disconnected";
+        case RequestOutcome::NotSent: return "NotSent";
+        case RequestOutcome::Replaced: return "Replaced";
+        }
+        return "";
+    }
+
+    RequestTracker::RequestTracker(Clock::duration tick, size_t wheelSize)
+        : _tick(tick > Clock::duration::zero() ? tick : std::chrono::milliseconds(100)),
+          _epoch(Clock::now()), _wheel(wheelSize > 0 ? wheelSize : 1)
+    {
+        _timeouts.fill(std::chrono::seconds(10));
+        _timeouts[static_cast<size_t>(WwksMessageType::StockInfoRequest)] = std::chrono::seconds(60);
+    }
+
+    WwksMessageType RequestTracker::ResponseTypeFor(WwksMessageType requestType)
+    {
+        switch (requestType)
+        {
+        case WwksMessageType::HelloRequest: return WwksMessageType::HelloResponse;
+        case WwksMessageType::StatusRequest: return WwksMessageType::StatusResponse;
+        case WwksMessageType::StockInfoRequest: return WwksMessageType::StockInfoResponse;
+        case WwksMessageType::OutputRequest: return WwksMessageType::OutputResponse;
+        case WwksMessageType::TaskInfoRequest: return WwksMessageType::TaskInfoResponse;
+        case WwksMessageType::KeepAliveRequest: return WwksMessageType::KeepAliveResponse;
+        default: return WwksMessageType::Unknown;
+        }
+    }
+
+    void RequestTracker::SetTimeout(WwksMessageType requestType, Clock::duration timeout)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _timeouts[static_cast<size_t>(requestType)] = timeout;
+    }
+
+    RequestTracker::Clock::duration RequestTracker::GetTimeout(WwksMessageType requestType) const
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _timeouts[static_cast<size_t>(requestType)];
+    }
+
+    uint64_t RequestTracker::TickOf(Clock::time_point time) const
+    {
+        if (time <= _epoch) return 0;
+        return static_cast<uint64_t>((time - _epoch) / _tick);
+    }
+
+    std::future<RequestTracker::Result> RequestTracker::Track(const std::string& id, WwksMessageType requestType,
+        Callback callback, Clock::time_point now)
+    {
+        Pending pending;
+        pending.requestType = requestType;
+        pending.sent = now;
+        pending.callback = std::move(callback);
+        std::future<Result> future = pending.promise.get_future();
+
+        Completion replaced;
+        bool hasReplaced = false;
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            pending.deadline = now + _timeouts[static_cast<size_t>(requestType)];
+
+            auto it = _pending.find(id);
+            if (it != _pending.end())
+            {
+                replaced = TakeLocked(it, RequestOutcome::Replaced, now);
+                hasReplaced = true;
+            }
+
+            // Rounded up, so a request never times out early; never in a slot that was already passed
+            uint64_t tick = std::max(TickOf(pending.deadline) + 1, _currentTick + 1);
+            _wheel[tick % _wheel.size()].push_back(id);
+            _pending.emplace(id, std::move(pending));
+        }
+
+        if (hasReplaced) Deliver(replaced);
+        return future;
+    }
+
+    bool RequestTracker::OnResponse(std::string_view id, WwksMessageType responseType, Clock::time_point now)
+    {
+        Completion completion;
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            auto it = _pending.find(std::string(id));
+            if (it == _pending.end() || ResponseTypeFor(it->second.requestType) != responseType)
+                return false;   // Not ours, or e.g. an OutputMessage that shares the OutputRequest's Id
+            completion = TakeLocked(it, RequestOutcome::Answered, now);
+        }
+        Deliver(completion);
+        return true;
+    }
+
+    bool RequestTracker::Cancel(std::string_view id, RequestOutcome outcome, Clock::time_point now)
+    {
+        Completion completion;
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            auto it = _pending.find(std::string(id));
+            if (it == _pending.end()) return false;
+            completion = TakeLocked(it, outcome, now);
+        }
+        Deliver(completion);
+        return true;
+    }
+
+    size_t RequestTracker::CancelAll(RequestOutcome outcome, Clock::time_point now)
+    {
+        std::vector<Completion> completions;
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            completions.reserve(_pending.size());
+            while (!_pending.empty())
+                completions.push_back(TakeLocked(_pending.begin(), outcome, now));
+            for (auto& slot : _wheel)
+                slot.clear();
+        }
+        for (Completion& completion : completions)
+            Deliver(completion);
+        return completions.size();
+    }
+
+    size_t RequestTracker::Expire(Clock::time_point now)
+    {
+        std::vector<Completion> expired;
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            uint64_t target = TickOf(now);
+
+            // After a long pause one turn visits every slot once
+            uint64_t first = _currentTick + 1;
+            if (target >= first + _wheel.size())
+                first = target - _wheel.size() + 1;
+
+            for (uint64_t tick = first; tick <= target; tick++)
+            {
+                std::vector<std::string>& slot = _wheel[tick % _wheel.size()];
+                size_t kept = 0;
+                for (size_t i = 0; i < slot.size(); i++)
+                {
+                    auto it = _pending.find(slot[i]);
+                    if (it == _pending.end())
+                        continue;       // Already completed
+
+                    uint64_t dueTick = TickOf(it->second.deadline) + 1;
+                    if (it->second.deadline <= now)
+                        expired.push_back(TakeLocked(it, RequestOutcome::TimedOut, now));
+                    else if (dueTick % _wheel.size() == tick % _wheel.size())
+                    {
+                        // Due in a later turn of the wheel
+                        if (kept != i) slot[kept] = std::move(slot[i]);
+                        kept++;
+                    }
+                    // else: stale entry of a replaced request, the new one has its own slot
+                }
+                slot.resize(kept);
+            }
+            if (target > _currentTick) _currentTick = target;
+        }
+
+        for (Completion& completion : expired)
+            Deliver(completion);
+        return expired.size();
+    }
+
+    size_t RequestTracker::PendingCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _pending.size();
+    }
+
+    RequestTracker::Stats RequestTracker::GetStats(WwksMessageType requestType) const
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _stats[static_cast<size_t>(requestType)];
+    }
+
+    RequestTracker::Completion RequestTracker::TakeLocked(std::unordered_map<std::string, Pending>::iterator it,
+        RequestOutcome outcome, Clock::time_point now)
+    {
+        Pending& pending = it->second;
+
+        Completion completion;
+        completion.result.id = it->first;
+        completion.result.requestType = pending.requestType;
+        completion.result.outcome = outcome;
+        completion.result.latency = now - pending.sent;
+        completion.callback = std::move(pending.callback);
+        completion.promise = std::move(pending.promise);
+
+        Stats& stats = _stats[static_cast<size_t>(pending.requestType)];
+        if (outcome == RequestOutcome::Answered)
+        {
+            uint64_t micros = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(completion.result.latency).count());
+            stats.answered++;
+            stats.totalMicros += micros;
+            stats.maxMicros = std::max(stats.maxMicros, micros);
+        }
+        else
+        {
+            stats.failed++;
+        }
+
+        _pending.erase(it);
+        return completion;
+    }
+
+    void RequestTracker::Deliver(Completion& completion)
+    {
+        if (completion.callback)
+        {
+            try { completion.callback(completion.result); } catch (...) {}
+        }
+        completion.promise.set_value(completion.result);
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+// RequestTracker.h
+// Pending-request table: correlates WWKS responses with the requests we sent, by message Id.
+// Every tracked request completes exactly once (answered, timed out, disconnected, ...)
+// through its future and optional callback. Deadlines are kept in a hashed timer wheel,
+// so expiring costs O(1) per request regardless of how many are pending.
+// Only depends on the standard library.
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "WwksClassifier.h"
+
+namespace RowaPickupSlim
+{
+    enum class RequestOutcome : uint8_t
+    {
+        Answered,
+        TimedOut,           // No response before the request type's timeout
+        Disconnected,       // Connection closed while waiting
+        NotSent,            // Could not be queued for sending
+        Replaced            // A new request was tracked under the same Id
+    };
+
+    const char* ToString(RequestOutcome outcome);
+
+    class RequestTracker
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Result
+        {
+            std::string id;
+            WwksMessageType requestType = WwksMessageType::Unknown;
+            RequestOutcome outcome = RequestOutcome::Answered;
+            Clock::duration latency{};      // Tracked -> completed
+        };
+
+        using Callback = std::function<void(const Result&)>;
+
+        /// Per request type
+        struct Stats
+        {
+            uint64_t answered = 0;
+            uint64_t failed = 0;            // Any outcome other than Answered
+            uint64_t totalMicros = 0;       // Sum of answered latencies
+            uint64_t maxMicros = 0;         // Longest answered latency
+        };
+
+        /// @param tick Timer wheel resolution (timeouts are rounded up to it)
+        /// @param wheelSize Slots in the wheel; longer timeouts take several turns
+        explicit RequestTracker(Clock::duration tick = std::chrono::milliseconds(100), size_t wheelSize = 512);
+
+        /// Timeout for a request type (default 10 s, StockInfoRequest 60 s)
+        void SetTimeout(WwksMessageType requestType, Clock::duration timeout);
+        Clock::duration GetTimeout(WwksMessageType requestType) const;
+
+        Clock::duration GetTick() const { return _tick; }
+
+        /// Start tracking a request before it is sent.
+        /// callback runs on the thread that completes the request (OnResponse / Expire / Cancel caller).
+        std::future<Result> Track(const std::string& id, WwksMessageType requestType, Callback callback = nullptr,
+            Clock::time_point now = Clock::now());
+
+        /// Feed every received response
+        /// @return true if it completed a pending request (same Id and the matching response type)
+        bool OnResponse(std::string_view id, WwksMessageType responseType, Clock::time_point now = Clock::now());
+
+        /// Complete one pending request with a failure outcome
+        /// @return false if it was not pending
+        bool Cancel(std::string_view id, RequestOutcome outcome, Clock::time_point now = Clock::now());
+
+        /// Complete every pending request with outcome (e.g. on disconnect)
+        size_t CancelAll(RequestOutcome outcome, Clock::time_point now = Clock::now());
+
+        /// Advance the wheel to now and time out every request whose deadline passed
+        /// @return Number of requests that timed out
+        size_t Expire(Clock::time_point now = Clock::now());
+
+        size_t PendingCount() const;
+
+        Stats GetStats(WwksMessageType requestType) const;
+
+        /// Response type that answers a request type (Unknown if none)
+        static WwksMessageType ResponseTypeFor(WwksMessageType requestType);
+
+    private:
+        static constexpr size_t TYPE_COUNT = static_cast<size_t>(WwksMessageType::KeepAliveResponse) + 1;
+
+        struct Pending
+        {
+            WwksMessageType requestType;
+            Clock::time_point sent;
+            Clock::time_point deadline;
+            Callback callback;
+            std::promise<Result> promise;
+        };
+
+        struct Completion
+        {
+            Result result;
+            Callback callback;
+            std::promise<Result> promise;
+        };
+
+        uint64_t TickOf(Clock::time_point time) const;
+        Completion TakeLocked(std::unordered_map<std::string, Pending>::iterator it, RequestOutcome outcome, Clock::time_point now);
+        static void Deliver(Completion& completion);
+
+        Clock::duration _tick;
+        Clock::time_point _epoch;
+        uint64_t _currentTick = 0;                          // Every slot up to this tick was expired
+
+        mutable std::mutex _mtx;
+        std::unordered_map<std::string, Pending> _pending;
+        std::vector<std::vector<std::string>> _wheel;       // Ids by deadline tick % wheel size
+        std::array<Clock::duration, TYPE_COUNT> _timeouts;
+        std::array<Stats, TYPE_COUNT> _stats;
+    };
+}
@@ -0,0 +1,240 @@
+// SendQueue.cpp
+// Outbound message queue implementation
+
+#include "SendQueue.h"
+#include <algorithm>
+
+namespace RowaPickupSlim
+{
+    static constexpr size_t MAX_GATHER = 1024;     // Buffers per gathering write
+    // Bytes per write: a blocking send of a large batch would otherwise hold back priority messages until all of it is out
+    static constexpr size_t MAX_WRITE_BYTES = 64 * 1024;
+
+    SendQueue::SendQueue(size_t maxBatch)
+        : _maxBatch(std::clamp<size_t>(maxBatch, 1, MAX_GATHER))
+    {
+    }
+
+    SendQueue::~SendQueue()
+    {
+        Stop();
+    }
+
+    void SendQueue::Start(Transport& transport)
+    {
+        Stop();
+
+        std::lock_guard<std::mutex> lk(_mtx);
+        _transport = &transport;
+        _running = true;
+        _stopping = false;
+        _writer = std::thread(&SendQueue::WriterLoop, this);
+    }
+
+    void SendQueue::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            if (!_running && !_writer.joinable()) return;
+            _running = false;
+            _stopping = true;
+        }
+        _wake.notify_all();
+        if (_writer.joinable())
+            _writer.join();
+
+        // Whatever the writer did not take completes with false
+        std::deque<Pending> rest;
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            rest.swap(_priority);
+            for (Pending& pending : _queue)
+                rest.push_back(std::move(pending));
+            _queue.clear();
+            _transport = nullptr;
+        }
+        for (Pending& pending : rest)
+            Complete(pending, false);
+    }
+
+    std::future<bool> SendQueue::Enqueue(std::string message, Lane lane, WrittenCallback written)
+    {
+        Pending pending;
+        pending.data = std::move(message);
+        pending.written = std::move(written);
+        pending.priority = lane == Lane::Priority;
+        std::future<bool> result = pending.done.get_future();
+
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            if (_running)
+            {
+                _counters.depth++;
+                _counters.bytesInFlight += pending.data.size();
+                _counters.maxDepth = std::max(_counters.maxDepth, _counters.depth);
+                _counters.maxBytesInFlight = std::max(_counters.maxBytesInFlight, _counters.bytesInFlight);
+                (pending.priority ? _priority : _queue).push_back(std::move(pending));
+                _wake.notify_one();
+                return result;
+            }
+            _counters.failed++;
+        }
+
+        if (pending.written)
+        {
+            try { pending.written(false); } catch (...) {}
+        }
+        pending.done.set_value(false);
+        return result;
+    }
+
+    bool SendQueue::IsRunning() const
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        return _running;
+    }
+
+    SendQueue::Counters SendQueue::GetCounters() const
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        return _counters;
+    }
+
+    void SendQueue::Complete(Pending& pending, bool ok)
+    {
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            _counters.depth--;
+            _counters.bytesInFlight -= pending.data.size();
+            if (ok)
+            {
+                _counters.messagesSent++;
+                _counters.bytesSent += pending.data.size();
+                if (pending.priority) _counters.prioritySent++;
+            }
+            else
+            {
+                _counters.failed++;
+            }
+        }
+        if (pending.written)
+        {
+            try { pending.written(ok); } catch (...) {}
+        }
+        pending.done.set_value(ok);
+    }
+
+    // Move every queued priority message into _batch at position (must hold _mtx)
+    void SendQueue::TakePriorityLocked(size_t position)
+    {
+        if (_priority.empty()) return;
+        _batch.insert(_batch.begin() + position, std::make_move_iterator(_priority.begin()), std::make_move_iterator(_priority.end()));
+        _priority.clear();
+    }
+
+    // On failure _batch keeps only the messages that were not completed
+    bool SendQueue::WriteBatch(int& error)
+    {
+        Transport::Buffer buffers[MAX_GATHER];
+        size_t index = 0;       // First message of _batch not completely written
+        size_t offset = 0;      // Bytes of that message already written
+
+        while (index < _batch.size())
+        {
+            size_t count = 0;
+            size_t bytes = 0;
+            // Priority insertions can make the batch longer than one gathering write takes
+            for (size_t i = index; i < _batch.size() && count < _maxBatch && bytes < MAX_WRITE_BYTES; i++, count++)
+            {
+                const std::string& data = _batch[i].data;
+                size_t skip = (i == index) ? offset : 0;
+                size_t length = std::min(data.size() - skip, MAX_WRITE_BYTES - bytes);
+                bytes += length;
+                buffers[count].data = data.data() + skip;
+                buffers[count].size = length;
+            }
+
+            size_t written = 0;
+            if (!_transport->Write(buffers, count, written, error))
+            {
+                _batch.erase(_batch.begin(), _batch.begin() + index);
+                return false;
+            }
+            {
+                std::lock_guard<std::mutex> lk(_mtx);
+                _counters.writeCalls++;
+            }
+
+            // A write covers only part of the batch (byte cap, or the transport took less): complete what is fully written
+            while (index < _batch.size() && written > 0)
+            {
+                size_t remaining = _batch[index].data.size() - offset;
+                if (written < remaining)
+                {
+                    offset += written;
+                    break;
+                }
+                written -= remaining;
+                Complete(_batch[index], true);
+                index++;
+                offset = 0;
+            }
+
+            // Priority messages that arrived meanwhile go next (after a partly written message)
+            if (index < _batch.size())
+            {
+                std::lock_guard<std::mutex> lk(_mtx);
+                TakePriorityLocked(offset > 0 ? index + 1 : index);
+            }
+        }
+        return true;
+    }
+
+    void SendQueue::WriterLoop()
+    {
+        for (;;)
+        {
+            _batch.clear();
+            {
+                std::unique_lock<std::mutex> lk(_mtx);
+                _wake.wait(lk, [this]() { return _stopping || !_queue.empty() || !_priority.empty(); });
+                if (_stopping) break;
+
+                // Priority messages first, then everything that queued up during the previous write, in one call
+                TakePriorityLocked(0);
+                size_t take = std::min(_queue.size(), _maxBatch);
+                for (size_t i = 0; i < take; i++)
+                {
+                    _batch.push_back(std::move(_queue.front()));
+                    _queue.pop_front();
+                }
+                _counters.maxBatch = std::max<uint64_t>(_counters.maxBatch, _batch.size());
+            }
+
+            int error = 0;
+            if (!WriteBatch(error))
+            {
+                // The connection is broken: fail everything still pending and refuse further messages
+                std::deque<Pending> rest;
+                {
+                    std::lock_guard<std::mutex> lk(_mtx);
+                    _running = false;
+                    rest.swap(_priority);
+                    for (Pending& pending : _queue)
+                        rest.push_back(std::move(pending));
+                    _queue.clear();
+                }
+                for (Pending& pending : _batch)
+                    Complete(pending, false);
+                for (Pending& pending : rest)
+                    Complete(pending, false);
+
+                if (WriteFailed)
+                {
+                    try { WriteFailed(error); } catch (...) {}
+                }
+                break;
+            }
+        }
+    }
+}
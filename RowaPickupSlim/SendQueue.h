@@ -0,0 +1,106 @@
+#pragma once
+// SendQueue.h
+// Outbound message queue for one connected Transport.
+// Enqueue() never waits for the network: a writer thread takes everything that queued up
+// while the previous write was in progress and sends it with one gathering write
+// (Transport::Write: sendmsg on POSIX, WSASend on Windows).
+// Priority messages (KeepAliveResponse) go out ahead of everything queued, and are
+// slipped into a batch that is still being written as soon as its current write returns.
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Transport.h"
+
+namespace RowaPickupSlim
+{
+    class SendQueue
+    {
+    public:
+        enum class Lane
+        {
+            Normal,
+            Priority
+        };
+
+        /// Called on the writer thread once the message was written (true) or failed (false)
+        using WrittenCallback = std::function<void(bool ok)>;
+
+        /// Snapshot of the queue counters
+        struct Counters
+        {
+            size_t depth = 0;               // Messages queued or being written
+            size_t maxDepth = 0;            // Highest depth observed
+            size_t bytesInFlight = 0;       // Bytes queued or being written
+            size_t maxBytesInFlight = 0;    // Highest bytesInFlight observed
+            uint64_t messagesSent = 0;
+            uint64_t bytesSent = 0;
+            uint64_t writeCalls = 0;        // Gathering writes issued (messagesSent / writeCalls = coalescing)
+            uint64_t maxBatch = 0;          // Most messages taken into one batch
+            uint64_t failed = 0;            // Messages completed with false (write error or stop)
+            uint64_t prioritySent = 0;      // Priority lane messages written
+        };
+
+        /// @param maxBatch Most messages gathered into one write
+        explicit SendQueue(size_t maxBatch = 64);
+        ~SendQueue();
+
+        /// Start the writer thread for a connected transport (the writer may block in Write)
+        /// The transport must outlive Stop().
+        void Start(Transport& transport);
+
+        /// Stop the writer thread; messages not yet written complete with false.
+        /// A writer blocked in Write() only returns once the transport is shut down.
+        void Stop();
+
+        /// Queue one complete message (including its line terminator)
+        /// @return Future that becomes true once every byte was handed to the transport,
+        ///         or false if the queue is not running or the write failed
+        std::future<bool> Enqueue(std::string message, Lane lane = Lane::Normal, WrittenCallback written = nullptr);
+
+        bool IsRunning() const;
+
+        Counters GetCounters() const;
+
+        /// Called on the writer thread when a write fails, with the transport's error code
+        std::function<void(int error)> WriteFailed;
+
+    private:
+        struct Pending
+        {
+            std::string data;
+            std::promise<bool> done;
+            WrittenCallback written;
+            bool priority = false;
+        };
+
+        void WriterLoop();
+        bool WriteBatch(int& error);
+        void TakePriorityLocked(size_t position);
+        void Complete(Pending& pending, bool ok);
+
+        Transport* _transport = nullptr;
+        size_t _maxBatch;
+        std::thread _writer;
+        bool _running = false;              // Guarded by _mtx
+        bool _stopping = false;             // Guarded by _mtx
+
+        mutable std::mutex _mtx;
+        std::condition_variable _wake;
+        std::deque<Pending> _queue;
+        std::deque<Pending> _priority;
+        std::vector<Pending> _batch;        // Writer thread only
+
+        Counters _counters;                 // Guarded by _mtx
+
+        // non-copyable
+        SendQueue(const SendQueue&) = delete;
+        SendQueue& operator=(const SendQueue&) = delete;
+    };
+}
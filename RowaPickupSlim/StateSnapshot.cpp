@@ -0,0 +1,100 @@
+// StateSnapshot.cpp
+// Published UI state implementation
+
+#include "StateSnapshot.h"
+
+namespace RowaPickupSlim
+{
+    static OrderDisplay MakeOrderDisplay(const OutputRecord* record)
+    {
+        OrderDisplay display;
+        if (record)
+        {
+            display.hasOrder = true;
+            display.isOurOutput = record->isOurOutput;
+            display.status = record->status;
+            display.quantityRequested = record->quantityRequested;
+            display.packsDelivered = record->packsDelivered;
+        }
+        return display;
+    }
+
+    size_t StateSnapshot::RowCount() const
+    {
+        if (rows) return rows->size();
+        return articleIds ? articleIds->size() : 0;
+    }
+
+    bool StateSnapshot::GetRow(size_t row, std::string& articleId, int& quantity, OrderDisplay& order) const
+    {
+        if (row >= RowCount()) return false;
+
+        size_t index = rows ? (*rows)[row] : row;
+        articleId = (*articleIds)[index];
+        quantity = index < quantities.Size() ? quantities[index] : 0;
+        order = index < orders.Size() ? orders[index] : OrderDisplay();
+        return true;
+    }
+
+    namespace Snapshots
+    {
+        std::shared_ptr<const std::vector<std::string>> ArticleIds(const ArticleStore& store)
+        {
+            auto ids = std::make_shared<std::vector<std::string>>();
+            ids->reserve(store.Size());
+            for (const Article& article : store)
+                ids->push_back(article.first);
+            return ids;
+        }
+
+        PersistentVector<int> Quantities(const ArticleStore& store)
+        {
+            PersistentVector<int> quantities;
+            for (const Article& article : store)
+                quantities.PushBack(article.second);
+            return quantities;
+        }
+
+        PersistentVector<int> Quantities(const PersistentVector<int>& previous, const ArticleStore& store,
+            const std::vector<std::string>& changedArticleIds)
+        {
+            if (previous.Size() != store.Size()) return Quantities(store);
+
+            PersistentVector<int> quantities = previous;
+            for (const std::string& articleId : changedArticleIds)
+            {
+                int index = store.FindArticleIndex(articleId);
+                if (index >= 0) quantities.Set(index, store[index].second);
+            }
+            return quantities;
+        }
+
+        std::shared_ptr<const std::vector<uint32_t>> Rows(const ArticleView& view)
+        {
+            if (view.ShowsAll()) return nullptr;
+            return std::make_shared<const std::vector<uint32_t>>(view.Indices());
+        }
+
+        PersistentVector<OrderDisplay> Orders(const ArticleStore& store, const OrderTable& orders)
+        {
+            PersistentVector<OrderDisplay> display;
+            for (const Article& article : store)
+                display.PushBack(MakeOrderDisplay(orders.Size() ? orders.FindArticleDisplay(article.first) : nullptr));
+            return display;
+        }
+
+        PersistentVector<OrderDisplay> Orders(const PersistentVector<OrderDisplay>& previous, const ArticleStore& store,
+            const OrderTable& orders, const std::vector<std::string>& changedArticleIds)
+        {
+            if (previous.Size() != store.Size()) return Orders(store, orders);
+
+            PersistentVector<OrderDisplay> display = previous;
+            for (const std::string& articleId : changedArticleIds)
+            {
+                int index = store.FindArticleIndex(articleId);
+                if (index >= 0) display.Set(index, MakeOrderDisplay(orders.FindArticleDisplay(articleId)));
+            }
+            return display;
+        }
+    }
+}
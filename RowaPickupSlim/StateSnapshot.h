@@ -0,0 +1,73 @@
+#pragma once
+// StateSnapshot.h
+// Read-only view of the application state as published to the UI thread through VersionedState.
+// Large parts are shared between versions and only replaced when they change, so publishing
+// a new version after a status update does not copy the article list. Quantities and order
+// displays are PersistentVectors: an update clones only the chunks of the articles it changed.
+// Only depends on the standard library.
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "ArticleStore.h"
+#include "OrderTable.h"
+#include "PersistentVector.h"
+
+namespace RowaPickupSlim
+{
+    /// Display order of one article row (the article's oldest active order)
+    struct OrderDisplay
+    {
+        bool hasOrder = false;
+        bool isOurOutput = false;
+        OutputStatus status = OutputStatus::Other;
+        int quantityRequested = 0;
+        int packsDelivered = 0;
+    };
+
+    struct StateSnapshot
+    {
+        std::string connectionState = "Not connected";
+        std::string robotState = "unknown";
+        std::string lastMessageType;
+
+        /// Device status: (type, description, state, stateText)
+        std::vector<std::tuple<std::string,std::string,std::string,std::string>> devices;
+
+        std::shared_ptr<const std::vector<std::string>> articleIds;     // By store index, replaced on StockInfoResponse
+        PersistentVector<int> quantities;                               // By store index
+        std::shared_ptr<const std::vector<uint32_t>> rows;              // Store indices of the filtered rows, null = all
+        PersistentVector<OrderDisplay> orders;                          // By store index
+
+        /// Number of rows in the (filtered) article list
+        size_t RowCount() const;
+
+        /// Read one row of the (filtered) article list
+        /// @return false if row is out of range
+        bool GetRow(size_t row, std::string& articleId, int& quantity, OrderDisplay& order) const;
+    };
+
+    /// Builders for the shared parts, called by the writer that owns the source objects
+    namespace Snapshots
+    {
+        std::shared_ptr<const std::vector<std::string>> ArticleIds(const ArticleStore& store);
+
+        /// Quantity for every store index (full rebuild, after a new article list)
+        PersistentVector<int> Quantities(const ArticleStore& store);
+
+        /// previous with the quantities of the changed articles refreshed
+        PersistentVector<int> Quantities(const PersistentVector<int>& previous, const ArticleStore& store,
+            const std::vector<std::string>& changedArticleIds);
+
+        /// @return null if the view shows every article
+        std::shared_ptr<const std::vector<uint32_t>> Rows(const ArticleView& view);
+
+        /// Display order for every store index (full rebuild, after a new article list)
+        PersistentVector<OrderDisplay> Orders(const ArticleStore& store, const OrderTable& orders);
+
+        /// previous with the display orders of the changed articles refreshed (after orders of those articles changed)
+        PersistentVector<OrderDisplay> Orders(const PersistentVector<OrderDisplay>& previous, const ArticleStore& store,
+            const OrderTable& orders, const std::vector<std::string>& changedArticleIds);
+    }
+}
@@ -0,0 +1,211 @@
+// StockInfoStreamParser.cpp
+// Streaming StockInfoResponse reader implementation
+
+#include "StockInfoStreamParser.h"
+#include "WwksClassifier.h"
+#include <charconv>
+#include <cstring>
+
+namespace RowaPickupSlim
+{
+    static bool StartsWith(std::string_view s, std::string_view prefix)
+    {
+        return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+    }
+
+    static bool EndsWith(std::string_view s, std::string_view suffix)
+    {
+        return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // Comments, CDATA, processing instructions and DOCTYPE: true once the terminator is buffered
+    static bool IsSpecialComplete(std::string_view s)
+    {
+        if (StartsWith(s, "<!--")) return s.size() >= 7 && EndsWith(s, "-->");
+        if (StartsWith(s, "<![CDATA[")) return s.size() >= 12 && EndsWith(s, "]]>");
+        if (StartsWith(s, "<?")) return s.size() >= 4 && EndsWith(s, "?>");
+        if (StartsWith(std::string_view("<!--"), s) || StartsWith(std::string_view("<![CDATA["), s)) return false;
+        return EndsWith(s, ">");
+    }
+
+    // Decode the five predefined XML entities; returns the input unchanged if there are none
+    static std::string_view DecodeEntities(std::string_view value, std::string& scratch)
+    {
+        if (value.find('&') == std::string_view::npos) return value;
+
+        scratch.clear();
+        for (size_t i = 0; i < value.size(); i++)
+        {
+            if (value[i] == '&')
+            {
+                std::string_view rest = value.substr(i);
+                if (StartsWith(rest, "&amp;")) { scratch.push_back('&'); i += 4; continue; }
+                if (StartsWith(rest, "&lt;")) { scratch.push_back('<'); i += 3; continue; }
+                if (StartsWith(rest, "&gt;")) { scratch.push_back('>'); i += 3; continue; }
+                if (StartsWith(rest, "&quot;")) { scratch.push_back('"'); i += 5; continue; }
+                if (StartsWith(rest, "&apos;")) { scratch.push_back('\''); i += 5; continue; }
+            }
+            scratch.push_back(value[i]);
+        }
+        return scratch;
+    }
+
+    StockInfoStreamParser::StockInfoStreamParser(ArticleCallback onArticle)
+        : _onArticle(std::move(onArticle))
+    {
+    }
+
+    void StockInfoStreamParser::Reset()
+    {
+        _mode = Mode::Text;
+        _quote = 0;
+        _pending.clear();
+        _depth = 0;
+        _responseDepth = -1;
+        _complete = false;
+        _articleCount = 0;
+    }
+
+    void StockInfoStreamParser::Feed(const char* data, size_t length)
+    {
+        const char* p = data;
+        const char* end = data + length;
+
+        while (p < end)
+        {
+            if (_mode == Mode::Text)
+            {
+                // Character data between tags is irrelevant for stock; jump to the next tag
+                const void* lt = std::memchr(p, '<', static_cast<size_t>(end - p));
+                if (!lt) return;
+                p = static_cast<const char*>(lt);
+                _pending.clear();
+                _quote = 0;
+
+                if (p + 1 >= end)
+                {
+                    // Cannot tell the tag kind yet; continue in the next chunk
+                    _pending.push_back('<');
+                    _mode = Mode::Tag;
+                    return;
+                }
+                if (p[1] == '!' || p[1] == '?')
+                {
+                    _mode = Mode::Special;
+                    continue;
+                }
+
+                // Fast path: the whole tag is inside this chunk, process it in place
+                const char* q = p + 1;
+                char quote = 0;
+                for (; q < end; ++q)
+                {
+                    char c = *q;
+                    if (quote) { if (c == quote) quote = 0; }
+                    else if (c == '"' || c == '\'') quote = c;
+                    else if (c == '>') break;
+                }
+                if (q < end)
+                {
+                    ProcessTag(std::string_view(p, static_cast<size_t>(q - p + 1)));
+                    p = q + 1;
+                    continue;
+                }
+
+                _pending.assign(p, end);
+                _quote = quote;
+                _mode = Mode::Tag;
+                return;
+            }
+
+            if (_mode == Mode::Tag)
+            {
+                // Continuation of a tag that started in an earlier chunk
+                if (_pending.size() == 1 && (*p == '!' || *p == '?'))
+                {
+                    _mode = Mode::Special;
+                    continue;
+                }
+
+                const char* q = p;
+                for (; q < end; ++q)
+                {
+                    char c = *q;
+                    if (_quote) { if (c == _quote) _quote = 0; }
+                    else if (c == '"' || c == '\'') _quote = c;
+                    else if (c == '>') break;
+                }
+                if (q < end)
+                {
+                    _pending.append(p, q + 1);
+                    ProcessTag(_pending);
+                    _pending.clear();
+                    _mode = Mode::Text;
+                    p = q + 1;
+                    continue;
+                }
+                _pending.append(p, end);
+                return;
+            }
+
+            // Mode::Special - rare, accumulate byte by byte until its terminator
+            _pending.push_back(*p++);
+            if (IsSpecialComplete(_pending))
+            {
+                _pending.clear();
+                _mode = Mode::Text;
+            }
+        }
+    }
+
+    void StockInfoStreamParser::ProcessTag(std::string_view tag)
+    {
+        if (tag.size() < 3) return;
+
+        bool isEndTag = (tag[1] == '/');
+        size_t nameStart = isEndTag ? 2 : 1;
+        size_t nameEnd = nameStart;
+        while (nameEnd < tag.size() && tag[nameEnd] != ' ' && tag[nameEnd] != '\t' && tag[nameEnd] != '\r' &&
+               tag[nameEnd] != '\n' && tag[nameEnd] != '/' && tag[nameEnd] != '>')
+            nameEnd++;
+        std::string_view name = tag.substr(nameStart, nameEnd - nameStart);
+
+        if (isEndTag)
+        {
+            if (_depth > 0) _depth--;
+            if (_responseDepth >= 0 && _depth == _responseDepth && name == "StockInfoResponse")
+            {
+                _complete = true;
+                _responseDepth = -1;
+            }
+            return;
+        }
+
+        bool selfClosing = tag[tag.size() - 2] == '/';
+
+        if (_responseDepth < 0)
+        {
+            if (name == "StockInfoResponse" && !_complete)
+            {
+                if (selfClosing)
+                    _complete = true;   // Empty stock
+                else
+                    _responseDepth = _depth;
+            }
+        }
+        else if (_depth == _responseDepth + 1 && name == "Article")
+        {
+            std::string_view id;
+            std::string_view quantity;
+            int qty = 0;
+            FindTagAttribute(tag, "Id", id);
+            if (FindTagAttribute(tag, "Quantity", quantity))
+                std::from_chars(quantity.data(), quantity.data() + quantity.size(), qty);
+
+            _articleCount++;
+            if (_onArticle) _onArticle(DecodeEntities(id, _decoded), qty);
+        }
+
+        if (!selfClosing) _depth++;
+    }
+}
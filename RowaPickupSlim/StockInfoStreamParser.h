@@ -0,0 +1,50 @@
+#pragma once
+// StockInfoStreamParser.h
+// SAX-style StockInfoResponse reader: emits each <Article> as it is scanned, without building a DOM.
+// Input can be fed in arbitrary chunks; memory use is bounded by the longest single tag,
+// independent of the number of articles. Only depends on the standard library.
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace RowaPickupSlim
+{
+    class StockInfoStreamParser
+    {
+    public:
+        /// Called for every <Article> directly below <StockInfoResponse>.
+        /// The id view is only valid during the call.
+        using ArticleCallback = std::function<void(std::string_view id, int quantity)>;
+
+        explicit StockInfoStreamParser(ArticleCallback onArticle);
+
+        /// Feed the next chunk of the message. Chunks may split tags anywhere.
+        void Feed(const char* data, size_t length);
+
+        /// @return true if a complete <StockInfoResponse> element was seen
+        bool IsComplete() const { return _complete; }
+
+        /// Number of articles reported so far
+        size_t GetArticleCount() const { return _articleCount; }
+
+        /// Prepare for a new message (keeps allocated capacity)
+        void Reset();
+
+    private:
+        enum class Mode { Text, Tag, Special };
+
+        void ProcessTag(std::string_view tag);
+
+        ArticleCallback _onArticle;
+        Mode _mode = Mode::Text;
+        char _quote = 0;             // Open quote character while inside a tag
+        std::string _pending;        // Bytes of a tag that started in a previous chunk
+        std::string _decoded;        // Scratch buffer for Id values that contain entities
+        int _depth = 0;              // Open element count
+        int _responseDepth = -1;     // Depth of <StockInfoResponse>, -1 if not inside one
+        bool _complete = false;
+        size_t _articleCount = 0;
+    };
+}
@@ -0,0 +1,260 @@
+// TcpConnector.cpp
+// Racing non-blocking connect implementation
+
+#include "TcpConnector.h"
+#include <algorithm>
+#include <vector>
+
+#ifdef _WIN32
+#include <ws2tcpip.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace RowaPickupSlim
+{
+#ifdef _WIN32
+    using PollFd = WSAPOLLFD;
+    static constexpr short POLL_WRITE = POLLWRNORM;
+
+    static int LastSocketError() { return WSAGetLastError(); }
+    static bool InProgress(int error) { return error == WSAEWOULDBLOCK || error == WSAEINPROGRESS; }
+    static void CloseSocket(SocketHandle s) { closesocket(s); }
+    static int PollSockets(PollFd* fds, size_t count, int timeoutMs) { return WSAPoll(fds, static_cast<ULONG>(count), timeoutMs); }
+
+    static bool SetNonBlocking(SocketHandle s, bool enable)
+    {
+        u_long mode = enable ? 1 : 0;
+        return ioctlsocket(s, FIONBIO, &mode) == 0;
+    }
+#else
+    using PollFd = pollfd;
+    static constexpr short POLL_WRITE = POLLOUT;
+
+    static int LastSocketError() { return errno; }
+    static bool InProgress(int error) { return error == EINPROGRESS || error == EWOULDBLOCK || error == EINTR; }
+    static void CloseSocket(SocketHandle s) { close(s); }
+    static int PollSockets(PollFd* fds, size_t count, int timeoutMs) { return poll(fds, static_cast<nfds_t>(count), timeoutMs); }
+
+    static bool SetNonBlocking(SocketHandle s, bool enable)
+    {
+        int flags = fcntl(s, F_GETFL, 0);
+        if (flags < 0) return false;
+        flags = enable ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+        return fcntl(s, F_SETFL, flags) == 0;
+    }
+#endif
+
+    static int PendingError(SocketHandle s)
+    {
+        int error = 0;
+        socklen_t length = sizeof(error);
+        if (getsockopt(s, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &length) != 0)
+            return LastSocketError();
+        return error;
+    }
+
+    static std::string FormatAddress(const addrinfo* ai)
+    {
+        char host[NI_MAXHOST] = {};
+        char service[NI_MAXSERV] = {};
+        if (getnameinfo(ai->ai_addr, static_cast<socklen_t>(ai->ai_addrlen), host, sizeof(host), service, sizeof(service),
+                        NI_NUMERICHOST | NI_NUMERICSERV) != 0)
+            return std::string();
+        if (ai->ai_family == AF_INET6)
+            return "[" + std::string(host) + "]:" + service;
+        return std::string(host) + ":" + service;
+    }
+
+    // Alternate address families, keeping the resolver's order within each family
+    static std::vector<const addrinfo*> InterleaveFamilies(const addrinfo* list)
+    {
+        std::vector<const addrinfo*> first, second;
+        int firstFamily = list ? list->ai_family : 0;
+        for (const addrinfo* ai = list; ai != nullptr; ai = ai->ai_next)
+            (ai->ai_family == firstFamily ? first : second).push_back(ai);
+
+        std::vector<const addrinfo*> ordered;
+        ordered.reserve(first.size() + second.size());
+        for (size_t i = 0; i < std::max(first.size(), second.size()); i++)
+        {
+            if (i < first.size()) ordered.push_back(first[i]);
+            if (i < second.size()) ordered.push_back(second[i]);
+        }
+        return ordered;
+    }
+
+    TcpConnector::Result TcpConnector::Connect(const std::string& host, int port, const Options& options)
+    {
+        // Granularity of the cancellation check while nothing else is due
+        static constexpr auto CANCEL_POLL = std::chrono::milliseconds(100);
+
+        Result result;
+        Clock::time_point start = Clock::now();
+        Clock::time_point deadline = start + options.timeout;
+
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_protocol = IPPROTO_TCP;
+
+        addrinfo* list = nullptr;
+        std::string portStr = std::to_string(port);
+        int resolveError = getaddrinfo(host.c_str(), portStr.c_str(), &hints, &list);
+        if (resolveError != 0)
+        {
+            result.error = resolveError;
+            result.elapsed = Clock::now() - start;
+            return result;
+        }
+        result.resolved = true;
+
+        std::vector<const addrinfo*> candidates = InterleaveFamilies(list);
+        result.candidates = candidates.size();
+
+        struct Attempt
+        {
+            SocketHandle socket;
+            const addrinfo* address;
+        };
+        std::vector<Attempt> active;
+        std::vector<PollFd> fds;
+        size_t next = 0;
+        Clock::time_point nextStart = start;
+        const addrinfo* winner = nullptr;
+
+        while (winner == nullptr)
+        {
+            Clock::time_point now = Clock::now();
+            if (options.cancelled && options.cancelled())
+            {
+                result.cancelled = true;
+                break;
+            }
+            if (now >= deadline)
+            {
+                result.timedOut = true;
+                break;
+            }
+
+            // Start the next candidate when its head start is over, or at once if nothing is in flight
+            if (next < candidates.size() && (now >= nextStart || active.empty()))
+            {
+                const addrinfo* ai = candidates[next++];
+                result.attempts++;
+
+                SocketHandle s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+                if (s == INVALID_SOCKET_HANDLE)
+                {
+                    result.error = LastSocketError();
+                    continue;
+                }
+                if (!SetNonBlocking(s, true))
+                {
+                    result.error = LastSocketError();
+                    CloseSocket(s);
+                    continue;
+                }
+
+                if (connect(s, ai->ai_addr, static_cast<socklen_t>(ai->ai_addrlen)) == 0)
+                {
+                    active.push_back({ s, ai });
+                    winner = ai;
+                    break;
+                }
+
+                int error = LastSocketError();
+                if (!InProgress(error))
+                {
+                    result.error = error;       // e.g. refused at once on loopback: try the next one now
+                    CloseSocket(s);
+                    continue;
+                }
+
+                active.push_back({ s, ai });
+                nextStart = now + options.attemptDelay;
+                continue;
+            }
+
+            if (active.empty())
+                break;      // Every candidate failed
+
+            Clock::time_point wakeAt = std::min(deadline, now + CANCEL_POLL);
+            if (next < candidates.size())
+                wakeAt = std::min(wakeAt, nextStart);
+            auto waitMs = std::chrono::duration_cast<std::chrono::milliseconds>(wakeAt - now).count();
+
+            fds.resize(active.size());
+            for (size_t i = 0; i < active.size(); i++)
+            {
+                fds[i] = PollFd{};
+                fds[i].fd = active[i].socket;
+                fds[i].events = POLL_WRITE;
+            }
+
+            // Rounded up, so the loop does not spin through the last partial millisecond
+            int ready = PollSockets(fds.data(), fds.size(), static_cast<int>(std::max<long long>(waitMs, 0) + 1));
+            if (ready <= 0)
+                continue;
+
+            size_t kept = 0;
+            for (size_t i = 0; i < active.size(); i++)
+            {
+                short revents = fds[i].revents;
+                if (revents == 0)
+                {
+                    active[kept++] = active[i];
+                    continue;
+                }
+
+                int error = PendingError(active[i].socket);
+                if (error == 0 && (revents & POLL_WRITE) && winner == nullptr)
+                {
+                    winner = active[i].address;
+                    active[kept++] = active[i];
+                    continue;
+                }
+
+                if (error != 0) result.error = error;
+                CloseSocket(active[i].socket);
+                nextStart = Clock::now();       // A failed attempt hands over to the next one at once
+            }
+            active.resize(kept);
+        }
+
+        // Keep the winner, close the losers
+        for (const Attempt& attempt : active)
+        {
+            if (attempt.address == winner)
+                result.socket = attempt.socket;
+            else
+                CloseSocket(attempt.socket);
+        }
+
+        if (result.socket != INVALID_SOCKET_HANDLE)
+        {
+            if (SetNonBlocking(result.socket, false))
+            {
+                result.error = 0;
+                result.address = FormatAddress(winner);
+                result.family = winner->ai_family;
+            }
+            else
+            {
+                result.error = LastSocketError();
+                CloseSocket(result.socket);
+                result.socket = INVALID_SOCKET_HANDLE;
+            }
+        }
+
+        freeaddrinfo(list);
+        result.elapsed = Clock::now() - start;
+        return result;
+    }
+}
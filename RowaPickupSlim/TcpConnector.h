@@ -0,0 +1,49 @@
+#pragma once
+// TcpConnector.h
+// Non-blocking TCP connect with an overall deadline.
+// All resolved addresses are raced "happy eyeballs" style (RFC 8305): families alternate,
+// a new attempt starts every attemptDelay (or as soon as the previous one fails) and the
+// first connection to complete wins; the others are closed.
+// Does not take any lock, so callers can connect without blocking their senders.
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include "Reactor.h"
+
+namespace RowaPickupSlim
+{
+    class TcpConnector
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Options
+        {
+            Clock::duration timeout = std::chrono::seconds(10);             // Whole connect, all addresses
+            Clock::duration attemptDelay = std::chrono::milliseconds(250);  // Head start of each attempt
+            std::function<bool()> cancelled;    // Polled while waiting; true abandons the connect
+        };
+
+        struct Result
+        {
+            SocketHandle socket = INVALID_SOCKET_HANDLE;    // Connected, blocking mode; caller owns it
+            bool resolved = false;      // Name resolution succeeded
+            bool timedOut = false;
+            bool cancelled = false;
+            int error = 0;              // Last socket error (errno / WSA code), or the getaddrinfo error
+            std::string address;        // Winner, e.g. "192.168.1.20:6050" or "[fe80::1]:6050"
+            int family = 0;             // AF_INET / AF_INET6 of the winner
+            size_t candidates = 0;      // Resolved addresses
+            size_t attempts = 0;        // Connects started
+            Clock::duration elapsed{};
+
+            bool Connected() const { return socket != INVALID_SOCKET_HANDLE; }
+        };
+
+        /// Resolve host and connect to the first address that answers.
+        /// On Windows, Winsock must already be initialized.
+        static Result Connect(const std::string& host, int port, const Options& options);
+    };
+}
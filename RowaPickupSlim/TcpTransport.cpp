@@ -0,0 +1,271 @@
+// TcpTransport.cpp
+// TCP socket transport implementation
+
+#include "TcpTransport.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mstcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <cerrno>
+#include <climits>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0      // No SIGPIPE suppression flag (macOS); SO_NOSIGPIPE would be needed there
+#endif
+#endif
+
+namespace RowaPickupSlim
+{
+    // Bytes asked from the receiver per recv()
+    static constexpr size_t READ_SIZE = 8192;
+    // Buffers per gathering write (more are left for the next call)
+    static constexpr size_t MAX_GATHER = 1024;
+
+    TcpTransport::TcpTransport(SocketHandle socket, std::string peer)
+        : _socket(socket), _peer(std::move(peer))
+    {
+    }
+
+    TcpTransport::~TcpTransport()
+    {
+        if (_socket != INVALID_SOCKET_HANDLE)
+        {
+#ifdef _WIN32
+            closesocket(_socket);
+#else
+            close(_socket);
+#endif
+        }
+    }
+
+    bool TcpTransport::Startup()
+    {
+#ifdef _WIN32
+        WSADATA wsaData;
+        return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+#else
+        return true;
+#endif
+    }
+
+    void TcpTransport::Cleanup()
+    {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+
+    int TcpTransport::LastError()
+    {
+#ifdef _WIN32
+        return WSAGetLastError();
+#else
+        return errno;
+#endif
+    }
+
+    bool TcpTransport::Start(Reactor& reactor, Receiver receiver)
+    {
+        _receiver = std::move(receiver);
+        if (!reactor.Add(_socket, Reactor::Readable, [this](uint32_t) { OnReadable(); }))
+            return false;
+        _reactor = &reactor;
+        _paused = false;
+        return true;
+    }
+
+    void TcpTransport::Stop()
+    {
+        if (_reactor)
+        {
+            _reactor->Remove(_socket);
+            _reactor = nullptr;
+        }
+    }
+
+    void TcpTransport::PauseReceive(bool paused)
+    {
+        if (!_reactor || paused == _paused) return;
+
+        // Not registered while paused: a level-triggered poller would report the socket readable again and again
+        _paused = paused;
+        if (paused)
+            _reactor->Remove(_socket);
+        else
+            _reactor->Add(_socket, Reactor::Readable, [this](uint32_t) { OnReadable(); });
+    }
+
+    // Called only when the socket is readable, so recv() returns without waiting
+    void TcpTransport::OnReadable()
+    {
+        // Receive straight into the receiver's buffer to avoid an extra copy per chunk
+        char* buffer = _receiver.Prepare(READ_SIZE);
+#ifdef _WIN32
+        int bytesRead = ::recv(_socket, buffer, static_cast<int>(READ_SIZE), 0);
+        if (bytesRead == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK)
+            return;
+#else
+        ssize_t bytesRead = ::recv(_socket, buffer, READ_SIZE, 0);
+        if (bytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+            return;
+#endif
+
+        if (bytesRead > 0)
+        {
+            _receiver.Commit(static_cast<size_t>(bytesRead));
+            return;
+        }
+
+        // Closed by the peer (0) or broken: nothing more will arrive
+        int error = bytesRead == 0 ? 0 : LastError();
+        Stop();
+        if (_receiver.Closed) _receiver.Closed(error);
+    }
+
+    bool TcpTransport::Write(const Buffer* buffers, size_t count, size_t& written, int& error)
+    {
+        written = 0;
+        count = std::min(count, MAX_GATHER);
+#ifdef _WIN32
+        WSABUF gather[MAX_GATHER];
+        for (size_t i = 0; i < count; i++)
+        {
+            gather[i].buf = const_cast<char*>(buffers[i].data);
+            gather[i].len = static_cast<ULONG>(buffers[i].size);
+        }
+        DWORD sent = 0;
+        if (::WSASend(_socket, gather, static_cast<DWORD>(count), &sent, 0, nullptr, nullptr) == SOCKET_ERROR)
+        {
+            error = WSAGetLastError();
+            return false;
+        }
+        written = sent;
+        return true;
+#else
+        iovec gather[MAX_GATHER];
+        count = std::min<size_t>(count, IOV_MAX);
+        for (size_t i = 0; i < count; i++)
+        {
+            gather[i].iov_base = const_cast<char*>(buffers[i].data);
+            gather[i].iov_len = buffers[i].size;
+        }
+        msghdr msg{};
+        msg.msg_iov = gather;
+        msg.msg_iovlen = count;
+        for (;;)
+        {
+            ssize_t sent = ::sendmsg(_socket, &msg, MSG_NOSIGNAL);
+            if (sent >= 0)
+            {
+                written = static_cast<size_t>(sent);
+                return true;
+            }
+            if (errno != EINTR)
+            {
+                error = errno;
+                return false;
+            }
+        }
+#endif
+    }
+
+    void TcpTransport::Shutdown()
+    {
+        if (_shutdown.exchange(true)) return;
+#ifdef _WIN32
+        ::shutdown(_socket, SD_BOTH);
+#else
+        ::shutdown(_socket, SHUT_RDWR);
+#endif
+    }
+
+    std::string TcpTransport::Describe() const
+    {
+        return "tcp " + _peer;
+    }
+
+    bool TcpTransport::SetNoDelay(bool on, int& error)
+    {
+#ifdef _WIN32
+        BOOL value = on ? TRUE : FALSE;
+        if (setsockopt(_socket, IPPROTO_TCP, TCP_NODELAY, (const char*)&value, sizeof(value)) == SOCKET_ERROR)
+        {
+            error = WSAGetLastError();
+            return false;
+        }
+#else
+        int value = on ? 1 : 0;
+        if (setsockopt(_socket, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value)) != 0)
+        {
+            error = errno;
+            return false;
+        }
+#endif
+        return true;
+    }
+
+    bool TcpTransport::SetKeepAlive(std::chrono::milliseconds idle, std::chrono::milliseconds interval, int& error)
+    {
+#ifdef _WIN32
+        BOOL keepAlive = TRUE;
+        if (setsockopt(_socket, SOL_SOCKET, SO_KEEPALIVE, (const char*)&keepAlive, sizeof(keepAlive)) == SOCKET_ERROR)
+        {
+            error = WSAGetLastError();
+            return false;
+        }
+
+        // Default keepalive starts probing after 2 hours; Windows fixes the probe count itself
+        tcp_keepalive vals{};
+        vals.onoff = 1;
+        vals.keepalivetime = static_cast<ULONG>(idle.count());
+        vals.keepaliveinterval = static_cast<ULONG>(interval.count());
+        DWORD returned = 0;
+        if (WSAIoctl(_socket, SIO_KEEPALIVE_VALS, &vals, sizeof(vals), nullptr, 0, &returned, nullptr, nullptr) == SOCKET_ERROR)
+        {
+            error = WSAGetLastError();
+            return false;
+        }
+        return true;
+#else
+        int on = 1;
+        if (setsockopt(_socket, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on)) != 0)
+        {
+            error = errno;
+            return false;
+        }
+
+        // Whole seconds here, at least 1
+        int idleSeconds = static_cast<int>(std::max<long long>(1, std::chrono::duration_cast<std::chrono::seconds>(idle).count()));
+        int intervalSeconds = static_cast<int>(std::max<long long>(1, std::chrono::duration_cast<std::chrono::seconds>(interval).count()));
+#if defined(TCP_KEEPIDLE)
+        if (setsockopt(_socket, IPPROTO_TCP, TCP_KEEPIDLE, &idleSeconds, sizeof(idleSeconds)) != 0)
+#elif defined(TCP_KEEPALIVE)
+        if (setsockopt(_socket, IPPROTO_TCP, TCP_KEEPALIVE, &idleSeconds, sizeof(idleSeconds)) != 0)
+#else
+        if (false)
+#endif
+        {
+            error = errno;
+            return false;
+        }
+#if defined(TCP_KEEPINTVL)
+        if (setsockopt(_socket, IPPROTO_TCP, TCP_KEEPINTVL, &intervalSeconds, sizeof(intervalSeconds)) != 0)
+        {
+            error = errno;
+            return false;
+        }
+#else
+        (void)intervalSeconds;
+#endif
+        return true;
+#endif
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+// TcpTransport.h
+// Transport over a connected TCP socket (Winsock on Windows, BSD sockets elsewhere).
+// Reads are driven by the Reactor; writes are gathering sendmsg / WSASend calls.
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include "Reactor.h"
+#include "Transport.h"
+
+namespace RowaPickupSlim
+{
+    class TcpTransport : public Transport
+    {
+    public:
+        /// Takes ownership of a connected socket in blocking mode
+        /// @param peer Remote address for Describe(), e.g. "192.168.1.20:6050"
+        TcpTransport(SocketHandle socket, std::string peer);
+        ~TcpTransport() override;
+
+        bool Start(Reactor& reactor, Receiver receiver) override;
+        void Stop() override;
+        void PauseReceive(bool paused) override;
+        bool Write(const Buffer* buffers, size_t count, size_t& written, int& error) override;
+        void Shutdown() override;
+        std::string Describe() const override;
+
+        SocketHandle GetSocket() const { return _socket; }
+
+        /// Enable TCP keepalive: first probe after idle, then every interval
+        /// @return false with error set if the socket refused the options
+        bool SetKeepAlive(std::chrono::milliseconds idle, std::chrono::milliseconds interval, int& error);
+
+        /// Disable Nagle's algorithm. The SendQueue already coalesces what queued up into one write;
+        /// Nagle would hold a small write back until the previous one is acknowledged (up to the
+        /// peer's delayed-ACK timeout, ~40 ms).
+        bool SetNoDelay(bool on, int& error);
+
+        /// Winsock initialization / release (no-ops on other systems)
+        static bool Startup();
+        static void Cleanup();
+
+        /// Error code of the last failed socket call (WSAGetLastError / errno)
+        static int LastError();
+
+    private:
+        void OnReadable();
+
+        SocketHandle _socket;
+        std::string _peer;
+        Reactor* _reactor = nullptr;        // While started
+        bool _paused = false;               // Removed from the reactor by PauseReceive()
+        Receiver _receiver;
+        std::atomic<bool> _shutdown{ false };
+    };
+}
@@ -0,0 +1,335 @@
+// TrafficCapture.cpp
+// Binary WWKS traffic capture writer / reader implementation
+
+#include "TrafficCapture.h"
+#include <algorithm>
+#include <cstring>
+#ifdef _WIN32
+#include <share.h>
+#endif
+
+namespace RowaPickupSlim
+{
+    static const char CAPTURE_MAGIC[8] = { 'W', 'W', 'K', 'S', 'C', 'A', 'P', 0x01 };
+    static constexpr size_t HEADER_SIZE = sizeof(CAPTURE_MAGIC) + 8;
+    static constexpr size_t BATCH_BYTES = 64 * 1024;                 // Wake the writer once this much is pending
+    static constexpr size_t MAX_KEPT_CAPACITY = 4 * 1024 * 1024;     // Release buffers that held a huge batch
+    static constexpr uint64_t MAX_FRAME_BYTES = 1ull << 30;          // Larger lengths mean a corrupt record
+    static constexpr auto IDLE_WAIT = std::chrono::milliseconds(250);
+
+    static std::FILE* OpenFile(const std::string& path, const char* mode)
+    {
+#ifdef _WIN32
+        // Shared so a running capture can be copied or replayed
+        return _fsopen(path.c_str(), mode, _SH_DENYNO);
+#else
+        return std::fopen(path.c_str(), mode);
+#endif
+    }
+
+    static void AppendVarint(std::string& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    // ========================================================================
+    // TrafficCaptureWriter
+    // ========================================================================
+
+    TrafficCaptureWriter::TrafficCaptureWriter(size_t maxPendingBytes)
+        : _maxPending(maxPendingBytes)
+    {
+    }
+
+    TrafficCaptureWriter::~TrafficCaptureWriter()
+    {
+        Stop();
+    }
+
+    bool TrafficCaptureWriter::Open(const std::string& path)
+    {
+        std::lock_guard<std::mutex> stopLock(_stopMtx);
+        if (_running.load()) return true;
+
+        _file = OpenFile(path, "wb");
+        if (!_file) return false;
+
+        uint64_t wallMicros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+
+        // The header is written here, so the backlog holds records only
+        char header[HEADER_SIZE];
+        std::memcpy(header, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+        for (int i = 0; i < 8; i++)
+            header[sizeof(CAPTURE_MAGIC) + i] = static_cast<char>((wallMicros >> (8 * i)) & 0xFF);
+        if (std::fwrite(header, 1, sizeof(header), _file) != sizeof(header))
+        {
+            std::fclose(_file);
+            _file = nullptr;
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        _pending.clear();
+        _opened = _last = Clock::now();
+        _appended = 0;
+        _written = 0;
+        _gapFrames = 0;
+        _gapBytes = 0;
+        _stopping = false;
+        _failed = false;
+        _counters = Counters();
+        _counters.bytes = sizeof(header);
+
+        _running.store(true, std::memory_order_release);
+        _writer = std::thread(&TrafficCaptureWriter::WriterLoop, this);
+        return true;
+    }
+
+    bool TrafficCaptureWriter::Record(TrafficDirection direction, std::string_view frame, Clock::time_point when)
+    {
+        if (!_running.load(std::memory_order_acquire)) return false;
+
+        std::unique_lock<std::mutex> lock(_mtx);
+        if (_stopping) return false;
+
+        if (_failed)
+        {
+            _counters.dropped++;
+            return false;
+        }
+
+        // The limit bounds the backlog, not a frame: a StockInfoResponse larger than the limit is
+        // accepted once nothing is pending. 1 + 10 + 10: direction and two varints at most
+        if (!_pending.empty() && _pending.size() + frame.size() + 21 > _maxPending)
+        {
+            if (_gapFrames == 0) _gapTime = std::max(when, _last);
+            _gapFrames++;
+            _gapBytes += frame.size();
+            _counters.dropped++;
+            return false;
+        }
+
+        size_t before = _pending.size();
+        if (_gapFrames > 0) AppendGapLocked();
+        AppendLocked(direction, frame, when);
+        _counters.records++;
+
+        bool wake = _pending.size() >= BATCH_BYTES && before < BATCH_BYTES;
+        lock.unlock();
+
+        if (wake) _wake.notify_one();
+        return true;
+    }
+
+    void TrafficCaptureWriter::Flush()
+    {
+        std::unique_lock<std::mutex> lock(_mtx);
+        if (!_running.load()) return;
+
+        uint64_t target = _appended;
+        _flushWaiters++;
+        _wake.notify_one();
+        _flushed.wait(lock, [&]() { return _written >= target || _failed || !_running.load(); });
+        _flushWaiters--;
+    }
+
+    void TrafficCaptureWriter::Stop()
+    {
+        std::lock_guard<std::mutex> stopLock(_stopMtx);
+        if (!_running.load()) return;
+
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            if (_gapFrames > 0 && !_failed) AppendGapLocked();
+            _stopping = true;
+        }
+        _wake.notify_one();
+        if (_writer.joinable()) _writer.join();
+
+        std::fclose(_file);
+        _file = nullptr;
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        _running.store(false, std::memory_order_release);
+        _flushed.notify_all();
+    }
+
+    TrafficCaptureWriter::Counters TrafficCaptureWriter::GetCounters() const
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _counters;
+    }
+
+    // Private: encode one record into _pending
+    void TrafficCaptureWriter::AppendLocked(TrafficDirection direction, std::string_view frame, Clock::time_point when)
+    {
+        // Records from different threads can arrive slightly out of order; never go back in time
+        if (when < _last) when = _last;
+        uint64_t delta = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(when - _last).count());
+        _last = when;
+
+        size_t before = _pending.size();
+        _pending.push_back(static_cast<char>(direction));
+        AppendVarint(_pending, delta);
+        AppendVarint(_pending, frame.size());
+        _pending.append(frame.data(), frame.size());
+        _appended += _pending.size() - before;
+    }
+
+    // Private: mark the frames dropped since the last record, at the time of the first of them
+    void TrafficCaptureWriter::AppendGapLocked()
+    {
+        std::string note = std::to_string(_gapFrames) + " frames, " + std::to_string(_gapBytes) +
+                           " bytes dropped: capture backlog full";
+        AppendLocked(TrafficDirection::Gap, note, _gapTime);
+        _gapFrames = 0;
+        _gapBytes = 0;
+    }
+
+    void TrafficCaptureWriter::WriterLoop()
+    {
+        std::unique_lock<std::mutex> lock(_mtx);
+        while (true)
+        {
+            // A waiting Flush() only wakes the writer while there is something to write; otherwise the
+            // loop would spin holding the lock and the waiter could never return
+            _wake.wait_for(lock, IDLE_WAIT, [&]() {
+                return _stopping || (_flushWaiters > 0 && !_pending.empty()) || _pending.size() >= BATCH_BYTES;
+            });
+
+            if (!_pending.empty() && !_failed)
+            {
+                // Records keep being appended to the other buffer while this one is written
+                _writing.swap(_pending);
+                lock.unlock();
+
+                bool ok = std::fwrite(_writing.data(), 1, _writing.size(), _file) == _writing.size() &&
+                          std::fflush(_file) == 0;
+
+                lock.lock();
+                _written += _writing.size();
+                if (ok)
+                {
+                    _counters.bytes += _writing.size();
+                    _counters.writes++;
+                }
+                else
+                {
+                    // Disk full or the file went away: stop capturing rather than write a corrupt tail
+                    _failed = true;
+                    _pending.clear();
+                }
+
+                if (_writing.capacity() > MAX_KEPT_CAPACITY)
+                    std::string().swap(_writing);
+                else
+                    _writing.clear();
+
+                _flushed.notify_all();
+                continue;
+            }
+
+            if (_failed) _pending.clear();
+            _flushed.notify_all();
+            if (_stopping) break;
+        }
+    }
+
+    // ========================================================================
+    // TrafficCaptureReader
+    // ========================================================================
+
+    TrafficCaptureReader::~TrafficCaptureReader()
+    {
+        Close();
+    }
+
+    bool TrafficCaptureReader::Open(const std::string& path, std::string& error)
+    {
+        Close();
+
+        _file = OpenFile(path, "rb");
+        if (!_file)
+        {
+            error = "cannot open " + path;
+            return false;
+        }
+
+        unsigned char header[HEADER_SIZE];
+        if (std::fread(header, 1, sizeof(header), _file) != sizeof(header) ||
+            std::memcmp(header, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0)
+        {
+            error = path + " is not a WWKS capture";
+            Close();
+            return false;
+        }
+
+        uint64_t wallMicros = 0;
+        for (int i = 0; i < 8; i++)
+            wallMicros |= static_cast<uint64_t>(header[sizeof(CAPTURE_MAGIC) + i]) << (8 * i);
+
+        _start = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(wallMicros)));
+        _time = std::chrono::nanoseconds(0);
+        _truncated = false;
+        return true;
+    }
+
+    bool TrafficCaptureReader::Next(TrafficRecord& record)
+    {
+        if (!_file) return false;
+
+        int direction = std::fgetc(_file);
+        if (direction == EOF) return false;
+
+        uint64_t delta = 0;
+        uint64_t length = 0;
+        if (direction > static_cast<int>(TrafficDirection::Gap) ||
+            !ReadVarint(delta) || !ReadVarint(length) || length > MAX_FRAME_BYTES)
+        {
+            _truncated = true;
+            return false;
+        }
+
+        record.frame.resize(static_cast<size_t>(length));
+        if (length > 0 && std::fread(&record.frame[0], 1, record.frame.size(), _file) != record.frame.size())
+        {
+            _truncated = true;
+            return false;
+        }
+
+        _time += std::chrono::nanoseconds(delta);
+        record.direction = static_cast<TrafficDirection>(direction);
+        record.time = _time;
+        return true;
+    }
+
+    void TrafficCaptureReader::Close()
+    {
+        if (_file)
+        {
+            std::fclose(_file);
+            _file = nullptr;
+        }
+    }
+
+    bool TrafficCaptureReader::ReadVarint(uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            int c = std::fgetc(_file);
+            if (c == EOF) return false;
+
+            value |= static_cast<uint64_t>(c & 0x7F) << shift;
+            if ((c & 0x80) == 0) return true;
+        }
+        return false;
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+// TrafficCapture.h
+// Compact binary capture of WWKS traffic: every inbound and outbound frame with its direction and
+// a monotonic timestamp. The writer only appends the encoded record to a buffer; a background
+// thread writes the buffer to the file, so the network threads never wait for the disk.
+// TrafficCaptureReader reads a capture back (see TrafficReplay).
+// Only depends on the standard library.
+//
+// File layout (integers little-endian, varint = unsigned LEB128):
+//   header  "WWKSCAP" 0x01 | u64 wall clock when the capture was opened, microseconds since 1970 (UTC)
+//   record  u8 direction (0 inbound, 1 outbound, 2 gap) | varint ns since the previous record (the
+//           first: since the capture was opened) | varint frame length | frame bytes
+// A gap record marks where the writer dropped frames; its "frame" is a note such as
+// "3 frames, 41250 bytes dropped: capture backlog full".
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace RowaPickupSlim
+{
+    enum class TrafficDirection : uint8_t
+    {
+        Inbound = 0,        // Received from the storage system
+        Outbound = 1,       // Sent to the storage system
+        Gap = 2             // Not a frame: the writer dropped frames here (the frame is a note)
+    };
+
+    /// One captured frame
+    struct TrafficRecord
+    {
+        TrafficDirection direction = TrafficDirection::Inbound;
+        std::chrono::nanoseconds time{};    // Since the capture was opened
+        std::string frame;
+    };
+
+    class TrafficCaptureWriter
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Counters
+        {
+            uint64_t records = 0;       // Records accepted
+            uint64_t dropped = 0;       // Records discarded: backlog full (marked by a gap record) or the file could not be written
+            uint64_t bytes = 0;         // Bytes written to the file
+            uint64_t writes = 0;        // File writes (one per batch)
+        };
+
+        /// @param maxPendingBytes Encoded records not yet written before further records are dropped.
+        /// Bounds the backlog only: with nothing pending a record of any size is accepted.
+        explicit TrafficCaptureWriter(size_t maxPendingBytes = 16 * 1024 * 1024);
+        ~TrafficCaptureWriter();
+
+        /// Create (truncate) the capture file, write its header and start the writer thread
+        /// @return false if the file could not be created
+        bool Open(const std::string& path);
+
+        /// Append one frame; thread-safe. when is normally the time the frame was received or queued.
+        /// Timestamps are kept non-decreasing in file order.
+        /// @return false if the record was dropped or the capture is not open
+        bool Record(TrafficDirection direction, std::string_view frame, Clock::time_point when = Clock::now());
+
+        /// Block until every record accepted before this call is written to the file
+        void Flush();
+
+        /// Write all pending records, close the file and stop the writer thread.
+        /// Called by the destructor; safe to call more than once.
+        void Stop();
+
+        bool IsRunning() const { return _running.load(std::memory_order_acquire); }
+
+        Counters GetCounters() const;
+
+    private:
+        void WriterLoop();
+        void AppendLocked(TrafficDirection direction, std::string_view frame, Clock::time_point when);
+        void AppendGapLocked();
+
+        size_t _maxPending;
+
+        mutable std::mutex _mtx;
+        std::condition_variable _wake;          // Wakes the writer
+        std::condition_variable _flushed;       // Wakes Flush() callers
+        std::string _pending;                   // Encoded records, appended by Record()
+        std::string _writing;                   // Swapped with _pending by the writer; capacity is kept
+        Clock::time_point _opened;
+        Clock::time_point _last;                // Timestamp of the last record
+        uint64_t _appended = 0;                 // Bytes appended to _pending, total
+        uint64_t _written = 0;                  // Bytes handed to the file, total
+        uint64_t _gapFrames = 0;                // Dropped since the last record, not yet marked by a gap record
+        uint64_t _gapBytes = 0;
+        Clock::time_point _gapTime;             // Timestamp of the first of them
+        int _flushWaiters = 0;
+        bool _stopping = false;
+        bool _failed = false;                   // A write failed; further records are dropped
+        Counters _counters;
+
+        std::FILE* _file = nullptr;
+        std::thread _writer;
+        std::atomic<bool> _running{ false };
+        std::mutex _stopMtx;                    // Serializes Open() / Stop()
+
+        // non-copyable
+        TrafficCaptureWriter(const TrafficCaptureWriter&) = delete;
+        TrafficCaptureWriter& operator=(const TrafficCaptureWriter&) = delete;
+    };
+
+    class TrafficCaptureReader
+    {
+    public:
+        TrafficCaptureReader() = default;
+        ~TrafficCaptureReader();
+
+        /// Open a capture and read its header
+        /// @return false with error set if the file cannot be read or is not a capture
+        bool Open(const std::string& path, std::string& error);
+
+        /// Read the next record (record.frame keeps its capacity between calls)
+        /// @return false at the end of the capture, or at a record that was cut off (see IsTruncated)
+        bool Next(TrafficRecord& record);
+
+        /// True if the last Next() stopped at an incomplete or corrupt record (e.g. the writer was killed)
+        bool IsTruncated() const { return _truncated; }
+
+        /// Wall clock when the capture was opened
+        std::chrono::system_clock::time_point StartTime() const { return _start; }
+
+        void Close();
+
+    private:
+        bool ReadVarint(uint64_t& value);
+
+        std::FILE* _file = nullptr;
+        std::chrono::system_clock::time_point _start;
+        std::chrono::nanoseconds _time{};
+        bool _truncated = false;
+
+        // non-copyable
+        TrafficCaptureReader(const TrafficCaptureReader&) = delete;
+        TrafficCaptureReader& operator=(const TrafficCaptureReader&) = delete;
+    };
+}
@@ -0,0 +1,118 @@
+// TrafficReplay.cpp
+// Capture replay implementation
+
+#include "TrafficReplay.h"
+#include "TrafficCapture.h"
+#include <thread>
+
+namespace RowaPickupSlim
+{
+    double TrafficReplay::Result::MessagesPerSecond() const
+    {
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        return seconds > 0 ? static_cast<double>(messages) / seconds : 0.0;
+    }
+
+    bool TrafficReplay::Load(const std::string& path, std::string& error)
+    {
+        TrafficCaptureReader reader;
+        if (!reader.Open(path, error)) return false;
+
+        _frames.clear();
+        _gaps = 0;
+        TrafficRecord record;
+        while (reader.Next(record))
+        {
+            if (record.direction == TrafficDirection::Gap) _gaps++;
+            if (record.direction != TrafficDirection::Inbound) continue;
+
+            Frame frame;
+            frame.time = std::chrono::duration_cast<Clock::duration>(record.time);
+            frame.xml = record.frame;
+            _frames.push_back(std::move(frame));
+        }
+        return true;
+    }
+
+    TrafficReplay::Clock::duration TrafficReplay::Duration() const
+    {
+        if (_frames.empty()) return Clock::duration::zero();
+        return _frames.back().time - _frames.front().time;
+    }
+
+    TrafficReplay::Result TrafficReplay::Run(const Options& options, const Handler& handler)
+    {
+        Result result;
+        LatencyHistogram perMessage;
+        _stop.store(false);
+
+        const bool paced = options.speed > 0;
+        const Clock::time_point started = Clock::now();
+
+        // As in the receive path: one reused message, parsed in place over a copy of the frame
+        WwksMessageParser parser;
+        std::string frameCopy;
+
+        for (size_t pass = 0; pass < options.repeat && !result.stopped; pass++)
+        {
+            const Clock::time_point passStart = Clock::now();
+
+            for (const Frame& frame : _frames)
+            {
+                if (_stop.load())
+                {
+                    result.stopped = true;
+                    break;
+                }
+
+                if (paced)
+                {
+                    auto offset = std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double, Clock::period>((frame.time - _frames.front().time).count() / options.speed));
+                    Clock::time_point due = passStart + offset;
+                    Clock::time_point now = Clock::now();
+                    if (due > now)
+                        std::this_thread::sleep_until(due);
+                    else if (now - due > result.maxLag)
+                        result.maxLag = now - due;
+                }
+
+                const Clock::time_point begin = Clock::now();
+
+                // Same steps as the receive path: classify on the raw bytes, then parse once
+                WwksMessageType type = ClassifyWwksFrame(frame.xml);
+                if (type == WwksMessageType::KeepAliveRequest)
+                {
+                    result.keepAlives++;
+                    continue;
+                }
+
+                frameCopy.assign(frame.xml);
+                const WwksMessage& message = parser.Parse(frameCopy, type);
+                if (!message.IsValid()) result.invalid++;
+
+                if (handler)
+                {
+                    try
+                    {
+                        handler(message);
+                    }
+                    catch (...)
+                    {
+                        // swallow exceptions
+                    }
+                }
+
+                const Clock::duration spent = Clock::now() - begin;
+                perMessage.Record(std::chrono::duration_cast<LatencyHistogram::Duration>(spent));
+                result.busy += spent;
+                result.messages++;
+                result.bytes += frame.xml.size();
+            }
+        }
+
+        result.elapsed = Clock::now() - started;
+        result.perMessage = perMessage.GetSummary();
+        return result;
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+// TrafficReplay.h
+// Feeds a traffic capture back into the message handling, as NetworkClient would have delivered it:
+// every inbound frame is classified, parsed into a WwksMessage and handed to a handler (normally
+// the application's state update). KeepAliveRequests are skipped, the client answers those itself.
+// Frames are replayed at the recorded pace, scaled, or as fast as possible, which turns a production
+// capture into a reproducible benchmark of the state engine in messages per second.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "LatencyHistogram.h"
+#include "WwksClassifier.h"
+#include "WwksMessage.h"
+
+namespace RowaPickupSlim
+{
+    class TrafficReplay
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Handler = std::function<void(const WwksMessage&)>;
+
+        struct Options
+        {
+            double speed = 1.0;         // 1 = recorded pace, 10 = ten times faster, 0 = as fast as possible
+            size_t repeat = 1;          // Replay the capture this many times (timing restarts each pass)
+        };
+
+        struct Result
+        {
+            uint64_t messages = 0;      // Handed to the handler
+            uint64_t bytes = 0;         // Frame bytes of those messages
+            uint64_t keepAlives = 0;    // KeepAliveRequests skipped
+            uint64_t invalid = 0;       // Frames that did not parse (still handed to the handler)
+            Clock::duration elapsed{};  // Whole replay, including waits at the recorded pace
+            Clock::duration busy{};     // Classify + parse + handler, summed
+            Clock::duration maxLag{};   // Furthest behind the recorded pace (handler slower than production)
+            LatencyHistogram::Summary perMessage;   // Classify + parse + handler, per message
+            bool stopped = false;       // Stop() was called
+
+            /// Messages per second of wall time (as fast as possible: the state engine's throughput)
+            double MessagesPerSecond() const;
+        };
+
+        TrafficReplay() = default;
+
+        /// Read the inbound frames of a capture into memory, so disk reads are not part of the replay
+        /// @return false with error set if the capture cannot be read; a truncated tail is accepted
+        bool Load(const std::string& path, std::string& error);
+
+        /// Inbound frames loaded / recorded time from the first to the last one
+        size_t Size() const { return _frames.size(); }
+        Clock::duration Duration() const;
+
+        /// Gap records in the capture: the writer dropped frames there, so the replay misses them
+        size_t Gaps() const { return _gaps; }
+
+        /// Replay on the calling thread; handler exceptions are swallowed as NetworkClient does
+        Result Run(const Options& options, const Handler& handler);
+
+        /// Make a running Run() return after the current message (any thread)
+        void Stop() { _stop.store(true); }
+
+    private:
+        struct Frame
+        {
+            Clock::duration time{};     // Since the capture was opened
+            std::string xml;
+        };
+
+        std::vector<Frame> _frames;
+        size_t _gaps = 0;
+        std::atomic<bool> _stop{ false };
+
+        // non-copyable
+        TrafficReplay(const TrafficReplay&) = delete;
+        TrafficReplay& operator=(const TrafficReplay&) = delete;
+    };
+}
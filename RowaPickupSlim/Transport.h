@@ -0,0 +1,68 @@
+#pragma once
+// Transport.h
+// Byte stream under NetworkClient: one connected stream, read through a Reactor and
+// written by the SendQueue's writer thread.
+// Implementations: TcpTransport (Winsock / POSIX sockets) and LoopbackTransport (in memory,
+// with injectable chunking, latency and disconnects for tests and benchmarks).
+// Only depends on the standard library.
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace RowaPickupSlim
+{
+    class Reactor;
+
+    class Transport
+    {
+    public:
+        /// One piece of a gathering write
+        struct Buffer
+        {
+            const char* data;
+            size_t size;
+        };
+
+        /// Received data is written straight into the receiver's buffer
+        struct Receiver
+        {
+            std::function<char*(size_t size)> Prepare;     // Buffer for at least size bytes
+            std::function<void(size_t bytes)> Commit;      // bytes of the prepared buffer were filled
+            std::function<void(int error)> Closed;         // Stream ended: 0 = closed by the peer
+        };
+
+        virtual ~Transport() = default;
+
+        /// Start delivering received data to receiver on the reactor thread (call on that thread)
+        virtual bool Start(Reactor& reactor, Receiver receiver) = 0;
+
+        /// Stop delivering; no Receiver call is made after this returns (call on the reactor thread)
+        virtual void Stop() = 0;
+
+        /// Pause / resume delivering received data (call on the reactor thread, also from a Receiver
+        /// callback). While paused nothing is read: the peer's data waits in the socket buffers and
+        /// flow control slows the peer down. Start() begins unpaused.
+        virtual void PauseReceive(bool paused) = 0;
+
+        /// Write from the writer thread; blocks until at least one byte was accepted
+        /// @param written Bytes accepted, possibly less than the total
+        /// @param error Error code when false is returned
+        virtual bool Write(const Buffer* buffers, size_t count, size_t& written, int& error) = 0;
+
+        /// Thread-safe: end the stream in both directions. A blocked Write() returns with an error
+        /// and the peer sees the stream closed.
+        virtual void Shutdown() = 0;
+
+        /// e.g. "tcp 192.168.1.20:6050"
+        virtual std::string Describe() const = 0;
+
+    protected:
+        Transport() = default;
+
+    private:
+        // non-copyable
+        Transport(const Transport&) = delete;
+        Transport& operator=(const Transport&) = delete;
+    };
+}
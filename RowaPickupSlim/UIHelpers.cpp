@@ -2,6 +2,7 @@
 // UI utilities implementation
 
 #include "UIHelpers.h"
+#include <atomic>
 #include <chrono>
 #include <iomanip>
 #include <ctime>
@@ -76,9 +77,20 @@ namespace RowaPickupSlim::UIHelpers
         auto ms = duration_cast<milliseconds>(now.time_since_epoch()).count() % 1000;
         std::tm tm{};
         localtime_s(&tm, &t);
+        const long long clockId = ((tm.tm_hour * 100LL + tm.tm_min) * 100 + tm.tm_sec) * 1000 + ms;
+
+        // Several OutputRequests per millisecond (Send all): continue after the last ID handed out
+        // (unless the clock went back by more than a few minutes, i.e. past midnight)
+        static std::atomic<long long> s_lastId{ -1 };
+        long long last = s_lastId.load();
+        long long id;
+        do
+        {
+            id = (clockId <= last && last - clockId < 1000000) ? last + 1 : clockId;
+        } while (!s_lastId.compare_exchange_weak(last, id));
+
         char buf[64];
-        snprintf(buf, sizeof(buf), "%02d%02d%02d%03lld",
-                 tm.tm_hour, tm.tm_min, tm.tm_sec, static_cast<long long>(ms));
+        snprintf(buf, sizeof(buf), "%09lld", id);
         return std::string(buf);
     }
 
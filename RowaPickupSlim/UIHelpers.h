@@ -63,7 +63,8 @@ namespace RowaPickupSlim::UIHelpers
     /// Reusable: Yes - standard string conversion
     std::wstring Utf8ToWstring(const std::string& utf8);
 
-    /// Generate a unique ID in HHmmssfff format
+    /// Generate a unique ID in HHmmssfff format. IDs created within the same millisecond count up
+    /// from the previous one, so every call returns a new ID (thread-safe)
     /// Reusable: Yes - standard ID generation
     std::string MakeUniqueId();
 
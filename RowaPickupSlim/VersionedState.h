@@ -0,0 +1,81 @@
+#pragma once
+// VersionedState.h
+// Immutable, reference-counted state versions for readers that must not block writers.
+// Writers build a new value and swap it in atomically; readers pin the current version
+// with Acquire() and keep using it, unchanged, for as long as they hold the pointer.
+// Only depends on the standard library.
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace RowaPickupSlim
+{
+    template <typename T>
+    class VersionedState
+    {
+    public:
+        /// One published version; never modified after it was published
+        struct Version
+        {
+            uint64_t number;
+            T value;
+        };
+
+        using Snapshot = std::shared_ptr<const Version>;
+
+        VersionedState() : VersionedState(T{}) {}
+
+        explicit VersionedState(T initial)
+            : _current(std::make_shared<const Version>(Version{ 0, std::move(initial) }))
+        {
+        }
+
+        VersionedState(const VersionedState&) = delete;
+        VersionedState& operator=(const VersionedState&) = delete;
+
+        /// Pin the current version. Does not take the writer mutex, so readers never wait for a writer.
+        Snapshot Acquire() const
+        {
+            return _current.load(std::memory_order_acquire);
+        }
+
+        /// Publish value as the next version
+        /// @return The new version number
+        uint64_t Publish(T value)
+        {
+            std::lock_guard<std::mutex> lock(_writeMtx);
+            return PublishLocked(std::move(value));
+        }
+
+        /// Copy the current value, let modify change the copy, publish it.
+        /// Writers are serialized, so concurrent updates are never lost.
+        /// @return The new version number
+        template <typename Modify>
+        uint64_t Update(Modify&& modify)
+        {
+            std::lock_guard<std::mutex> lock(_writeMtx);
+            T value = _current.load(std::memory_order_acquire)->value;
+            modify(value);
+            return PublishLocked(std::move(value));
+        }
+
+        uint64_t GetVersion() const
+        {
+            return Acquire()->number;
+        }
+
+    private:
+        uint64_t PublishLocked(T value)
+        {
+            uint64_t number = _current.load(std::memory_order_relaxed)->number + 1;
+            _current.store(std::make_shared<const Version>(Version{ number, std::move(value) }), std::memory_order_release);
+            return number;
+        }
+
+        std::mutex _writeMtx;                               // Serializes writers only; readers never take it
+        std::atomic<std::shared_ptr<const Version>> _current;
+    };
+}
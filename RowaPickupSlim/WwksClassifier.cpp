@@ -0,0 +1,188 @@
+// WwksClassifier.cpp
+// Byte-level WWKS frame classifier implementation
+
+#include "WwksClassifier.h"
+
+namespace RowaPickupSlim
+{
+    struct TypeName
+    {
+        std::string_view name;
+        WwksMessageType type;
+    };
+
+    static constexpr TypeName TYPE_NAMES[] = {
+        { "HelloRequest", WwksMessageType::HelloRequest },
+        { "HelloResponse", WwksMessageType::HelloResponse },
+        { "StatusRequest", WwksMessageType::StatusRequest },
+        { "StatusResponse", WwksMessageType::StatusResponse },
+        { "StockInfoRequest", WwksMessageType::StockInfoRequest },
+        { "StockInfoResponse", WwksMessageType::StockInfoResponse },
+        { "OutputRequest", WwksMessageType::OutputRequest },
+        { "OutputResponse", WwksMessageType::OutputResponse },
+        { "OutputMessage", WwksMessageType::OutputMessage },
+        { "InputMessage", WwksMessageType::InputMessage },
+        { "TaskInfoRequest", WwksMessageType::TaskInfoRequest },
+        { "TaskInfoResponse", WwksMessageType::TaskInfoResponse },
+        { "KeepAliveRequest", WwksMessageType::KeepAliveRequest },
+        { "KeepAliveResponse", WwksMessageType::KeepAliveResponse },
+    };
+
+    static inline bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    static inline bool IsNameEnd(char c)
+    {
+        return IsSpace(c) || c == '>' || c == '/';
+    }
+
+    // Skip whitespace, a UTF-8 BOM, <?...?> processing instructions, <!-- --> comments and <!DOCTYPE>
+    static size_t SkipMisc(std::string_view s, size_t pos)
+    {
+        if (pos == 0 && s.size() >= 3 && s.compare(0, 3, "\xEF\xBB\xBF") == 0)
+            pos = 3;
+
+        while (pos < s.size())
+        {
+            if (IsSpace(s[pos]))
+            {
+                pos++;
+            }
+            else if (s.compare(pos, 2, "<?") == 0)
+            {
+                size_t end = s.find("?>", pos + 2);
+                if (end == std::string_view::npos) return s.size();
+                pos = end + 2;
+            }
+            else if (s.compare(pos, 4, "<!--") == 0)
+            {
+                size_t end = s.find("-->", pos + 4);
+                if (end == std::string_view::npos) return s.size();
+                pos = end + 3;
+            }
+            else if (s.compare(pos, 2, "<!") == 0)
+            {
+                size_t end = s.find('>', pos + 2);
+                if (end == std::string_view::npos) return s.size();
+                pos = end + 1;
+            }
+            else
+            {
+                break;
+            }
+        }
+        return pos;
+    }
+
+    // Return the position one past the '>' closing the start tag at pos ('<'), honouring quoted values
+    static size_t SkipStartTag(std::string_view s, size_t pos)
+    {
+        char quote = 0;
+        for (pos = pos + 1; pos < s.size(); pos++)
+        {
+            char c = s[pos];
+            if (quote)
+            {
+                if (c == quote) quote = 0;
+            }
+            else if (c == '"' || c == '\'')
+            {
+                quote = c;
+            }
+            else if (c == '>')
+            {
+                return pos + 1;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    WwksMessageType ClassifyWwksFrame(std::string_view frame, std::string_view* bodyTag)
+    {
+        size_t pos = SkipMisc(frame, 0);
+        if (frame.compare(pos, 5, "<WWKS") != 0 || pos + 5 >= frame.size() || !IsNameEnd(frame[pos + 5]))
+            return WwksMessageType::Unknown;
+
+        pos = SkipStartTag(frame, pos);
+        if (pos == std::string_view::npos) return WwksMessageType::Unknown;
+
+        pos = SkipMisc(frame, pos);
+        if (pos >= frame.size() || frame[pos] != '<') return WwksMessageType::Unknown;
+
+        size_t nameStart = pos + 1;
+        size_t nameEnd = nameStart;
+        while (nameEnd < frame.size() && !IsNameEnd(frame[nameEnd]))
+            nameEnd++;
+        if (nameEnd >= frame.size()) return WwksMessageType::Unknown;
+
+        std::string_view name = frame.substr(nameStart, nameEnd - nameStart);
+        for (const TypeName& entry : TYPE_NAMES)
+        {
+            if (entry.name == name)
+            {
+                if (bodyTag)
+                {
+                    size_t tagEnd = SkipStartTag(frame, pos);
+                    *bodyTag = (tagEnd == std::string_view::npos) ? std::string_view() : frame.substr(pos, tagEnd - pos);
+                }
+                return entry.type;
+            }
+        }
+        return WwksMessageType::Unknown;
+    }
+
+    const char* ToString(WwksMessageType type)
+    {
+        for (const TypeName& entry : TYPE_NAMES)
+        {
+            if (entry.type == type) return entry.name.data();
+        }
+        return "";
+    }
+
+    bool FindTagAttribute(std::string_view startTag, std::string_view name, std::string_view& value)
+    {
+        // Skip '<' and the element name
+        size_t pos = 1;
+        while (pos < startTag.size() && !IsNameEnd(startTag[pos]))
+            pos++;
+
+        while (pos < startTag.size())
+        {
+            while (pos < startTag.size() && IsSpace(startTag[pos]))
+                pos++;
+            if (pos >= startTag.size() || startTag[pos] == '>' || startTag[pos] == '/')
+                return false;
+
+            size_t attrStart = pos;
+            while (pos < startTag.size() && startTag[pos] != '=' && !IsSpace(startTag[pos]) && startTag[pos] != '>')
+                pos++;
+            std::string_view attrName = startTag.substr(attrStart, pos - attrStart);
+
+            while (pos < startTag.size() && IsSpace(startTag[pos]))
+                pos++;
+            if (pos >= startTag.size() || startTag[pos] != '=')
+                return false;
+            pos++;
+            while (pos < startTag.size() && IsSpace(startTag[pos]))
+                pos++;
+            if (pos >= startTag.size() || (startTag[pos] != '"' && startTag[pos] != '\''))
+                return false;
+
+            char quote = startTag[pos++];
+            size_t valueEnd = startTag.find(quote, pos);
+            if (valueEnd == std::string_view::npos)
+                return false;
+
+            if (attrName == name)
+            {
+                value = startTag.substr(pos, valueEnd - pos);
+                return true;
+            }
+            pos = valueEnd + 1;
+        }
+        return false;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+// WwksClassifier.h
+// DOM-free classification of WWKS frames.
+// Reads only the prolog, the <WWKS> start tag and the first child start tag, so routing
+// decisions (keepalive, status, stock, output) cost O(prefix length) instead of a full parse.
+// Only depends on the standard library.
+
+#include <cstdint>
+#include <string_view>
+
+namespace RowaPickupSlim
+{
+    enum class WwksMessageType : uint8_t
+    {
+        Unknown = 0,
+        HelloRequest,
+        HelloResponse,
+        StatusRequest,
+        StatusResponse,
+        StockInfoRequest,
+        StockInfoResponse,
+        OutputRequest,
+        OutputResponse,
+        OutputMessage,
+        InputMessage,
+        TaskInfoRequest,
+        TaskInfoResponse,
+        KeepAliveRequest,
+        KeepAliveResponse
+    };
+
+    /// Classify a frame by the name of the first element below <WWKS>
+    /// @param frame A complete (or at least prefix-complete) WWKS frame
+    /// @param bodyTag Optional output: the message element's start tag, from '<' to '>' inclusive
+    /// @return The message type, Unknown if the frame is not WWKS or the element is not recognised
+    WwksMessageType ClassifyWwksFrame(std::string_view frame, std::string_view* bodyTag = nullptr);
+
+    /// Element name of a message type ("" for Unknown)
+    const char* ToString(WwksMessageType type);
+
+    /// Look up an attribute value in a start tag such as the bodyTag from ClassifyWwksFrame.
+    /// Values are returned raw (entities are not decoded).
+    /// @return true if the attribute exists
+    bool FindTagAttribute(std::string_view startTag, std::string_view name, std::string_view& value);
+}
@@ -0,0 +1,104 @@
+// WwksFrameSplitter.cpp
+// Incremental WWKS frame splitter implementation
+
+#include "WwksFrameSplitter.h"
+#include <cstring>
+
+namespace RowaPickupSlim
+{
+    static constexpr std::string_view WWKS_END_TAG = "</WWKS>";
+
+    WwksFrameSplitter::WwksFrameSplitter(size_t initialCapacity)
+        : _buffer(initialCapacity > 0 ? initialCapacity : 1)
+    {
+    }
+
+    char* WwksFrameSplitter::PrepareWrite(size_t minBytes)
+    {
+        if (_buffer.size() - _end >= minBytes)
+            return _buffer.data() + _end;
+
+        size_t live = _end - _begin;
+        size_t needed = live + minBytes;
+
+        if (needed * 2 <= _buffer.size())
+        {
+            // Enough room once the consumed prefix is dropped. The live part is at most
+            // half the buffer, so moving it is paid for by the bytes already consumed.
+            Compact();
+        }
+        else
+        {
+            // Grow geometrically and only carry over the unconsumed bytes
+            size_t newSize = _buffer.size() * 2;
+            if (newSize < needed * 2) newSize = needed * 2;
+
+            std::vector<char> grown(newSize);
+            if (live > 0) std::memcpy(grown.data(), _buffer.data() + _begin, live);
+            _buffer.swap(grown);
+            _scan -= _begin;
+            _begin = 0;
+            _end = live;
+        }
+        return _buffer.data() + _end;
+    }
+
+    void WwksFrameSplitter::Commit(size_t bytesWritten)
+    {
+        _end += bytesWritten;
+        if (_end > _buffer.size()) _end = _buffer.size();
+    }
+
+    void WwksFrameSplitter::Append(const char* data, size_t length)
+    {
+        if (length == 0) return;
+        std::memcpy(PrepareWrite(length), data, length);
+        Commit(length);
+    }
+
+    bool WwksFrameSplitter::NextFrame(std::string_view& frame)
+    {
+        std::string_view pending(_buffer.data() + _begin, _end - _begin);
+
+        // Resume where the previous search stopped instead of rescanning from the frame start
+        size_t pos = pending.find(WWKS_END_TAG, _scan - _begin);
+        if (pos == std::string_view::npos)
+        {
+            // Keep the last (tag length - 1) bytes in range so a tag split across chunks is found
+            size_t keep = WWKS_END_TAG.size() - 1;
+            _scan = (pending.size() > keep) ? _end - keep : _begin;
+            return false;
+        }
+
+        size_t frameEnd = pos + WWKS_END_TAG.size();
+        size_t start = 0;
+        while (start < pos && (pending[start] == ' ' || pending[start] == '\t' || pending[start] == '\r' || pending[start] == '\n'))
+            start++;
+
+        frame = pending.substr(start, frameEnd - start);
+
+        _begin += frameEnd;
+        _scan = _begin;
+        if (_begin == _end)
+        {
+            // Everything consumed: rewind for free (bytes stay intact until the next write)
+            _begin = _end = _scan = 0;
+        }
+        return true;
+    }
+
+    void WwksFrameSplitter::Reset()
+    {
+        _begin = _end = _scan = 0;
+    }
+
+    void WwksFrameSplitter::Compact()
+    {
+        size_t live = _end - _begin;
+        if (_begin > 0 && live > 0)
+            std::memmove(_buffer.data(), _buffer.data() + _begin, live);
+        _scan -= _begin;
+        _begin = 0;
+        _end = live;
+    }
+}
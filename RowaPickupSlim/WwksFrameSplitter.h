@@ -0,0 +1,48 @@
+#pragma once
+// WwksFrameSplitter.h
+// Incremental splitter that cuts a TCP byte stream into complete <WWKS>...</WWKS> frames.
+// Only depends on the standard library so it can be built and benchmarked off-Windows.
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace RowaPickupSlim
+{
+    class WwksFrameSplitter
+    {
+    public:
+        explicit WwksFrameSplitter(size_t initialCapacity = 64 * 1024);
+
+        /// Reserve room for at least minBytes and return a pointer to write into
+        /// (e.g. directly from recv). Call Commit() with the number of bytes written.
+        /// Invalidates frames previously returned by NextFrame().
+        char* PrepareWrite(size_t minBytes);
+
+        /// Mark bytes written into the region returned by PrepareWrite() as received
+        void Commit(size_t bytesWritten);
+
+        /// Copy received bytes into the buffer (PrepareWrite + memcpy + Commit)
+        void Append(const char* data, size_t length);
+
+        /// Return the next complete frame, from its first non-whitespace byte up to and
+        /// including "</WWKS>". The view points into the internal buffer and stays valid
+        /// until the next PrepareWrite/Append/Reset call.
+        /// @return false when no complete frame is buffered
+        bool NextFrame(std::string_view& frame);
+
+        /// Number of received bytes that do not belong to a returned frame yet
+        size_t BufferedBytes() const { return _end - _begin; }
+
+        /// Drop all buffered data (e.g. after a reconnect)
+        void Reset();
+
+    private:
+        void Compact();
+
+        std::vector<char> _buffer;
+        size_t _begin = 0;   // Start of the first unconsumed byte
+        size_t _end = 0;     // One past the last received byte
+        size_t _scan = 0;    // Where the end tag search resumes; bytes before it are known not to end a frame
+    };
+}
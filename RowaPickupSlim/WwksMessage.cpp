@@ -0,0 +1,46 @@
+// WwksMessage.cpp
+// Single-parse WWKS message implementation
+
+#include "WwksMessage.h"
+
+namespace RowaPickupSlim
+{
+    WwksMessageParser::WwksMessageParser(size_t arenaBlockSize)
+        : _arena(arenaBlockSize)
+    {
+    }
+
+    const WwksMessage& WwksMessageParser::Parse(std::string& frame, WwksMessageType type)
+    {
+        // Drop the previous DOM (its pages are arena memory, freeing them is a no-op), then rewind the arena
+        _message.document.reset();
+        _arena.Reset();
+
+        _message.xml.swap(frame);
+        _message.type = type;
+        _message.root = pugi::xml_node();
+        _message.body = pugi::xml_node();
+        _message.streamed = false;
+
+        if (type == WwksMessageType::StockInfoResponse)
+        {
+            _message.streamed = true;
+            return _message;
+        }
+
+        pugi::xml_parse_result res;
+        {
+            ParseArena::Scope scope(_arena);
+            if (type == WwksMessageType::Unknown)
+                res = _message.document.load_buffer(_message.xml.data(), _message.xml.size());
+            else
+                res = _message.document.load_buffer_inplace(_message.xml.data(), _message.xml.size());
+        }
+        if (!res) return _message;
+
+        _message.root = _message.document.child("WWKS");
+        if (_message.root && type != WwksMessageType::Unknown)
+            _message.body = _message.root.child(ToString(type));
+        return _message;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+// WwksMessage.h
+// A received WWKS message, parsed exactly once in the receive path and shared with all handlers.
+// WwksMessageParser reuses one message and parses in place, with the DOM in a ParseArena: once the
+// arena has grown to the largest message, parsing a frame does not allocate.
+
+#include <string>
+#include "pugixml.hpp"
+#include "ParseArena.h"
+#include "WwksClassifier.h"
+
+namespace RowaPickupSlim
+{
+    struct WwksMessage
+    {
+        WwksMessageType type = WwksMessageType::Unknown;   // From ClassifyWwksFrame, before any parsing
+        std::string xml;                // Frame as received; after an in-place parse it holds the DOM's text (see WwksMessageParser)
+        pugi::xml_document document;    // Parsed DOM, owns all nodes below
+        pugi::xml_node root;            // <WWKS> element (null if the frame did not parse)
+        pugi::xml_node body;            // The message element below <WWKS> (null if unknown)
+        bool streamed = false;          // No DOM was built; read xml with a streaming parser (StockInfoResponse)
+
+        /// True if the frame parsed and has a <WWKS> root, or is left to a streaming parser
+        bool IsValid() const { return streamed || static_cast<bool>(root); }
+
+        /// Message element name, e.g. "StockInfoResponse" ("" if unknown)
+        const char* TypeName() const { return ToString(type); }
+
+        WwksMessage() = default;
+        WwksMessage(const WwksMessage&) = delete;
+        WwksMessage& operator=(const WwksMessage&) = delete;
+    };
+
+    /// Parses received frames into one WwksMessage that is reused from frame to frame.
+    /// Not thread-safe: one parser per thread that parses (e.g. per dispatch lane).
+    class WwksMessageParser
+    {
+    public:
+        /// @param arenaBlockSize First arena block; a few pugixml pages (32 KB each) fit most messages
+        explicit WwksMessageParser(size_t arenaBlockSize = 64 * 1024);
+
+        /// Parse a complete frame that was already classified; check IsValid() on the result.
+        /// The frame's buffer is taken over (swapped with the previous message, no copy). Known message
+        /// types are parsed in place, so their xml no longer reads as the raw frame; Unknown frames are
+        /// copied into the arena first and keep their raw text (for logging). StockInfoResponse frames
+        /// can be many megabytes; they are not parsed into a DOM (streamed = true, xml is raw).
+        /// @return The message; valid until the next Parse()
+        const WwksMessage& Parse(std::string& frame, WwksMessageType type);
+
+        /// Arena of the DOM (read on the parsing thread)
+        ParseArena::Counters GetArenaCounters() const { return _arena.GetCounters(); }
+
+    private:
+        ParseArena _arena;                  // Declared first: outlives the document that points into it
+        WwksMessage _message;
+
+        // non-copyable
+        WwksMessageParser(const WwksMessageParser&) = delete;
+        WwksMessageParser& operator=(const WwksMessageParser&) = delete;
+    };
+}
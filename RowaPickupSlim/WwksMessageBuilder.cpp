@@ -0,0 +1,123 @@
+// WwksMessageBuilder.cpp
+// Outgoing WWKS message builder implementation
+
+#include "WwksMessageBuilder.h"
+#include <charconv>
+
+namespace RowaPickupSlim
+{
+    static constexpr std::string_view PART_BEGIN = "<WWKS Version=\"2.0\" TimeStamp=\"";
+    static constexpr std::string_view PART_BEGIN_END = "\">";
+    static constexpr std::string_view PART_END = "</WWKS>";
+
+    WwksMessageBuilder::WwksMessageBuilder(size_t initialCapacity)
+    {
+        _buffer.reserve(initialCapacity);
+    }
+
+    WwksMessageBuilder& WwksMessageBuilder::Begin(std::time_t now)
+    {
+        // clear() keeps the capacity
+        _buffer.clear();
+        _buffer.append(PART_BEGIN);
+        _buffer.append(_stamp.Format(now));
+        _buffer.append(PART_BEGIN_END);
+        return *this;
+    }
+
+    WwksMessageBuilder& WwksMessageBuilder::Element(std::string_view name)
+    {
+        _buffer.push_back('<');
+        _buffer.append(name);
+        return *this;
+    }
+
+    WwksMessageBuilder& WwksMessageBuilder::Attribute(std::string_view name, std::string_view value)
+    {
+        _buffer.push_back(' ');
+        _buffer.append(name);
+        _buffer.append("=\"", 2);
+        AppendEscaped(_buffer, value);
+        _buffer.push_back('"');
+        return *this;
+    }
+
+    WwksMessageBuilder& WwksMessageBuilder::Attribute(std::string_view name, long long value)
+    {
+        char digits[24];
+        std::to_chars_result r = std::to_chars(digits, digits + sizeof(digits), value);
+        return AttributeRaw(name, std::string_view(digits, static_cast<size_t>(r.ptr - digits)));
+    }
+
+    WwksMessageBuilder& WwksMessageBuilder::AttributeRaw(std::string_view name, std::string_view value)
+    {
+        _buffer.push_back(' ');
+        _buffer.append(name);
+        _buffer.append("=\"", 2);
+        _buffer.append(value);
+        _buffer.push_back('"');
+        return *this;
+    }
+
+    WwksMessageBuilder& WwksMessageBuilder::Children()
+    {
+        _buffer.push_back('>');
+        return *this;
+    }
+
+    WwksMessageBuilder& WwksMessageBuilder::Empty()
+    {
+        _buffer.append(" />", 3);
+        return *this;
+    }
+
+    WwksMessageBuilder& WwksMessageBuilder::Close(std::string_view name)
+    {
+        _buffer.append("</", 2);
+        _buffer.append(name);
+        _buffer.push_back('>');
+        return *this;
+    }
+
+    WwksMessageBuilder& WwksMessageBuilder::Raw(std::string_view markup)
+    {
+        _buffer.append(markup);
+        return *this;
+    }
+
+    std::string_view WwksMessageBuilder::End()
+    {
+        _buffer.append(PART_END);
+        return _buffer;
+    }
+
+    void WwksMessageBuilder::AppendEscaped(std::string& out, std::string_view value)
+    {
+        // Copy runs of plain characters in one append
+        size_t runStart = 0;
+        for (size_t i = 0; i < value.size(); i++)
+        {
+            unsigned char c = static_cast<unsigned char>(value[i]);
+            std::string_view entity;
+            switch (c)
+            {
+            case '&': entity = "&amp;"; break;
+            case '<': entity = "&lt;"; break;
+            case '>': entity = "&gt;"; break;
+            case '"': entity = "&quot;"; break;
+            case '\'': entity = "&apos;"; break;
+            case '\t': entity = "&#9;"; break;      // Would become a space in an attribute value
+            case '\n': entity = "&#10;"; break;
+            case '\r': entity = "&#13;"; break;
+            default:
+                if (c >= 0x20) continue;
+                break;                              // Not allowed in XML 1.0: dropped (entity stays empty)
+            }
+
+            out.append(value.data() + runStart, i - runStart);
+            out.append(entity);
+            runStart = i + 1;
+        }
+        out.append(value.data() + runStart, value.size() - runStart);
+    }
+}
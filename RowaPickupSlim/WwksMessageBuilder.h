@@ -0,0 +1,72 @@
+#pragma once
+// WwksMessageBuilder.h
+// Builds outgoing WWKS messages into a buffer that is reused from message to message.
+// Fixed markup is appended from static fragments, attribute values are XML-escaped, numbers are
+// formatted with to_chars and the TimeStamp text comes from an IsoTimestampFormatter (converted
+// once per second). Once the buffer has grown to the largest message built, building a message
+// does not allocate.
+// Only depends on the standard library.
+//
+//   builder.Begin(std::time(nullptr))
+//       .Element("StatusRequest").Attribute("Id", id).Attribute("Source", source).Empty()
+//       .End();                                       // -> view of <WWKS ...>...</WWKS>
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include "IsoTimestamp.h"
+
+namespace RowaPickupSlim
+{
+    class WwksMessageBuilder
+    {
+    public:
+        explicit WwksMessageBuilder(size_t initialCapacity = 1024);
+
+        /// Start a new message: <WWKS Version="2.0" TimeStamp="..."> (now is UTC)
+        WwksMessageBuilder& Begin(std::time_t now);
+
+        /// Open a start tag: <name (add attributes, then Children() or Empty())
+        WwksMessageBuilder& Element(std::string_view name);
+
+        /// name="value" on the open start tag; the value is escaped
+        WwksMessageBuilder& Attribute(std::string_view name, std::string_view value);
+        WwksMessageBuilder& Attribute(std::string_view name, long long value);
+        WwksMessageBuilder& Attribute(std::string_view name, int value) { return Attribute(name, static_cast<long long>(value)); }
+
+        /// name="value" with a value that is already valid attribute text (e.g. copied from a received tag)
+        WwksMessageBuilder& AttributeRaw(std::string_view name, std::string_view value);
+
+        /// Close the start tag with ">"; child elements follow, then Close(name)
+        WwksMessageBuilder& Children();
+
+        /// Close the start tag with " />"
+        WwksMessageBuilder& Empty();
+
+        /// End tag: </name>
+        WwksMessageBuilder& Close(std::string_view name);
+
+        /// Append trusted markup as is (static fragments such as a fixed list of child elements)
+        WwksMessageBuilder& Raw(std::string_view markup);
+
+        /// Finish the message with </WWKS>
+        /// @return The complete message; valid until the next Begin()
+        std::string_view End();
+
+        /// The message built so far
+        std::string_view View() const { return _buffer; }
+
+        /// Append value escaped for a double-quoted attribute: & < > " ' become entities,
+        /// tab / CR / LF become character references, other characters XML does not allow are dropped
+        static void AppendEscaped(std::string& out, std::string_view value);
+
+    private:
+        std::string _buffer;
+        IsoTimestampFormatter _stamp;       // "YYYY-MM-DDTHH:MM:SSZ"
+
+        // non-copyable
+        WwksMessageBuilder(const WwksMessageBuilder&) = delete;
+        WwksMessageBuilder& operator=(const WwksMessageBuilder&) = delete;
+    };
+}
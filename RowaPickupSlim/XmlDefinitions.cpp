@@ -4,7 +4,8 @@
 // Designed to be copy/pasted and compiled with pugi (https://pugixml.org/)
 //
 // Notes:
-// - Date/time fields are represented as std::string (ISO format) to keep parsing simple.
+// - Date/time fields are represented as std::string (ISO format) to keep parsing simple;
+//   Get...() accessors parse them on demand with ParseIsoTimestamp (false if empty or malformed).
 // - Collections use std::vector.
 // - Each struct exposes `bool load(const pugi::xml_node&)` and `pugi::xml_node save(pugi::xml_node&) const`.
 // - This file is self-contained; include pugi.hpp in your project include path.
@@ -13,7 +14,9 @@
 #include <vector>
 #include <optional>
 #include <sstream>
+#include <chrono>
 #include "pugixml.hpp"
+#include "IsoTimestamp.h"
 
 namespace RowaPickupSlim::XmlDefinitions
 {
@@ -211,6 +214,8 @@ namespace RowaPickupSlim::XmlDefinitions
         string State;
         optional<Handling> HandlingElement;
 
+        bool GetExpiryDate(std::chrono::system_clock::time_point& time) const { return ParseIsoTimestamp(ExpiryDate, time); }
+
         bool load(const pugi::xml_node& n)
         {
             Index = get_attr_int(n, "Index", Index);
@@ -477,6 +482,8 @@ namespace RowaPickupSlim::XmlDefinitions
         string MinimumExpiryDate;
         vector<Label> Labels;
 
+        bool GetMinimumExpiryDate(std::chrono::system_clock::time_point& time) const { return ParseIsoTimestamp(MinimumExpiryDate, time); }
+
         bool load(const pugi::xml_node& n)
         {
             ArticleId = get_attr(n, "ArticleId");
@@ -589,6 +596,8 @@ namespace RowaPickupSlim::XmlDefinitions
         int OutputDestination = 1;
         string LabelStatus;
 
+        bool GetExpiryDate(std::chrono::system_clock::time_point& time) const { return ParseIsoTimestamp(ExpiryDate, time); }
+
         bool load(const pugi::xml_node& n)
         {
             Id = get_attr_int(n, "Id", Id);
@@ -873,6 +882,8 @@ namespace RowaPickupSlim::XmlDefinitions
         optional<InputMessage> InputMessageElement;
         optional<TaskInfoResponse> TaskInfoResponseElement;
 
+        bool GetTimeStamp(std::chrono::system_clock::time_point& time) const { return ParseIsoTimestamp(TimeStamp, time); }
+
         bool load(const pugi::xml_node& root)
         {
             if (std::string(root.name()) != "WWKS") return false;
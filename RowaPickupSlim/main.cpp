@@ -19,17 +19,18 @@
 #include <windowsx.h>
 #include <commctrl.h>
 #pragma comment(lib, "comctl32.lib")
+#include <shellapi.h>
+#pragma comment(lib, "shell32.lib")
 
 #include "resource.h"
 #include <string>
 #include <vector>
 #include <tuple>
-#include <set>
 #include <mutex>
+#include <atomic>
 #include <memory>
 #include <thread>
 #include <chrono>
-#include <sstream>
 #include <iomanip>
 #include <fstream>
 #include <algorithm>
@@ -44,6 +45,14 @@
 #include "Localization.h"
 #include "UIHelpers.h"
 #include "LoggingSystem.h"
+#include "StockInfoStreamParser.h"
+#include "ArticleStore.h"
+#include "OrderTable.h"
+#include "StateSnapshot.h"
+#include "VersionedState.h"
+#include "TrafficCapture.h"
+#include "TrafficReplay.h"
+#include "WwksMessageBuilder.h"
 
 // ============================================================================
 // NAMESPACE USAGE
@@ -60,28 +69,47 @@ struct AppState
     std::string robotState = "unknown";
     std::string lastMessageType;
     
-    std::vector<std::pair<std::string,int>> baseArticlesList;
-    std::vector<std::pair<std::string,int>> articles;
-    std::vector<std::pair<std::string,int>> fullArticlesList;
+    ArticleStore articleStore;                  // All articles from the last StockInfoResponse (single master list)
+    ArticleView articles{ articleStore };       // Currently shown (filtered) rows, indices into articleStore
     
-    // Output records: (orderId, articleId, quantityRequested, packsDelivered, color, isOurOutput)
-    std::vector<std::tuple<std::string,std::string,int,int,COLORREF,bool>> outputRecords;
-    std::set<std::string> ourOutputRequestIds;
+    // Active output orders, indexed by order ID and by article ID
+    OrderTable orders;
     
     // Device status
     std::vector<std::tuple<std::string,std::string,std::string,std::string>> devices;
     
-    // UI state
-    int selectedIndex = -1;
-    int scrollOffset = 0;
+    // UI state (atomic so WM_PAINT can read it without taking mtx)
+    std::atomic<int> selectedIndex = -1;
+    std::atomic<int> scrollOffset = 0;
     
     // Synchronization
     std::mutex mtx;
 } g_state;
 
+// Published copy of g_state for WM_PAINT / WM_MOUSEMOVE, see publish_state_locked()
+VersionedState<StateSnapshot> g_snapshots;
+
 std::unique_ptr<NetworkClient> g_client;
 std::string g_logFilePath;
 
+// Command line switches (read in wWinMain):
+//   /capture                 record the WWKS traffic to a .wwkscap file next to the protocol log
+//   /replay <file> [speed]   replay a capture into the state instead of connecting (speed 0 = as fast as possible)
+static bool g_captureTraffic = false;
+static std::string g_replayPath;
+static double g_replaySpeed = 1.0;
+static std::shared_ptr<TrafficCaptureWriter> g_capture;
+static std::unique_ptr<TrafficReplay> g_replay;
+static std::thread g_replayThread;
+
+// Builder for the requests main.cpp sends (OutputRequest, Refresh). They are sent from the UI thread
+// and from the detached output threads, so each thread builds into its own
+static WwksMessageBuilder& request_builder()
+{
+    thread_local WwksMessageBuilder builder;
+    return builder;
+}
+
 // ============================================================================
 // Logging System Implementation
 // ============================================================================
@@ -169,129 +197,156 @@ static std::string make_unique_id()
     return UIHelpers::MakeUniqueId();
 }
 
-// Helper to find index of article by id in g_state.articles
-static int find_article_index(const std::string& articleId)
+// Parts of g_state that changed since the last published snapshot
+enum SnapshotPart : unsigned
 {
-    for (size_t i = 0; i < g_state.articles.size(); ++i)
+    SNAPSHOT_STATUS = 1,        // Connection / robot state, last message type, devices
+    SNAPSHOT_ARTICLES = 2,      // New article list (refreshes all article parts)
+    SNAPSHOT_QUANTITIES = 4,    // Quantities of changedArticleIds
+    SNAPSHOT_FILTER = 8,
+    SNAPSHOT_ORDERS = 16        // Orders of changedArticleIds
+};
+
+// Publish a new state version for the UI readers. Call with g_state.mtx held, after changing g_state.
+// Parts that did not change are shared with the previous version instead of copied; of the
+// quantities and orders only the chunks holding changedArticleIds are copied.
+// Publish once per batch of changes, not once per article.
+static void publish_state_locked(unsigned parts, const std::vector<std::string>& changedArticleIds = {})
+{
+    auto previous = g_snapshots.Acquire();
+    StateSnapshot next = previous->value;
+
+    if (parts & SNAPSHOT_STATUS)
     {
-        if (g_state.articles[i].first == articleId)
-            return (int)i;
+        next.connectionState = g_state.connectionState;
+        next.robotState = g_state.robotState;
+        next.lastMessageType = g_state.lastMessageType;
+        next.devices = g_state.devices;
     }
-    return -1;
-}
 
-// Helper to find and update article quantity in both articles and fullArticlesList
-// This keeps both lists in sync so filtering doesn't lose quantity changes
-static void update_article_quantity_in_both_lists(const std::string& articleId, int newQty)
-{
-    // Update in filtered articles list
-    for (size_t i = 0; i < g_state.articles.size(); ++i)
+    if (parts & SNAPSHOT_ARTICLES)
     {
-        if (g_state.articles[i].first == articleId)
-        {
-            g_state.articles[i].second = (newQty < 0) ? 0 : newQty;
-            break;
-        }
+        next.articleIds = Snapshots::ArticleIds(g_state.articleStore);
+        next.quantities = Snapshots::Quantities(g_state.articleStore);
+        next.rows = Snapshots::Rows(g_state.articles);
+        next.orders = Snapshots::Orders(g_state.articleStore, g_state.orders);
     }
-    
-    // Also update in full articles list to keep both in sync
-    for (size_t i = 0; i < g_state.fullArticlesList.size(); ++i)
+    else
     {
-        if (g_state.fullArticlesList[i].first == articleId)
-        {
-            g_state.fullArticlesList[i].second = (newQty < 0) ? 0 : newQty;
-            break;
-        }
+        if (parts & SNAPSHOT_QUANTITIES) next.quantities = Snapshots::Quantities(previous->value.quantities, g_state.articleStore, changedArticleIds);
+        if (parts & SNAPSHOT_FILTER) next.rows = Snapshots::Rows(g_state.articles);
+        if (parts & SNAPSHOT_ORDERS) next.orders = Snapshots::Orders(previous->value.orders, g_state.articleStore, g_state.orders, changedArticleIds);
     }
+
+    g_snapshots.Publish(std::move(next));
 }
 
-// Update outputRecords based on order id and set color according to status and ownership.
-// If Completed, remove record and adjust article quantity if possible.
-static void update_output_record_from_message(const std::string& orderId, const std::string& articleId, int quantityRequested, int packsDelivered, const std::string& status, bool isOurOutput)
+// Helper to reduce an article quantity in the master store (clamped to >= 0)
+// The filtered view only holds indices, so the change is visible there as well
+static void reduce_article_quantity(const std::string& articleId, int quantity)
 {
-    std::lock_guard<std::mutex> lock(g_state.mtx);
-    auto it = std::find_if(g_state.outputRecords.begin(), g_state.outputRecords.end(),
-        [&](auto const& t){ return std::get<0>(t) == orderId; });
+    int idx = g_state.articleStore.FindArticleIndex(articleId);
+    if (idx >= 0)
+        g_state.articleStore.SetQuantity(idx, g_state.articleStore[idx].second - quantity);
+}
 
-    COLORREF color = CLR_PURPLE;
-    if (status == "Queued")
-    {
-        color = isOurOutput ? CLR_BLUE : CLR_YELLOW;
-    }
-    else if (status == "Rejected" || status == "Incomplete")
-    {
-        color = CLR_RED;
-    }
-    else if (status == "InProcess")
+// Case-insensitive substring test; upperNeedle must already be upper case
+static bool contains_upper(const std::string& haystack, const std::string& upperNeedle)
+{
+    if (upperNeedle.size() > haystack.size()) return false;
+    for (size_t start = 0; start + upperNeedle.size() <= haystack.size(); ++start)
     {
-        color = CLR_ORANGE;
+        size_t i = 0;
+        while (i < upperNeedle.size() && ::toupper((unsigned char)haystack[start + i]) == (unsigned char)upperNeedle[i])
+            ++i;
+        if (i == upperNeedle.size()) return true;
     }
-    else if (status == "Completed")
+    return false;
+}
+
+// Find an article by complete article code (case-insensitive) in g_state.articles
+// Returns true if found with quantity > 0
+static bool find_article_by_complete_code(const std::string& completeCode, std::string& outId, int& outQty)
+{
+    int idx = g_state.articles.FindArticleIndexIgnoreCase(completeCode);
+    if (idx < 0 || g_state.articles[idx].second <= 0) return false;
+    outId = g_state.articles[idx].first;
+    outQty = g_state.articles[idx].second;
+    return true;
+}
+
+// Display colour of an output order, from its status and ownership
+static COLORREF output_record_color(const OrderDisplay& rec)
+{
+    switch (rec.status)
     {
-        color = CLR_GREEN;
+    case OutputStatus::Queued:      return rec.isOurOutput ? CLR_BLUE : CLR_YELLOW;
+    case OutputStatus::Rejected:
+    case OutputStatus::Incomplete:  return CLR_RED;
+    case OutputStatus::InProcess:   return CLR_ORANGE;
+    case OutputStatus::Completed:   return CLR_GREEN;
+    default:                        return CLR_PURPLE;
     }
+}
+
+// Update the order table based on order id, status and ownership.
+// If Completed, remove the order and adjust article quantity if possible.
+// An order is ours if we sent its OutputRequest: the record added by send_output_request_for_article
+// keeps the flag until the order completes (replaces a set of sent IDs that was never pruned)
+static bool is_our_output(const std::string& orderId)
+{
+    std::lock_guard<std::mutex> lock(g_state.mtx);
+    const OutputRecord* rec = g_state.orders.FindOrder(orderId);
+    return rec && rec->isOurOutput;
+}
+
+static void update_output_record_from_message(const std::string& orderId, const std::string& articleId, int quantityRequested, int packsDelivered, const std::string& status, bool isOurOutput)
+{
+    std::lock_guard<std::mutex> lock(g_state.mtx);
+    OutputStatus outputStatus = ParseOutputStatus(status);
+
+    // The row display changes for the article of the known order (an update never changes it)
+    const OutputRecord* existing = g_state.orders.FindOrder(orderId);
+    std::string displayArticleId = existing ? existing->articleId : articleId;
 
     // ALWAYS adjust article quantity for Completed status (whether we have a record or not)
-    // Update both articles and fullArticlesList to keep them in sync for filtering
-    if (status == "Completed" && !articleId.empty())
+    // Applied to the master store, so it also counts for articles hidden by the current filter
+    if (outputStatus == OutputStatus::Completed && !articleId.empty())
     {
-        int idx = find_article_index(articleId);
-        if (idx >= 0)
-        {
-            int newQty = g_state.articles[idx].second - quantityRequested;
-            update_article_quantity_in_both_lists(articleId, newQty);
-        }
+        reduce_article_quantity(articleId, quantityRequested);
     }
 
-    if (it != g_state.outputRecords.end())
+    if (outputStatus == OutputStatus::Completed)
     {
-        if (status == "Completed")
-        {
-            g_state.outputRecords.erase(it);
-        }
-        else
-        {
-            // update color / qty / packs delivered if changed
-            std::get<2>(*it) = quantityRequested;
-            std::get<3>(*it) = packsDelivered;
-            std::get<4>(*it) = color;
-            std::get<5>(*it) = isOurOutput;
-        }
+        g_state.orders.RemoveOrder(orderId);
     }
     else
     {
-        if (status != "Completed")
-        {
-            g_state.outputRecords.emplace_back(orderId, articleId, quantityRequested, packsDelivered, color, isOurOutput);
-        }
+        // Inserts a new order, or updates qty / packs delivered / status of a known one
+        g_state.orders.SetOrder({ orderId, articleId, quantityRequested, packsDelivered, outputStatus, isOurOutput });
     }
+
+    unsigned parts = SNAPSHOT_ORDERS;
+    if (outputStatus == OutputStatus::Completed && !articleId.empty()) parts |= SNAPSHOT_QUANTITIES;
+    publish_state_locked(parts, { displayArticleId, articleId });
 }
 
 // Parse incoming WWKS XML, update g_state and post UI update
-static void handle_incoming_xml_and_update_state(const std::string& xml, HWND hwnd)
+// The message was already parsed once by NetworkClient; reuse its DOM
+static void handle_incoming_xml_and_update_state(const WwksMessage& message, HWND hwnd)
 {
-    pugi::xml_document doc;
-    pugi::xml_parse_result res = doc.load_string(xml.c_str());
-    if (!res) return;
-
-    pugi::xml_node root = doc.child("WWKS");
-    if (!root) return;
-
-    std::string messageType;
-    if (root.child("HelloResponse")) messageType = "HelloResponse";
-    else if (root.child("StatusResponse")) messageType = "StatusResponse";
-    else if (root.child("StockInfoResponse")) messageType = "StockInfoResponse";
-    else if (root.child("OutputResponse")) messageType = "OutputResponse";
-    else if (root.child("OutputMessage")) messageType = "OutputMessage";
-    else if (root.child("TaskInfoResponse")) messageType = "TaskInfoResponse";
-    else if (root.child("InputMessage")) messageType = "InputMessage";
+    if (!message.IsValid()) return;
+
+    pugi::xml_node root = message.root;
+    const WwksMessageType messageType = message.type;
+    const std::string& xml = message.xml;
 
     // Debug logging
     {
         char debugMsg[256];
-        snprintf(debugMsg, sizeof(debugMsg), "=== Received: %s ===", messageType.empty() ? "UNKNOWN" : messageType.c_str());
+        snprintf(debugMsg, sizeof(debugMsg), "=== Received: %s ===", messageType == WwksMessageType::Unknown ? "UNKNOWN" : message.TypeName());
         LogMessage(debugMsg);
-        if (messageType.empty())
+        if (messageType == WwksMessageType::Unknown)
         {
             LogMessage("Raw XML:");
             LogMessage(xml);
@@ -300,10 +355,11 @@ static void handle_incoming_xml_and_update_state(const std::string& xml, HWND hw
 
     {
         std::lock_guard<std::mutex> lock(g_state.mtx);
-        g_state.lastMessageType = messageType;
+        g_state.lastMessageType = message.TypeName();
+        publish_state_locked(SNAPSHOT_STATUS);
     }
 
-    if (messageType == "StatusResponse")
+    if (messageType == WwksMessageType::StatusResponse)
     {
         pugi::xml_node sr = root.child("StatusResponse");
         if (!sr) sr = root.find_node([](pugi::xml_node n){ return std::string(n.name()) == "StatusResponse"; });
@@ -337,6 +393,7 @@ static void handle_incoming_xml_and_update_state(const std::string& xml, HWND hw
                 std::lock_guard<std::mutex> lock(g_state.mtx);
                 g_state.robotState = display;
                 g_state.devices = deviceList;
+                publish_state_locked(SNAPSHOT_STATUS);
                 
                 char debugMsg[256];
                 snprintf(debugMsg, sizeof(debugMsg), "StatusResponse: State=%s, Devices=%zu", state.c_str(), deviceList.size());
@@ -371,6 +428,7 @@ static void handle_incoming_xml_and_update_state(const std::string& xml, HWND hw
                         
                         std::lock_guard<std::mutex> lock(g_state.mtx);
                         g_state.robotState = display;
+                        publish_state_locked(SNAPSHOT_STATUS);
                         
                         deviceList.emplace_back("StorageSystem", desc, compState, stateText);
                         break;
@@ -381,52 +439,53 @@ static void handle_incoming_xml_and_update_state(const std::string& xml, HWND hw
                 {
                     std::lock_guard<std::mutex> lock(g_state.mtx);
                     g_state.devices = deviceList;
+                    publish_state_locked(SNAPSHOT_STATUS);
                 }
             }
         }
     }
 
-    if (messageType == "StockInfoResponse")
+    if (messageType == WwksMessageType::StockInfoResponse)
     {
-        pugi::xml_node sir = root.child("StockInfoResponse");
-        if (!sir) sir = root.find_node([](pugi::xml_node n){ return std::string(n.name()) == "StockInfoResponse"; });
-        
+        // Streamed: no DOM and no article cap, articles are collected as they are scanned
         std::vector<std::pair<std::string,int>> list;
-        if (sir)
-        {
-            for (pugi::xml_node a : sir.children("Article"))
+        StockInfoStreamParser parser([&list](std::string_view id, int qty) {
+            // Filter: only keep articles starting with "RoWa" (case-insensitive)
+            if (id.size() >= 4 &&
+                ::toupper((unsigned char)id[0]) == 'R' && ::toupper((unsigned char)id[1]) == 'O' &&
+                ::toupper((unsigned char)id[2]) == 'W' && ::toupper((unsigned char)id[3]) == 'A')
             {
-                std::string id = a.attribute("Id") ? a.attribute("Id").value() : "";
-                int qty = a.attribute("Quantity") ? a.attribute("Quantity").as_int() : 0;
-                
-                // Filter: only keep articles starting with "RoWa" (case-insensitive)
-                if (!id.empty() && id.size() >= 4)
-                {
-                    std::string prefix = id.substr(0, 4);
-                    // Convert to uppercase for comparison
-                    std::transform(prefix.begin(), prefix.end(), prefix.begin(), ::toupper);
-                    
-                    if (prefix == "ROWA")
-                    {
-                        list.emplace_back(id, qty);
-                    }
-                }
-                
-                if (list.size() >= 200) break;
+                list.emplace_back(std::string(id), qty);
             }
+        });
+        parser.Feed(xml.data(), xml.size());
+
+        if (!parser.IsComplete())
+        {
+            LogMessage("StockInfoResponse is incomplete or malformed, keeping current article list");
+            PostMessage(hwnd, WM_APP_NETWORK_UPDATE, 0, 0);
+            return;
+        }
+
+        {
+            char debugMsg[256];
+            snprintf(debugMsg, sizeof(debugMsg), "StockInfoResponse: %zu articles, %zu RoWa articles kept", parser.GetArticleCount(), list.size());
+            LogMessage(debugMsg);
         }
         {
             std::lock_guard<std::mutex> lock(g_state.mtx);
-            g_state.articles = std::move(list);
-            g_state.fullArticlesList = g_state.articles;  // Keep a backup of the full list
+            g_state.articleStore.Assign(std::move(list));
+            g_state.articles.ShowAll();
             
             // reset selection if out of range
-            if (g_state.selectedIndex >= (int)g_state.articles.size()) g_state.selectedIndex = (int)g_state.articles.size() - 1;
+            if (g_state.selectedIndex >= (int)g_state.articles.Size()) g_state.selectedIndex = (int)g_state.articles.Size() - 1;
+
+            publish_state_locked(SNAPSHOT_ARTICLES);
         }
     }
 
     // Handle OutputMessage / OutputResponse / TaskInfoResponse updates
-    if (messageType == "OutputMessage" || messageType == "OutputResponse" || messageType == "TaskInfoResponse")
+    if (messageType == WwksMessageType::OutputMessage || messageType == WwksMessageType::OutputResponse || messageType == WwksMessageType::TaskInfoResponse)
     {
         // Try to find order id and article id and status
         std::string orderId;
@@ -444,11 +503,7 @@ static void handle_incoming_xml_and_update_state(const std::string& xml, HWND hw
             if (det) status = det.attribute("Status") ? det.attribute("Status").value() : "";
             
             // Determine ownership
-            bool isOurOutput = false;
-            {
-                std::lock_guard<std::mutex> lock(g_state.mtx);
-                isOurOutput = (g_state.ourOutputRequestIds.count(orderId) > 0);
-            }
+            bool isOurOutput = is_our_output(orderId);
             
             bool hasArticles = false;
             // Process all articles in this OutputMessage
@@ -480,15 +535,14 @@ static void handle_incoming_xml_and_update_state(const std::string& xml, HWND hw
             {
                 {
                     std::lock_guard<std::mutex> lock(g_state.mtx);
-                    auto it = std::find_if(g_state.outputRecords.begin(), g_state.outputRecords.end(),
-                        [&](const auto& t){ return std::get<0>(t) == orderId; });
+                    const OutputRecord* rec = g_state.orders.FindOrder(orderId);
                     
-                    if (it != g_state.outputRecords.end())
+                    if (rec)
                     {
-                        articleId = std::get<1>(*it);
-                        quantityRequested = std::get<2>(*it);  // Original requested quantity
+                        articleId = rec->articleId;
+                        quantityRequested = rec->quantityRequested;  // Original requested quantity
                         packsDelivered = 0;  // No packs were delivered
-                        isOurOutput = std::get<5>(*it);  // Get ownership from existing record
+                        isOurOutput = rec->isOurOutput;  // Get ownership from existing record
                         
                         char debugMsg[256];
                         snprintf(debugMsg, sizeof(debugMsg), "OutputMessage (empty): ArticleId=%s, Requested=%d, Delivered=0, Status=%s, IsOur=%s",
@@ -517,12 +571,8 @@ static void handle_incoming_xml_and_update_state(const std::string& xml, HWND hw
             pugi::xml_node det = orr.child("Details");
             if (det) status = det.attribute("Status") ? det.attribute("Status").value() : "";
             
-            // Determine ownership: check if this OutputRequest ID is in our sent requests
-            bool isOurOutput = false;
-            {
-                std::lock_guard<std::mutex> lock(g_state.mtx);
-                isOurOutput = (g_state.ourOutputRequestIds.count(orderId) > 0);
-            }
+            // Determine ownership: check if this OutputRequest ID is one we sent
+            bool isOurOutput = is_our_output(orderId);
             
             update_output_record_from_message(orderId, articleId, quantityReq, packsDel, status, isOurOutput);
         }
@@ -542,11 +592,7 @@ static void handle_incoming_xml_and_update_state(const std::string& xml, HWND hw
                 if (art) articleId = art.attribute("Id") ? art.attribute("Id").value() : "";
                 
                 // Determine ownership
-                bool isOurOutput = false;
-                {
-                    std::lock_guard<std::mutex> lock(g_state.mtx);
-                    isOurOutput = (g_state.ourOutputRequestIds.count(orderId) > 0);
-                }
+                bool isOurOutput = is_our_output(orderId);
                 
                 update_output_record_from_message(orderId, articleId, 1, 0, status, isOurOutput);
             }
@@ -557,40 +603,95 @@ static void handle_incoming_xml_and_update_state(const std::string& xml, HWND hw
     PostMessage(hwnd, WM_APP_NETWORK_UPDATE, 0, 0);
 }
 
+// Replay the capture given with /replay through the same state update as live messages,
+// then report the state engine's throughput in the log and the status line
+static void start_replay(HWND hwnd)
+{
+    g_replay = std::make_unique<TrafficReplay>();
+    std::string error;
+    if (!g_replay->Load(g_replayPath, error))
+    {
+        LogMessage("[REPLAY] " + error);
+        std::lock_guard<std::mutex> lock(g_state.mtx);
+        g_state.connectionState = "Replay failed";
+        publish_state_locked(SNAPSHOT_STATUS);
+        return;
+    }
+
+    {
+        char debugMsg[512];
+        snprintf(debugMsg, sizeof(debugMsg), "[REPLAY] %s: %zu messages over %lld ms, speed %g%s",
+            g_replayPath.c_str(), g_replay->Size(),
+            (long long)std::chrono::duration_cast<std::chrono::milliseconds>(g_replay->Duration()).count(), g_replaySpeed,
+            g_replay->Gaps() > 0 ? " (the capture has gaps, frames were dropped while capturing)" : "");
+        LogMessage(debugMsg);
+
+        std::lock_guard<std::mutex> lock(g_state.mtx);
+        g_state.connectionState = "Replaying capture";
+        publish_state_locked(SNAPSHOT_STATUS);
+    }
+
+    g_replayThread = std::thread([hwnd]() {
+        TrafficReplay::Options options;
+        options.speed = g_replaySpeed;
+        TrafficReplay::Result r = g_replay->Run(options, [hwnd](const WwksMessage& message) {
+            handle_incoming_xml_and_update_state(message, hwnd);
+        });
+
+        auto us = [](auto d) { return (long long)std::chrono::duration_cast<std::chrono::microseconds>(d).count(); };
+        char debugMsg[512];
+        snprintf(debugMsg, sizeof(debugMsg),
+            "[REPLAY] messages=%llu keepAlives=%llu invalid=%llu elapsedMs=%lld msgsPerSec=%.0f p50Us=%lld p99Us=%lld maxUs=%lld maxLagMs=%lld%s",
+            (unsigned long long)r.messages, (unsigned long long)r.keepAlives, (unsigned long long)r.invalid,
+            us(r.elapsed) / 1000, r.MessagesPerSecond(), us(r.perMessage.p50), us(r.perMessage.p99), us(r.perMessage.max),
+            us(r.maxLag) / 1000, r.stopped ? " (stopped)" : "");
+        LogMessage(debugMsg);
+
+        {
+            snprintf(debugMsg, sizeof(debugMsg), "Replay done: %.0f msg/s", r.MessagesPerSecond());
+            std::lock_guard<std::mutex> lock(g_state.mtx);
+            g_state.connectionState = debugMsg;
+            publish_state_locked(SNAPSHOT_STATUS);
+        }
+        PostMessage(hwnd, WM_APP_NETWORK_UPDATE, 0, 0);
+    });
+}
+
+// Build the OutputRequest for an order already in g_state.orders and queue it for sending
+static void queue_output_request(const std::string& id, const std::string& articleId, int qty)
+{
+    WwksMessageBuilder& b = request_builder();
+    b.Begin(std::time(nullptr))
+        .Element("OutputRequest").Attribute("Id", id).Attribute("Source", SharedVariables::SourceNumber).AttributeRaw("Destination", "999").Children()
+        .Element("Details").Attribute("OutputDestination", SharedVariables::OutputNumber).Attribute("Priority", SharedVariables::SelectedPrioItemText).Empty()
+        .Element("Criteria").Attribute("ArticleId", articleId).Attribute("Quantity", qty).Empty()
+        .Close("OutputRequest");
+
+    // send via network client (append newline like WriteLine); an unanswered request is logged
+    g_client->SendRequest(b.End(), WwksMessageType::OutputRequest, id, [articleId](const RequestTracker::Result& result) {
+        if (result.outcome != RequestOutcome::Answered)
+        {
+            LogMessage("OutputRequest " + result.id + " for article " + articleId + " got no OutputResponse (" + ToString(result.outcome) + ")");
+        }
+    });
+}
+
 // Send OutputRequest for an articleId with quantity
 static void send_output_request_for_article(const std::string& articleId, int qty)
 {
     if (!g_client) return;
     std::string id = make_unique_id();
-    std::ostringstream ss;
-    ss << "<WWKS Version=\"2.0\" TimeStamp=\"";
-    // timestamp in UTC-like simple format
-    {
-        auto now = std::chrono::system_clock::now();
-        std::time_t t = std::chrono::system_clock::to_time_t(now);
-        std::tm tm{};
-        gmtime_s(&tm, &t);
-        char buf[64];
-        strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
-        ss << buf;
-    }
-    ss << "\">";
-    ss << "<OutputRequest Id=\"" << id << "\" Source=\"" << SharedVariables::SourceNumber << "\" Destination=\"999\">";
-    ss << "<Details OutputDestination=\"" << SharedVariables::OutputNumber << "\" Priority=\"" << SharedVariables::SelectedPrioItemText << "\" />";
-    ss << "<Criteria ArticleId=\"" << articleId << "\" Quantity=\"" << qty << "\" />";
-    ss << "</OutputRequest>";
-    ss << "</WWKS>";
-
-    // Track this OutputRequest ID as ours for later ownership detection
+
+    // Add local output record as Queued(Blue) with 0 packs delivered initially, mark as ours.
+    // The record carries the ownership until the order completes (see is_our_output)
     {
         std::lock_guard<std::mutex> lock(g_state.mtx);
-        g_state.ourOutputRequestIds.insert(id);
-        // Add local output record as Queued(Blue) with 0 packs delivered initially, mark as ours
-        g_state.outputRecords.emplace_back(id, articleId, qty, 0, CLR_BLUE, true);
+        g_state.orders.SetOrder({ id, articleId, qty, 0, OutputStatus::Queued, true });
+        publish_state_locked(SNAPSHOT_ORDERS, { articleId });
     }
 
-    // send via network client (append newline like WriteLine)
-    g_client->SendMessage(ss.str());
+    queue_output_request(id, articleId, qty);
+
     // notify UI update
     HWND hwnd = FindWindowW(L"RowaPickupMainWindowClass", NULL);
     if (hwnd) PostMessage(hwnd, WM_APP_NETWORK_UPDATE, 0, 0);
@@ -601,24 +702,40 @@ static void send_output_request_for_all_articles()
 {
     if (!g_client) return;
     
+    // Record all orders and publish them as one state version (one copy of the touched chunks,
+    // instead of a new version per article)
     std::vector<std::pair<std::string,int>> articlesToSend;
+    std::vector<std::string> ids;
+    std::vector<std::string> changedArticleIds;
     {
         std::lock_guard<std::mutex> lock(g_state.mtx);
-        articlesToSend = g_state.articles;
-    }
-    
-    int count = 0;
-    for (const auto& art : articlesToSend)
-    {
-        if (art.second > 0)  // Only send if quantity > 0
+        for (auto& art : g_state.articles.CopyItems())
         {
-            send_output_request_for_article(art.first, art.second);
-            count++;
+            if (art.second <= 0) continue;  // Only send if quantity > 0
+
+            ids.push_back(make_unique_id());
+            g_state.orders.SetOrder({ ids.back(), art.first, art.second, 0, OutputStatus::Queued, true });
+            changedArticleIds.push_back(art.first);
+            articlesToSend.push_back(std::move(art));
         }
+        if (!changedArticleIds.empty())
+            publish_state_locked(SNAPSHOT_ORDERS, changedArticleIds);
+    }
+
+    for (size_t i = 0; i < articlesToSend.size(); i++)
+    {
+        queue_output_request(ids[i], articlesToSend[i].first, articlesToSend[i].second);
     }
+    int count = static_cast<int>(articlesToSend.size());
+
+    HWND hwnd = FindWindowW(L"RowaPickupMainWindowClass", NULL);
+    if (hwnd) PostMessage(hwnd, WM_APP_NETWORK_UPDATE, 0, 0);
     
+    // Only queued: the send queue's writer thread puts them on the wire
+    SendQueue::Counters sc = g_client->GetSendCounters();
     char debugMsg[256];
-    snprintf(debugMsg, sizeof(debugMsg), "Sent OutputRequest for %d articles", count);
+    snprintf(debugMsg, sizeof(debugMsg), "Queued OutputRequest for %d articles (send queue depth=%zu, bytes in flight=%zu)",
+             count, sc.depth, sc.bytesInFlight);
     LogMessage(debugMsg);
 }
 
@@ -759,20 +876,8 @@ static void perform_search_filter(HWND hWnd)
             {
                 std::lock_guard<std::mutex> lock(g_state.mtx);
                 
-                // Search for exact article match
-                for (const auto& art : g_state.articles)
-                {
-                    std::string upperArticleId = art.first;
-                    std::transform(upperArticleId.begin(), upperArticleId.end(), upperArticleId.begin(), ::toupper);
-                    
-                    if (upperArticleId == completeArticleCode && art.second > 0)
-                    {
-                        foundArticle = true;
-                        matchedArticleId = art.first;
-                        matchedArticleQty = art.second;
-                        break;
-                    }
-                }
+                // Search for exact article match (case-insensitive)
+                foundArticle = find_article_by_complete_code(completeArticleCode, matchedArticleId, matchedArticleQty);
             }  // Lock released here
             
             if (foundArticle)
@@ -816,31 +921,19 @@ static void perform_search_filter(HWND hWnd)
         g_state.selectedIndex = -1;
         g_state.scrollOffset = 0;
         
-        // Always filter from the full list
-        std::vector<std::pair<std::string,int>> filtered;
-        
+        // Always filter from the full list; the view only stores indices of the hits
         if (searchStr.empty())
         {
             // Empty search - show all articles from full list
-            filtered = g_state.fullArticlesList;
+            g_state.articles.ShowAll();
         }
         else
         {
-            // Filter from full list
-            for (const auto& art : g_state.fullArticlesList)
-            {
-                std::string upperArticle = art.first;
-                std::transform(upperArticle.begin(), upperArticle.end(), upperArticle.begin(), ::toupper);
-                
-                // Check if contains search text
-                if (upperArticle.find(searchStr) != std::string::npos)
-                {
-                    filtered.emplace_back(art);
-                }
-            }
+            // Check if contains search text
+            g_state.articles.Filter([&searchStr](const Article& art) { return contains_upper(art.first, searchStr); });
         }
-        
-        g_state.articles = filtered;
+
+        publish_state_locked(SNAPSHOT_FILTER);
     }
     
     // Trigger UI update
@@ -868,7 +961,7 @@ static void handle_tab_navigation(HWND hWnd, bool shiftPressed)
             // Search -> List (set focus to main window, which will select first article)
             SetFocus(hWnd);
             std::lock_guard<std::mutex> lock(g_state.mtx);
-            if (g_state.articles.size() > 0 && g_state.selectedIndex < 0)
+            if (g_state.articles.Size() > 0 && g_state.selectedIndex < 0)
             {
                 g_state.selectedIndex = 0;
             }
@@ -893,7 +986,7 @@ static void handle_tab_navigation(HWND hWnd, bool shiftPressed)
             // Refresh -> List (set focus to main window)
             SetFocus(hWnd);
             std::lock_guard<std::mutex> lock(g_state.mtx);
-            if (g_state.articles.size() > 0 && g_state.selectedIndex < 0)
+            if (g_state.articles.Size() > 0 && g_state.selectedIndex < 0)
             {
                 g_state.selectedIndex = 0;
             }
@@ -1267,11 +1360,44 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         g_client->LogMessage = [](const std::string& msg) {
             LogMessage(msg);
         };
+
+        // Identity for the handshake, read from the current settings
+        g_client->Identity = []() {
+            ClientIdentity identity;
+            identity.sourceNumber = SharedVariables::SourceNumber;
+            identity.tenantId = SharedVariables::TenantId;
+            identity.stockLocation = SharedVariables::RobotStockLocation;
+            return identity;
+        };
         
-        g_client->MessageReceived = [hWnd](const std::string& type, const std::string& xml) {
-            // parse and update
-            handle_incoming_xml_and_update_state(xml, hWnd);
+        g_client->MessageReceived = [hWnd](const WwksMessage& message) {
+            // update state from the already parsed message
+            handle_incoming_xml_and_update_state(message, hWnd);
         };
+
+        // /replay: the state is filled from the capture only, no connection is made
+        if (!g_replayPath.empty())
+        {
+            start_replay(hWnd);
+            return 0;
+        }
+
+        // /capture: <protocol log name>.wwkscap
+        if (g_captureTraffic && g_logFilePath.size() > 4)
+        {
+            std::string capturePath = g_logFilePath.substr(0, g_logFilePath.size() - 4) + ".wwkscap";
+            g_capture = std::make_shared<TrafficCaptureWriter>();
+            if (g_capture->Open(capturePath))
+            {
+                LogMessage("Capturing WWKS traffic to " + capturePath);
+                g_client->SetCapture(g_capture);
+            }
+            else
+            {
+                LogMessage("Cannot create traffic capture " + capturePath);
+                g_capture.reset();
+            }
+        }
         
         // Connection state callback - update UI when connection state changes
         g_client->ConnectionStateChanged = [hWnd](ConnectionState state, ConnectionError error, const std::string& description) {
@@ -1317,6 +1443,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 break;
             }
             }
+            publish_state_locked(SNAPSHOT_STATUS);
             
             // Post update to refresh the UI
             PostMessage(hWnd, WM_APP_NETWORK_UPDATE, 0, 0);
@@ -1328,6 +1455,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             {
                 std::lock_guard<std::mutex> lock(g_state.mtx);
                 g_state.connectionState = ok ? "Connected" : "Not connected";
+                publish_state_locked(SNAPSHOT_STATUS);
             }
             
             // If connection failed, start automatic polling
@@ -1340,8 +1468,9 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             }
             
             // Connection successful - Connect() already handles the WWKS2 handshake
-            // (HelloRequest -> StatusRequest -> StockInfoRequest)
-            // Just trigger a UI update
+            // (HelloRequest -> StatusRequest -> StockInfoRequest).
+            // Polling keeps it up: a lost connection is reconnected with backoff
+            g_client->StartConnectionPolling(SharedVariables::ClientIpAddress, SharedVariables::ClientPort);
             PostMessage(hWnd, WM_APP_NETWORK_UPDATE, 0, 0);
         }).detach();
 
@@ -1404,29 +1533,44 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hWnd, &ps);
 
-        // snapshot state
-        std::string conn, robot, lastType;
-        std::vector<std::pair<std::string,int>> articles;
-        std::vector<std::tuple<std::string,std::string,int,int,COLORREF,bool>> outputs;
-        int sel = -1;
-        int scrollOffset = 0;
-        {
-            std::lock_guard<std::mutex> lock(g_state.mtx);
-            conn = g_state.connectionState;
-            robot = g_state.robotState;
-            lastType = g_state.lastMessageType;
-            articles = g_state.articles;
-            outputs = g_state.outputRecords;
-            sel = g_state.selectedIndex;
-            scrollOffset = g_state.scrollOffset;
-        }
-
         // Get window dimensions
         RECT rcWindow;
         GetClientRect(hWnd, &rcWindow);
         int wnd_width = rcWindow.right - rcWindow.left;
         int wnd_height = rcWindow.bottom - rcWindow.top;
 
+        // Calculate visible rows
+        int contentHeight = wnd_height - TITLE_BAR_HEIGHT - HEADER_HEIGHT - SEARCH_AREA_HEIGHT - STATUS_BAR_HEIGHT;
+        int visibleRows = contentHeight / ROW_HEIGHT;
+
+        // Pin the current state version: no lock on g_state.mtx, only the visible rows are read
+        auto snapshot = g_snapshots.Acquire();
+        const StateSnapshot& state = snapshot->value;
+        const std::string& conn = state.connectionState;
+        const std::string& robot = state.robotState;
+        const std::string& lastType = state.lastMessageType;
+        int sel = g_state.selectedIndex;
+        int scrollOffset = g_state.scrollOffset;
+        int totalRows = (int)state.RowCount();
+        int maxScroll = (totalRows > visibleRows) ? (totalRows - visibleRows) : 0;
+
+        // Clamp scroll offset
+        if (scrollOffset > maxScroll) scrollOffset = maxScroll;
+        if (scrollOffset < 0) scrollOffset = 0;
+
+        struct RowSnapshot
+        {
+            std::pair<std::string,int> art;
+            OrderDisplay order;
+        };
+        std::vector<RowSnapshot> rows;
+        for (int i = scrollOffset; i < totalRows && (int)rows.size() < visibleRows; i++)
+        {
+            RowSnapshot row;
+            state.GetRow(i, row.art.first, row.art.second, row.order);
+            rows.push_back(std::move(row));
+        }
+
         // Draw title bar
         RECT titleRect = { 0, 0, wnd_width, TITLE_BAR_HEIGHT };
         HBRUSH hBrushTitle = CreateSolidBrush(CLR_TITLEBAR_BG);
@@ -1494,24 +1638,15 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 (int)Localization::GetString(RowaPickupSlim::STR_COL_ARTICLE).length());
         x += COL_ARTICLE_ID;
 
-        // Calculate visible rows
-        int contentHeight = wnd_height - TITLE_BAR_HEIGHT - HEADER_HEIGHT - SEARCH_AREA_HEIGHT - STATUS_BAR_HEIGHT;
-        int visibleRows = contentHeight / ROW_HEIGHT;
-        int totalRows = (int)articles.size();
-        int maxScroll = (totalRows > visibleRows) ? (totalRows - visibleRows) : 0;
-        
-        // Clamp scroll offset
-        if (scrollOffset > maxScroll) scrollOffset = maxScroll;
-        if (scrollOffset < 0) scrollOffset = 0;
-
         // Draw article rows
         {
             int rowY = TITLE_BAR_HEIGHT + HEADER_HEIGHT;
             int rowIndex = 0;
 
-            for (int i = scrollOffset; i < totalRows && rowIndex < visibleRows; i++, rowIndex++)
+            for (int i = scrollOffset; rowIndex < (int)rows.size(); i++, rowIndex++)
             {
-                const auto& art = articles[i];
+                const RowSnapshot& row = rows[rowIndex];
+                const auto& art = row.art;
                 const std::string& id = art.first;
                 int qty = art.second;
 
@@ -1519,49 +1654,46 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 COLORREF fillColor = (qty == 0) ? CLR_GREY : CLR_PURPLE;
                 std::wstring tooltipMsg;  // For output record tooltip
                 
-                for (const auto& rec : outputs)
+                if (row.order.hasOrder)
                 {
-                    if (std::get<1>(rec) == id)
+                    const OrderDisplay& rec = row.order;
+                    fillColor = output_record_color(rec);
+                    int requested = rec.quantityRequested;
+                    int delivered = rec.packsDelivered;
+                    bool isOurs = rec.isOurOutput;
+                    
+                    if (fillColor == CLR_BLUE)
                     {
-                        fillColor = std::get<4>(rec);  // 6-tuple: idx 4 is color
-                        int requested = std::get<2>(rec);
-                        int delivered = std::get<3>(rec);
-                        bool isOurs = std::get<5>(rec);  // 6-tuple: idx 5 is ownership
-                        
-                        if (fillColor == CLR_BLUE)
-                        {
-                            // Queued (our output)
-                            tooltipMsg = Localization::GetString(RowaPickupSlim::STR_OUR_REQUEST_LOADING);
-                        }
-                        else if (fillColor == CLR_YELLOW)
-                        {
-                            // Queued (other client's output)
-                            tooltipMsg = Localization::GetString(RowaPickupSlim::STR_OTHER_REQUEST_LOADING);
-                        }
-                        else if (fillColor == CLR_ORANGE)
+                        // Queued (our output)
+                        tooltipMsg = Localization::GetString(RowaPickupSlim::STR_OUR_REQUEST_LOADING);
+                    }
+                    else if (fillColor == CLR_YELLOW)
+                    {
+                        // Queued (other client's output)
+                        tooltipMsg = Localization::GetString(RowaPickupSlim::STR_OTHER_REQUEST_LOADING);
+                    }
+                    else if (fillColor == CLR_ORANGE)
+                    {
+                        // InProcess
+                        tooltipMsg = Localization::GetString(RowaPickupSlim::STR_PICKER_LOADING);
+                    }
+                    else if (fillColor == CLR_RED)
+                    {
+                        // Incomplete
+                        if (delivered == 0)
                         {
-                            // InProcess
-                            tooltipMsg = Localization::GetString(RowaPickupSlim::STR_PICKER_LOADING);
+                            tooltipMsg = Localization::GetString(RowaPickupSlim::STR_PICKER_FAILED);
                         }
-                        else if (fillColor == CLR_RED)
+                        else
                         {
-                            // Incomplete
-                            if (delivered == 0)
-                            {
-                                tooltipMsg = Localization::GetString(RowaPickupSlim::STR_PICKER_FAILED);
-                            }
-                            else
-                            {
-                                tooltipMsg = Localization::GetString(RowaPickupSlim::STR_PICKER_PARTIAL_FULL);
-                                size_t pos1 = tooltipMsg.find(L"{0}");
-                                if (pos1 != std::wstring::npos)
-                                    tooltipMsg.replace(pos1, 3, utf8_to_wstring(std::to_string(delivered)));
-                                size_t pos2 = tooltipMsg.find(L"{1}");
-                                if (pos2 != std::wstring::npos)
-                                    tooltipMsg.replace(pos2, 3, utf8_to_wstring(std::to_string(requested)));
-                            }
+                            tooltipMsg = Localization::GetString(RowaPickupSlim::STR_PICKER_PARTIAL_FULL);
+                            size_t pos1 = tooltipMsg.find(L"{0}");
+                            if (pos1 != std::wstring::npos)
+                                tooltipMsg.replace(pos1, 3, utf8_to_wstring(std::to_string(delivered)));
+                            size_t pos2 = tooltipMsg.find(L"{1}");
+                            if (pos2 != std::wstring::npos)
+                                tooltipMsg.replace(pos2, 3, utf8_to_wstring(std::to_string(requested)));
                         }
-                        break;
                     }
                 }
 
@@ -1659,8 +1791,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             int scrollbarLeft = wnd_width - SCROLLBAR_WIDTH;
             
             // Get current state info
-            std::lock_guard<std::mutex> lock(g_state.mtx);
-            int totalRows = (int)g_state.articles.size();
+            int totalRows = (int)g_snapshots.Acquire()->value.RowCount();
             int visibleRows = contentHeight / ROW_HEIGHT;
             int maxScroll = (totalRows > visibleRows) ? (totalRows - visibleRows) : 0;
             
@@ -1697,11 +1828,8 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         if (my < TITLE_BAR_HEIGHT && mx > wnd_width - 300)
         {
             // Build device list text
-            std::vector<std::tuple<std::string,std::string,std::string,std::string>> devList;
-            {
-                std::lock_guard<std::mutex> lock(g_state.mtx);
-                devList = g_state.devices;
-            }
+            auto snapshot = g_snapshots.Acquire();
+            const auto& devList = snapshot->value.devices;
             
             if (!devList.empty())
             {
@@ -1733,73 +1861,60 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 // Get the row index
                 int rowOffset = (my - TITLE_BAR_HEIGHT - HEADER_HEIGHT) / ROW_HEIGHT;
                 
-                std::vector<std::pair<std::string,int>> articles;
-                std::vector<std::tuple<std::string,std::string,int,int,COLORREF,bool>> outputs;
-                int scrollOffset = 0;
+                // Read only the hovered row from the current state version
+                std::string articleId;
+                int articleQty = 0;
+                OrderDisplay order;
+                int rowIdx = g_state.scrollOffset + rowOffset;
+                g_snapshots.Acquire()->value.GetRow(rowIdx, articleId, articleQty, order);
                 
+                // Output record with tooltip
+                if (order.hasOrder)
                 {
-                    std::lock_guard<std::mutex> lock(g_state.mtx);
-                    articles = g_state.articles;
-                    outputs = g_state.outputRecords;
-                    scrollOffset = g_state.scrollOffset;
-                }
-                
-                int rowIdx = scrollOffset + rowOffset;
-                if (rowIdx < (int)articles.size())
-                {
-                    const auto& art = articles[rowIdx];
+                    COLORREF color = output_record_color(order);
+                    int delivered = order.packsDelivered;
+                    int requested = order.quantityRequested;
+                    bool isOurs = order.isOurOutput;
                     
-                    // Look for output record with tooltip
-                    for (const auto& rec : outputs)
+                    std::wstring tooltipMsg;
+                    if (color == CLR_BLUE)
                     {
-                        if (std::get<1>(rec) == art.first)
+                        // Our output - Queued
+                        tooltipMsg = Localization::GetString(RowaPickupSlim::STR_OUR_REQUEST_LOADING);
+                    }
+                    else if (color == CLR_YELLOW)
+                    {
+                        // Other client's output - Queued
+                        tooltipMsg = Localization::GetString(RowaPickupSlim::STR_OTHER_REQUEST_LOADING);
+                    }
+                    else if (color == CLR_ORANGE)
+                    {
+                        // InProcess
+                        tooltipMsg = Localization::GetString(RowaPickupSlim::STR_PICKER_LOADING);
+                    }
+                    else if (color == CLR_RED)
+                    {
+                        // Incomplete
+                        if (delivered == 0)
                         {
-                            COLORREF color = std::get<4>(rec);
-                            int delivered = std::get<3>(rec);
-                            int requested = std::get<2>(rec);
-                            bool isOurs = std::get<5>(rec);
-                            
-                            std::wstring tooltipMsg;
-                            if (color == CLR_BLUE)
-                            {
-                                // Our output - Queued
-                                tooltipMsg = Localization::GetString(RowaPickupSlim::STR_OUR_REQUEST_LOADING);
-                            }
-                            else if (color == CLR_YELLOW)
-                            {
-                                // Other client's output - Queued
-                                tooltipMsg = Localization::GetString(RowaPickupSlim::STR_OTHER_REQUEST_LOADING);
-                            }
-                            else if (color == CLR_ORANGE)
-                            {
-                                // InProcess
-                                tooltipMsg = Localization::GetString(RowaPickupSlim::STR_PICKER_LOADING);
-                            }
-                            else if (color == CLR_RED)
-                            {
-                                // Incomplete
-                                if (delivered == 0)
-                                {
-                                    tooltipMsg = Localization::GetString(RowaPickupSlim::STR_PICKER_FAILED);
-                                }
-                                else
-                                {
-                                    tooltipMsg = Localization::GetString(RowaPickupSlim::STR_PICKER_PARTIAL_FULL);
-                                    size_t pos1 = tooltipMsg.find(L"{0}");
-                                    if (pos1 != std::wstring::npos)
-                                        tooltipMsg.replace(pos1, 3, utf8_to_wstring(std::to_string(delivered)));
-                                    size_t pos2 = tooltipMsg.find(L"{1}");
-                                    if (pos2 != std::wstring::npos)
-                                        tooltipMsg.replace(pos2, 3, utf8_to_wstring(std::to_string(requested)));
-                                }
-                            }
-                            
-                            POINT pt = { mx + 15, my + 15 };
-                            ClientToScreen(hWnd, &pt);
-                            ShowTooltip(hWnd, pt.x, pt.y, tooltipMsg);
-                            return 0;
+                            tooltipMsg = Localization::GetString(RowaPickupSlim::STR_PICKER_FAILED);
+                        }
+                        else
+                        {
+                            tooltipMsg = Localization::GetString(RowaPickupSlim::STR_PICKER_PARTIAL_FULL);
+                            size_t pos1 = tooltipMsg.find(L"{0}");
+                            if (pos1 != std::wstring::npos)
+                                tooltipMsg.replace(pos1, 3, utf8_to_wstring(std::to_string(delivered)));
+                            size_t pos2 = tooltipMsg.find(L"{1}");
+                            if (pos2 != std::wstring::npos)
+                                tooltipMsg.replace(pos2, 3, utf8_to_wstring(std::to_string(requested)));
                         }
                     }
+                    
+                    POINT pt = { mx + 15, my + 15 };
+                    ClientToScreen(hWnd, &pt);
+                    ShowTooltip(hWnd, pt.x, pt.y, tooltipMsg);
+                    return 0;
                 }
             }
             
@@ -1840,7 +1955,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             int scrollbarHeight = contentHeight;
             
             std::lock_guard<std::mutex> lock(g_state.mtx);
-            int totalRows = (int)g_state.articles.size();
+            int totalRows = (int)g_state.articles.Size();
             int visibleRows = contentHeight / ROW_HEIGHT;
             int maxScroll = (totalRows > visibleRows) ? (totalRows - visibleRows) : 0;
             
@@ -1901,7 +2016,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             {
                 std::lock_guard<std::mutex> lock(g_state.mtx);
                 int idx = g_state.scrollOffset + rowOffset;
-                if (idx < (int)g_state.articles.size())
+                if (idx < (int)g_state.articles.Size())
                 {
                     g_state.selectedIndex = idx;
                 }
@@ -1942,7 +2057,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             {
                 std::lock_guard<std::mutex> lock(g_state.mtx);
                 int idx = g_state.scrollOffset + rowOffset;
-                if (idx >= 0 && idx < (int)g_state.articles.size())
+                if (idx >= 0 && idx < (int)g_state.articles.Size())
                 {
                     articleId = g_state.articles[idx].first;
                     articleQty = g_state.articles[idx].second;
@@ -2000,7 +2115,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             std::lock_guard<std::mutex> lock(g_state.mtx);
             int contentHeight = rcWindow.bottom - TITLE_BAR_HEIGHT - HEADER_HEIGHT - SEARCH_AREA_HEIGHT;
             int visibleRows = contentHeight / ROW_HEIGHT;
-            int totalRows = (int)g_state.articles.size();
+            int totalRows = (int)g_state.articles.Size();
             int maxScroll = (totalRows > visibleRows) ? (totalRows - visibleRows) : 0;
             
             g_state.scrollOffset += scrollLines;
@@ -2037,7 +2152,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             int singleArticleQty = 0;
             {
                 std::lock_guard<std::mutex> lock(g_state.mtx);
-                articleCount = (int)g_state.articles.size();
+                articleCount = (int)g_state.articles.Size();
                 if (articleCount == 1)
                 {
                     singleArticleId = g_state.articles[0].first;
@@ -2072,7 +2187,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         if (wParam == VK_UP || wParam == VK_DOWN || wParam == VK_PRIOR || wParam == VK_NEXT)
         {
             std::lock_guard<std::mutex> lock(g_state.mtx);
-            int n = (int)g_state.articles.size();
+            int n = (int)g_state.articles.Size();
             
             RECT rcWindow;
             GetClientRect(hWnd, &rcWindow);
@@ -2122,7 +2237,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         {
             // Handle Enter on selected article (not in search field)
             std::lock_guard<std::mutex> lock(g_state.mtx);
-            int n = (int)g_state.articles.size();
+            int n = (int)g_state.articles.Size();
             int sel = g_state.selectedIndex;
             
             if (n > 0 && sel >= 0 && sel < n)
@@ -2180,19 +2295,12 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                         LogMessage("  State 1 (Connected): Sending StockInfoRequest without reconnect");
                         
                         std::string id = make_unique_id();
-                        std::ostringstream ss;
-                        ss << "<WWKS Version=\"2.0\" TimeStamp=\"";
-                        auto now = std::chrono::system_clock::now();
-                        std::time_t t = std::chrono::system_clock::to_time_t(now);
-                        std::tm tm{};
-                        gmtime_s(&tm, &t);
-                        char buf[64];
-                        strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
-                        ss << buf << "\">";
-                        ss << "<StockInfoRequest Id=\"" << id << "\" Source=\"" << SharedVariables::SourceNumber << "\" Destination=\"999\" IncludePacks=\"False\" IncludeArticleDetails=\"False\">";
-                        ss << "<Criteria StockLocationId=\"" << SharedVariables::RobotStockLocation << "\" />";
-                        ss << "</StockInfoRequest>";
-                        ss << "</WWKS>";
+                        WwksMessageBuilder& b = request_builder();
+                        b.Begin(std::time(nullptr))
+                            .Element("StockInfoRequest").Attribute("Id", id).Attribute("Source", SharedVariables::SourceNumber)
+                            .AttributeRaw("Destination", "999").AttributeRaw("IncludePacks", "False").AttributeRaw("IncludeArticleDetails", "False").Children()
+                            .Element("Criteria").Attribute("StockLocationId", SharedVariables::RobotStockLocation).Empty()
+                            .Close("StockInfoRequest");
                         
                         // Clear search field and reset to full list
                         HWND hEdit = GetDlgItem(hWnd, ID_SEARCH_EDIT);
@@ -2202,10 +2310,11 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                             std::lock_guard<std::mutex> lock(g_state.mtx);
                             g_state.selectedIndex = -1;
                             g_state.scrollOffset = 0;
-                            g_state.articles = g_state.fullArticlesList;
+                            g_state.articles.ShowAll();
+                            publish_state_locked(SNAPSHOT_FILTER);
                         }
                         
-                        g_client->SendMessage(ss.str());
+                        g_client->SendRequest(b.End(), WwksMessageType::StockInfoRequest, id);
                         return 0;
                     }
                     
@@ -2222,11 +2331,22 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 
     case WM_DESTROY:
     {
+        if (g_replay)
+        {
+            g_replay->Stop();
+            if (g_replayThread.joinable()) g_replayThread.join();
+        }
         if (g_client)
         {
             g_client->Close();
             g_client.reset();
         }
+        if (g_capture)
+        {
+            TrafficCaptureWriter::Counters cc = g_capture->GetCounters();
+            g_capture->Stop();
+            LogMessage("[CAPTURE] records=" + std::to_string(cc.records) + " dropped=" + std::to_string(cc.dropped));
+        }
         SettingsDialog::Destroy();
         PostQuitMessage(0);
         return 0;
@@ -2262,7 +2382,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             {
                 std::lock_guard<std::mutex> lock(g_state.mtx);
                 sel = g_state.selectedIndex;
-                if (sel >= 0 && sel < (int)g_state.articles.size())
+                if (sel >= 0 && sel < (int)g_state.articles.Size())
                 {
                     artId = g_state.articles[sel].first;
                     artQty = g_state.articles[sel].second;
@@ -2308,6 +2428,26 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 {
     // Initialize common controls (required for tooltips)
     InitCommonControls();
+
+    // Command line switches, see g_captureTraffic / g_replayPath
+    int argc = 0;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    for (int i = 1; argv && i < argc; i++)
+    {
+        std::wstring arg = argv[i];
+        if (arg == L"/capture")
+        {
+            g_captureTraffic = true;
+        }
+        else if (arg == L"/replay" && i + 1 < argc)
+        {
+            char path[MAX_PATH] = {};
+            WideCharToMultiByte(CP_ACP, 0, argv[++i], -1, path, sizeof(path), NULL, NULL);
+            g_replayPath = path;
+            if (i + 1 < argc && iswdigit(argv[i + 1][0])) g_replaySpeed = _wtof(argv[++i]);
+        }
+    }
+    if (argv) LocalFree(argv);
     
     const wchar_t CLASS_NAME[] = L"RowaPickupMainWindowClass";
 
@@ -2363,5 +2503,8 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
         TranslateMessage(&msg);
         DispatchMessage(&msg);
     }
+
+    // Write all queued log messages before the process exits
+    LoggingSystem::Shutdown();
     return (int)msg.wParam;
 }
@@ -2,8 +2,6 @@
 // networkclient.h
 // Declaration matching the implementation in networkclient.cpp
 
-#include <winsock2.h>
-#include <ws2tcpip.h>
 #undef SendMessage  // Undefine Windows macro that conflicts with our method name
 #include <thread>
 #include <atomic>
@@ -11,7 +9,25 @@
 #include <string>
 #include <vector>
 #include <mutex>
-#include "SharedVariables.h"  // For NetworkConnectionState enum
+#include <memory>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include "MessageDispatcher.h"
+#include "WwksMessage.h"
+#include "Reactor.h"
+#include "Transport.h"
+#include "SendQueue.h"
+#include "Handshake.h"
+#include "RequestTracker.h"
+#include "ReconnectPolicy.h"
+#include "TcpConnector.h"
+#include "LivenessMonitor.h"
+#include "KeepAliveReply.h"
+#include "LatencyHistogram.h"
+#include "TrafficCapture.h"
+#include "WwksMessageBuilder.h"
+#include "IsoTimestamp.h"
 
 
 
@@ -53,12 +69,32 @@ namespace RowaPickupSlim
         Other                   // Other error
     };
 
+    // Who the client introduces itself as (Subscriber / Source / StockLocationId of the requests)
+    struct ClientIdentity
+    {
+        int sourceNumber = 0;
+        std::string tenantId;           // Optional, multi-tenant systems
+        std::string stockLocation;
+    };
+
+    // Received time minus the robot's WWKS TimeStamp, over all received messages: transfer latency
+    // plus the robot's clock offset (to whole seconds if the robot sends whole-second timestamps)
+    struct RobotClockStats
+    {
+        uint64_t samples = 0;
+        uint64_t unparsed = 0;                  // TimeStamp missing or not ISO-8601
+        std::chrono::milliseconds last{};
+        std::chrono::milliseconds min{};
+        std::chrono::milliseconds max{};
+    };
+
     class NetworkClient
     {
     public:
         // Callback invoked when a complete WWKS message is received.
-        // Parameters: messageType, completeXml
-        std::function<void(const std::string&, const std::string&)> MessageReceived;
+        // The message is parsed once by the client; handlers read message.type / message.root.
+        // On disconnect it is invoked with an empty (invalid) message.
+        std::function<void(const WwksMessage&)> MessageReceived;
 
         // Logging callback: receives log messages
         std::function<void(const std::string&)> LogMessage;
@@ -67,24 +103,52 @@ namespace RowaPickupSlim
         // Parameters: newState, errorType, errorDescription
         std::function<void(ConnectionState, ConnectionError, const std::string&)> ConnectionStateChanged;
 
-        NetworkClient();
+        // Identity used in the handshake requests, read each time one is built
+        std::function<ClientIdentity()> Identity;
+
+        // dispatchLanes: worker threads that run MessageReceived (1 = strict arrival order).
+        // Messages for the same order ID always share a lane.
+        explicit NetworkClient(size_t dispatchLanes = 1, size_t dispatchQueueCapacity = 256);
         ~NetworkClient();
 
-        // Connect to server (blocking). After successful connect a receive thread is started.
+        // Connect to server (blocks the caller until connected or the connect deadline passes; all
+        // addresses of the server are raced, see TcpConnector). After successful connect a receive
+        // thread is started that waits for socket readiness in a Reactor (no receive timeout polling).
         bool Connect(const std::string& serverIp, int port);
 
-        // Send a single message (WriteLine-like behaviour)
-        bool SendMessage(const std::string& message);
+        // Run the client over an already connected transport (e.g. a LoopbackTransport in tests and
+        // benchmarks); everything after the connect is the same as for TCP
+        bool Connect(std::unique_ptr<Transport> transport);
+
+        // Send a single message (WriteLine-like behaviour). Only queues it; never waits for the network.
+        // Returns false if the message could not be queued (not connected / empty after filtering).
+        bool SendMessage(std::string_view message);
+
+        // As SendMessage; the future becomes true once the message was written to the transport
+        std::future<bool> SendMessageAsync(std::string_view message);
+
+        // Send a request and track it until the response with the same Id arrives.
+        // The future / callback complete exactly once: answered, timed out, disconnected or not sent.
+        std::future<RequestTracker::Result> SendRequest(std::string_view message, WwksMessageType requestType,
+            const std::string& id, RequestTracker::Callback callback = nullptr);
+
+        // Invoked (on the network thread) for every request that completes without a response
+        std::function<void(const RequestTracker::Result&)> RequestFailed;
 
         // Close connection and stop background thread
         void Close();
         
-        // Start automatic reconnection polling (tries every 5 seconds, max 10 attempts)
-        // Call this when connection fails or settings change
+        // Start automatic reconnection: keeps the connection up until StopConnectionPolling() / Close(),
+        // reconnecting with backoff (see ReconnectPolicy) whenever it is lost.
+        // Call this when connection fails or settings change; calling it again while polling retries at once.
         void StartConnectionPolling(const std::string& serverIp, int port);
         
         // Stop automatic reconnection polling
         void StopConnectionPolling();
+
+        // Reconnection attempts / outage durations
+        ReconnectPolicy::Metrics GetReconnectMetrics() const;
+        void SetReconnectOptions(const ReconnectPolicy::Options& options);
         
         // Check if currently connected
         bool IsConnected() const;
@@ -102,41 +166,150 @@ namespace RowaPickupSlim
         // Get handshake complete state
         bool IsHandshakeComplete() const;
 
+        // Connect deadline (all addresses) and the head start of each address, used from the next Connect()
+        void SetConnectOptions(std::chrono::milliseconds timeout, std::chrono::milliseconds attemptDelay);
+
+        // Dead-peer detection (missed KeepAlive intervals, StatusRequest probe) and the socket's
+        // TCP keepalive idle time / probe interval, used from the next Connect()
+        void SetLivenessOptions(const LivenessMonitor::Options& options,
+            std::chrono::milliseconds tcpKeepAliveIdle, std::chrono::milliseconds tcpKeepAliveInterval);
+
+        // Handshake step timeouts / retries / pipelining, used from the next Connect()
+        void SetHandshakeOptions(const Handshake::Options& options);
+
+        // Get dispatch queue depth / wait time counters
+        MessageDispatcher::Counters GetDispatchCounters() const;
+
+        // Get send queue depth / bytes in flight counters
+        SendQueue::Counters GetSendCounters() const;
+
+        // Get KeepAliveRequest received -> KeepAliveResponse written latency (p50 / p99 / max), all connections
+        LatencyHistogram::Summary GetKeepAliveTurnaround() const;
+
+        // Get received time - robot TimeStamp, all connections
+        RobotClockStats GetRobotClock() const;
+
+        // Get request -> response latency / failure counters of a request type
+        RequestTracker::Stats GetRequestStats(WwksMessageType requestType) const;
+
+        // Change the response timeout of a request type
+        void SetRequestTimeout(WwksMessageType requestType, std::chrono::milliseconds timeout);
+
+        // Record every frame received and sent (KeepAlives included) to a traffic capture; nullptr stops.
+        // Takes effect at once, also on a running connection
+        void SetCapture(std::shared_ptr<TrafficCaptureWriter> capture);
+
         static bool IsValidIpAddress(const std::string& ipAddress);
         static bool IsValidPort(int port);
 
     private:
-        SOCKET _sock;
+        std::unique_ptr<Transport> _transport;      // Connection in use (guarded by _mtx)
         std::thread _recvThread;
         std::atomic<bool> _running;
-        std::mutex _mtx;
+        mutable std::mutex _mtx;
+
+        // Event loop of the current connection, run by _recvThread (created in Connect, guarded by _mtx)
+        std::unique_ptr<Reactor> _reactor;
+
+        // Connect() in progress: serialized by _connectMtx, abandoned by Close()
+        std::mutex _connectMtx;
+        std::atomic<bool> _connectAbort{ false };
+        TcpConnector::Options _connectOptions;     // Guarded by _mtx
+
+        // Dead-peer detection (guarded by _mtx; the monitor itself lives on the receive thread)
+        LivenessMonitor::Options _livenessOptions;
+        std::chrono::milliseconds _tcpKeepAliveIdle{ 10000 };
+        std::chrono::milliseconds _tcpKeepAliveInterval{ 1000 };
         
         // Connection state tracking
         ConnectionState _currentState;
         ConnectionError _lastError;
         NetworkConnectionState _networkState;  // State machine for connection management
         
-        // Handshake state tracking
-        bool _handshakeComplete;
-        std::atomic<bool> _helloResponseReceived;
-        std::atomic<bool> _statusResponseReceived;
+        // Handshake state tracking (the state machine itself lives on the receive thread)
+        std::atomic<bool> _handshakeComplete;
+        Handshake::Options _handshakeOptions;
         
         // Connection polling
         std::thread _pollingThread;
         std::atomic<bool> _pollingActive;
+        std::mutex _pollMtx;
+        std::condition_variable _pollWake;     // Connection lost / polling stopped / retry now
+        bool _pollRetryNow = false;            // Guarded by _pollMtx
+        ReconnectPolicy _reconnect;
         std::string _pollIp;
         int _pollPort;
 
+        // Ordered dispatch of received messages (replaces a detached thread per message)
+        MessageDispatcher _dispatcher;
+
+        // One parser per dispatch lane, used only by that lane's thread (DOM in a reused arena)
+        std::vector<std::unique_ptr<WwksMessageParser>> _parsers;
+
+        // Messages a full dispatch lane had no room for yet (receive thread only). The receive thread
+        // never waits for the handlers: it keeps reading and answering KeepAlives, and only pauses the
+        // transport while the backlog holds more than BACKLOG_PAUSE_BYTES
+        struct PendingDispatch
+        {
+            std::string orderKey;
+            std::function<void()> work;
+            size_t bytes;
+        };
+        static constexpr size_t BACKLOG_PAUSE_BYTES = 8 * 1024 * 1024;
+        static constexpr size_t BACKLOG_RESUME_BYTES = 2 * 1024 * 1024;
+        std::deque<PendingDispatch> _backlog;
+        size_t _backlogBytes = 0;
+        bool _receivePaused = false;
+        uint64_t _receivePauses = 0;
+        std::atomic<bool> _backlogDrainPosted{ false };
+
+        // Outbound messages, written by the queue's own thread (started per connection)
+        SendQueue _sendQueue;
+
+        // Handshake / liveness requests are built here (receive thread only)
+        WwksMessageBuilder _requestBuilder;
+
+        // KeepAliveResponse fast path (template owned by the receive thread)
+        KeepAliveReply _keepAliveReply;
+        LatencyHistogram _keepAliveTurnaround;
+
+        // Requests waiting for their response; expired by a reactor timer while any are pending
+        RequestTracker _requests;
+        // Ids of the client's own requests count up from here, above the HHmmssfff range of
+        // UIHelpers::MakeUniqueId, so they never collide with the application's OutputRequests
+        std::atomic<uint64_t> _lastRequestId{ 1000000000 };
+        std::mutex _activeReactorMtx;
+        Reactor* _activeReactor = nullptr;          // Reactor of the running receive thread (for Post)
+        std::atomic<bool> _requestTimerArmed{ false };
+
+        // Robot TimeStamp of each received frame against our clock (written by the receive thread)
+        mutable std::mutex _robotClockMtx;
+        RobotClockStats _robotClock;
+
+        // Traffic capture (SetCapture); _capturing lets the receive path skip the lock when off
+        std::mutex _captureMtx;
+        std::shared_ptr<TrafficCaptureWriter> _capture;
+        std::atomic<bool> _capturing{ false };
+
         // Private methods
         void CloseLocked();
+        void Disconnect();
+        bool StartTransport(std::unique_ptr<Transport> transport, const std::string& description);
+        ClientIdentity GetIdentity() const;
         void NotifyStateChange(ConnectionState newState, ConnectionError error, const std::string& description);
-        static std::string RemoveIllegalCharacters(const std::string& input);
-        static std::string GetMessageResponseType(const std::string& wwksMessage);
-        static ConnectionError GetErrorType(int wsaError);
+        static std::string RemoveIllegalCharacters(std::string_view input);
+        static ConnectionError GetErrorType(int socketError);
+        std::string NextRequestId();
         void SendHelloRequest();
-        void SendStatusRequest();
+        void SendStatusRequest(const char* logTag = "[HANDSHAKE]");
         void SendStockInfoRequest();
         void ReceiveLoop();
+        WwksMessageType HandleFrame(std::string_view frame, Handshake& handshake, Reactor::Clock::time_point received);
+        void ArmRequestTimer(Reactor& reactor);
+        void Dispatch(std::string_view orderKey, std::function<void()> work, size_t bytes);
+        void DrainBacklog();
+        void Capture(TrafficDirection direction, std::string_view frame, Reactor::Clock::time_point when);
+        void SampleRobotClock(std::string_view frame, std::chrono::system_clock::time_point received);
         void PollingLoop();  // Automatic reconnection polling thread
 
         // non-copyable
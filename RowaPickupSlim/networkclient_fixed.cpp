@@ -1,33 +1,69 @@
 // networkclient.cpp
 // Implementation of NetworkClient declared in networkclient.h
-// Minimal Winsock-based TCP client that mirrors the C# NetworkClient behavior.
+// TCP client that mirrors the C# NetworkClient behavior. The byte stream is a Transport
+// (TcpTransport in the application), so the protocol logic also runs over a LoopbackTransport.
 
-#define _WINSOCK_DEPRECATED_NO_WARNINGS
+#ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
-#pragma comment(lib, "ws2_32.lib")
+#else
+#include <cerrno>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#endif
 
 #include "networkclient.h"
+#include "TcpTransport.h"
+#include "WwksFrameSplitter.h"
 #include <iostream>
 #include <chrono>
-#include <sstream>
-#include "pugixml.hpp"
+#include <ctime>
 
 namespace RowaPickupSlim
 {
+    // Fixed parts of the HelloRequest
+    static constexpr std::string_view SUBSCRIBER_ATTRIBUTES =
+        " Type=\"IMS\" Manufacturer=\"Becton Dickenson Netherlands\" ProductInfo=\"RowaPickupSlim\" VersionInfo=\"1.0\"";
+    static constexpr std::string_view SUBSCRIBER_CAPABILITIES =
+        "<Capability Name=\"KeepAlive\" /><Capability Name=\"Status\" />"
+        "<Capability Name=\"StockInfo\" /><Capability Name=\"Output\" />"
+        "<Capability Name=\"TaskInfo\" />";
+
     // Constructor
-    NetworkClient::NetworkClient()
-        : _sock(INVALID_SOCKET), _running(false), _currentState(ConnectionState::NotConnected), 
+    NetworkClient::NetworkClient(size_t dispatchLanes, size_t dispatchQueueCapacity)
+        : _running(false), _currentState(ConnectionState::NotConnected), 
           _lastError(ConnectionError::None), _networkState(NetworkConnectionState::Disconnected_ReadyToConnect),
-          _handshakeComplete(false), _helloResponseReceived(false), _statusResponseReceived(false),
-          _pollingActive(false), _pollPort(0)
+          _handshakeComplete(false),
+          _pollingActive(false), _pollPort(0), _dispatcher(dispatchLanes, dispatchQueueCapacity)
     {
+        for (size_t i = 0; i < _dispatcher.GetLaneCount(); i++)
+            _parsers.push_back(std::make_unique<WwksMessageParser>());
+
+        // Runs on a dispatch lane: retry the backlog on the receive thread
+        _dispatcher.SpaceAvailable = [this]() {
+            if (_backlogDrainPosted.exchange(true)) return;
+            std::lock_guard<std::mutex> lk(_activeReactorMtx);
+            if (_activeReactor)
+                _activeReactor->Post([this]() { DrainBacklog(); });
+            else
+                _backlogDrainPosted.store(false);
+        };
+
+        // Runs on the writer thread; the receive thread notices the broken connection itself
+        _sendQueue.WriteFailed = [this](int error) {
+            if (LogMessage)
+            {
+                LogMessage("Send failed: error " + std::to_string(error));
+            }
+        };
     }
 
     // Destructor
     NetworkClient::~NetworkClient()
     {
         Close();
+        // Run any still queued messages while the callbacks are alive
+        _dispatcher.Stop();
     }
 
     // Connect to server
@@ -36,166 +72,213 @@ namespace RowaPickupSlim
         if (!IsValidIpAddress(serverIp) || !IsValidPort(port))
             return false;
 
+        // One Connect() at a time; _mtx is only taken for short updates, so senders are never blocked
+        std::lock_guard<std::mutex> connectLock(_connectMtx);
+        _connectAbort.store(false);
+
         NotifyStateChange(ConnectionState::Attempting, ConnectionError::None, "Connecting to " + serverIp + ":" + std::to_string(port));
 
-        WSADATA wsaData;
-        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+        if (!TcpTransport::Startup())
         {
             NotifyStateChange(ConnectionState::Failed, ConnectionError::Other, "WSAStartup failed");
             return false;
         }
 
-        // Close existing connection first (outside mutex lock to avoid deadlock with ReceiveLoop)
+        Disconnect();
+
+        TcpConnector::Options connectOptions;
+        std::chrono::milliseconds keepAliveIdle, keepAliveInterval;
         {
             std::lock_guard<std::mutex> lk(_mtx);
-            if (_sock != INVALID_SOCKET)
-            {
-                // Mark as not running to stop ReceiveLoop
-                _running.store(false);
-                
-                // Close the socket
-                DWORD noTimeout = 0;
-                setsockopt(_sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&noTimeout, sizeof(noTimeout));
-                ::shutdown(_sock, SD_BOTH);
-                closesocket(_sock);
-                _sock = INVALID_SOCKET;
-            }
-        } // Release mutex here before joining thread
-        
-        // Join the receive thread OUTSIDE the mutex to avoid deadlock
-        if (_recvThread.joinable())
-        {
-            _recvThread.join();
+            connectOptions = _connectOptions;
+            keepAliveIdle = _tcpKeepAliveIdle;
+            keepAliveInterval = _tcpKeepAliveInterval;
         }
+        connectOptions.cancelled = [this]() { return _connectAbort.load(); };
 
-        std::lock_guard<std::mutex> lk(_mtx);
-
-        addrinfo hints{};
-        hints.ai_family = AF_UNSPEC;
-        hints.ai_socktype = SOCK_STREAM;
-        hints.ai_protocol = IPPROTO_TCP;
+        // Races all addresses of the server without holding _mtx
+        TcpConnector::Result connected = TcpConnector::Connect(serverIp, port, connectOptions);
+        auto elapsedMs = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(connected.elapsed).count());
 
-        addrinfo* result = nullptr;
-        std::string portStr = std::to_string(port);
-        if (getaddrinfo(serverIp.c_str(), portStr.c_str(), &hints, &result) != 0)
+        if (!connected.resolved)
         {
-            WSACleanup();
+            TcpTransport::Cleanup();
             NotifyStateChange(ConnectionState::Failed, ConnectionError::HostUnreachable, "Unable to resolve host: " + serverIp);
             return false;
         }
 
-        SOCKET s = INVALID_SOCKET;
-        for (addrinfo* ptr = result; ptr != nullptr; ptr = ptr->ai_next)
+        if (!connected.Connected())
         {
-            s = socket(ptr->ai_family, ptr->ai_socktype, ptr->ai_protocol);
-            if (s == INVALID_SOCKET) continue;
+            TcpTransport::Cleanup();
+            ConnectionError error = connected.timedOut ? ConnectionError::Timeout
+                                  : connected.error != 0 ? GetErrorType(connected.error)
+                                  : ConnectionError::ConnectionRefused;
+            std::string reason = connected.cancelled ? "cancelled"
+                               : connected.timedOut ? "timed out"
+                               : "failed (error " + std::to_string(connected.error) + ")";
+            NotifyStateChange(ConnectionState::Failed, error, "Connection to " + serverIp + ":" + std::to_string(port) + " " + reason +
+                              " after " + elapsedMs + " ms, " + std::to_string(connected.attempts) + " of " +
+                              std::to_string(connected.candidates) + " addresses tried");
+            return false;
+        }
 
-            if (connect(s, ptr->ai_addr, (int)ptr->ai_addrlen) == 0)
-            {
-                _sock = s;
-                break;
-            }
-            
-            int wsaError = WSAGetLastError();
-            ConnectionError error = GetErrorType(wsaError);
-            closesocket(s);
-            s = INVALID_SOCKET;
+        if (LogMessage)
+        {
+            LogMessage(std::string("[CONNECT] ") + connected.address + (connected.family == AF_INET6 ? " (IPv6)" : " (IPv4)") +
+                       " won in " + elapsedMs + " ms, attempt " + std::to_string(connected.attempts) + " of " +
+                       std::to_string(connected.candidates) + " addresses");
         }
-        freeaddrinfo(result);
 
-        if (_sock == INVALID_SOCKET)
+        auto transport = std::make_unique<TcpTransport>(connected.socket, connected.address);
+
+        // Enable TCP keepalive to detect dead connections. The default starts probing after 2 hours;
+        // the OS then also notices a dead peer while we send
+        int keepAliveError = 0;
+        if (!transport->SetKeepAlive(keepAliveIdle, keepAliveInterval, keepAliveError))
         {
-            WSACleanup();
-            NotifyStateChange(ConnectionState::Failed, ConnectionError::ConnectionRefused, "Connection refused by server at " + serverIp);
+            transport.reset();
+            TcpTransport::Cleanup();
+            NotifyStateChange(ConnectionState::Failed, ConnectionError::Other,
+                              "Failed to enable TCP keepalive: socket error " + std::to_string(keepAliveError));
             return false;
         }
 
-        // Set socket receive timeout to 10 seconds so we can detect disconnections
-        DWORD recvTimeout = 10000;  // 10 seconds in milliseconds
-        if (setsockopt(_sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&recvTimeout, sizeof(recvTimeout)) == SOCKET_ERROR)
+        int noDelayError = 0;
+        if (!transport->SetNoDelay(true, noDelayError) && LogMessage)
         {
-            closesocket(_sock);
-            _sock = INVALID_SOCKET;
-            WSACleanup();
-            NotifyStateChange(ConnectionState::Failed, ConnectionError::Other, "Failed to set socket timeout");
-            return false;
+            LogMessage("Failed to disable Nagle: socket error " + std::to_string(noDelayError));
         }
 
-        // Enable TCP keepalive to detect dead connections
-        BOOL keepAlive = TRUE;
-        if (setsockopt(_sock, SOL_SOCKET, SO_KEEPALIVE, (const char*)&keepAlive, sizeof(keepAlive)) == SOCKET_ERROR)
+        return StartTransport(std::move(transport), "Connected to " + connected.address + " in " + elapsedMs + " ms");
+    }
+
+    // Connect over a transport that is already connected
+    bool NetworkClient::Connect(std::unique_ptr<Transport> transport)
+    {
+        if (!transport)
+            return false;
+
+        std::lock_guard<std::mutex> connectLock(_connectMtx);
+        _connectAbort.store(false);
+
+        std::string description = transport->Describe();
+        NotifyStateChange(ConnectionState::Attempting, ConnectionError::None, "Connecting to " + description);
+
+        // The reactor's wakeup sockets need Winsock as well
+        if (!TcpTransport::Startup())
         {
-            closesocket(_sock);
-            _sock = INVALID_SOCKET;
-            WSACleanup();
-            NotifyStateChange(ConnectionState::Failed, ConnectionError::Other, "Failed to enable TCP keepalive");
+            NotifyStateChange(ConnectionState::Failed, ConnectionError::Other, "WSAStartup failed");
             return false;
         }
 
-        // Start receive thread
-        _running.store(true);
-        _handshakeComplete = false;
-        _helloResponseReceived.store(false);
-        _statusResponseReceived.store(false);
-        _recvThread = std::thread(&NetworkClient::ReceiveLoop, this);
+        Disconnect();
+        return StartTransport(std::move(transport), "Connected to " + description);
+    }
+
+    // Private: Stop the current connection and wait for its receive thread (_connectMtx held)
+    void NetworkClient::Disconnect()
+    {
+        // The receive thread releases the transport on exit
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            CloseLocked();
+        } // Release mutex here before joining thread
+
+        // Join the receive thread OUTSIDE the mutex to avoid deadlock
+        if (_recvThread.joinable())
+        {
+            _recvThread.join();
+        }
+
+        std::lock_guard<std::mutex> lk(_mtx);
+        _reactor.reset();
+    }
+
+    // Private: Start the writer and receive threads on a connected transport (_connectMtx held)
+    bool NetworkClient::StartTransport(std::unique_ptr<Transport> transport, const std::string& description)
+    {
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+
+            // Close() was called while connecting
+            if (_connectAbort.load())
+            {
+                transport.reset();
+                TcpTransport::Cleanup();
+                NotifyStateChange(ConnectionState::Failed, ConnectionError::Other, "Connect cancelled");
+                return false;
+            }
+
+            // The receive thread sleeps in the reactor until data arrives, a timer is due or Close() wakes it
+            _reactor = std::make_unique<Reactor>();
+            if (!_reactor->IsValid())
+            {
+                _reactor.reset();
+                transport.reset();
+                TcpTransport::Cleanup();
+                NotifyStateChange(ConnectionState::Failed, ConnectionError::Other, "Failed to create socket reactor");
+                return false;
+            }
+            _transport = std::move(transport);
+
+            // Start writer and receive threads
+            _sendQueue.Start(*_transport);
+            _running.store(true);
+            _handshakeComplete.store(false);
+            _recvThread = std::thread(&NetworkClient::ReceiveLoop, this);
+        }
 
         // Set network state to Connected_StayAlive (state 1)
         SetNetworkState(NetworkConnectionState::Connected_StayAlive);
 
         // Notify connection established
-        NotifyStateChange(ConnectionState::Connected, ConnectionError::None, "Connected successfully");
-        
-        // Send handshake sequence from main thread (not from ReceiveLoop to avoid deadlock)
-        std::thread([this]() {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            if (_running.load()) SendHelloRequest();
-            
-            std::this_thread::sleep_for(std::chrono::milliseconds(600));
-            if (_running.load() && _helloResponseReceived.load()) SendStatusRequest();
-            
-            std::this_thread::sleep_for(std::chrono::milliseconds(600));
-            if (_running.load() && _statusResponseReceived.load()) SendStockInfoRequest();
-        }).detach();
+        NotifyStateChange(ConnectionState::Connected, ConnectionError::None, description);
 
+        // The handshake is started by the receive thread, which also receives its responses
         return true;
     }
 
     // Send message
-    bool NetworkClient::SendMessage(const std::string& message)
+    bool NetworkClient::SendMessage(std::string_view message)
     {
-        std::lock_guard<std::mutex> lk(_mtx);
-        if (_sock == INVALID_SOCKET) return false;
+        std::future<bool> done = SendMessageAsync(message);
 
-        // Log outgoing message
+        // A message that was not queued completes at once with false
+        if (done.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return true;
+        return done.get();
+    }
+
+    // Send message, completion reported through the future
+    std::future<bool> NetworkClient::SendMessageAsync(std::string_view message)
+    {
+        // The log call only queues one record
         if (LogMessage)
         {
-            LogMessage("\n>>> OUTGOING MESSAGE <<<");
-            LogMessage(message);
-            LogMessage(">>> END OUTGOING <<<\n");
+            LogMessage(std::string("\n>>> OUTGOING MESSAGE <<<\n").append(message).append("\n>>> END OUTGOING <<<\n"));
         }
 
         std::string filtered = RemoveIllegalCharacters(message);
-        if (filtered.empty()) return false;
+        if (filtered.empty())
+        {
+            std::promise<bool> rejected;
+            rejected.set_value(false);
+            return rejected.get_future();
+        }
 
+        Capture(TrafficDirection::Outbound, filtered, Reactor::Clock::now());
         filtered.push_back('\n');
 
-        int total = 0;
-        int toSend = static_cast<int>(filtered.size());
-        const char* buf = filtered.c_str();
-
-        while (total < toSend)
-        {
-            int sent = ::send(_sock, buf + total, toSend - total, 0);
-            if (sent == SOCKET_ERROR)
-                return false;
-            total += sent;
-        }
-        return true;
+        // Not connected: the queue is stopped and completes the message with false
+        return _sendQueue.Enqueue(std::move(filtered));
     }
 
     // Close connection
     void NetworkClient::Close()
     {
+        // Abandon a connect in progress
+        _connectAbort.store(true);
+
         // Stop polling first (must be before locking to avoid deadlock)
         StopConnectionPolling();
         
@@ -209,31 +292,38 @@ namespace RowaPickupSlim
         {
             _recvThread.join();
         }
+
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            _reactor.reset();       // Closes its wakeup socket before Winsock is released
+        }
         
-        WSACleanup();
+        TcpTransport::Cleanup();
     }
 
     // Private: Close locked - must be called with mutex held
     void NetworkClient::CloseLocked()
     {
         _running.store(false);
-        if (_sock != INVALID_SOCKET)
+
+        // Wake the receive thread; it leaves the reactor at once and releases the transport itself
+        if (_reactor)
         {
-            // Disable recv timeout before closing so socket operations complete quickly
-            DWORD noTimeout = 0;
-            setsockopt(_sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&noTimeout, sizeof(noTimeout));
-            
-            ::shutdown(_sock, SD_BOTH);
-            closesocket(_sock);
-            _sock = INVALID_SOCKET;
+            _reactor->Stop();
+        }
+        else
+        {
+            _transport.reset();
         }
         // Note: Don't join thread here - it will be done in Close() after releasing mutex
     }
+
+    // Validate IPv4 / IPv6 address
     bool NetworkClient::IsValidIpAddress(const std::string& ipAddress)
     {
-        sockaddr_in sa{};
-        return inet_pton(AF_INET, ipAddress.c_str(), &(sa.sin_addr)) == 1
-            || inet_pton(AF_INET6, ipAddress.c_str(), &(sa.sin_addr)) == 1;
+        in6_addr address{};     // Large enough for either family
+        return inet_pton(AF_INET, ipAddress.c_str(), &address) == 1
+            || inet_pton(AF_INET6, ipAddress.c_str(), &address) == 1;
     }
 
     // Validate port
@@ -243,10 +333,11 @@ namespace RowaPickupSlim
     }
 
     // Private: Remove illegal XML characters
-    std::string NetworkClient::RemoveIllegalCharacters(const std::string& input)
+    std::string NetworkClient::RemoveIllegalCharacters(std::string_view input)
     {
+        // Room for the line terminator the caller appends
         std::string out;
-        out.reserve(input.size());
+        out.reserve(input.size() + 1);
         for (unsigned char c : input)
         {
             if (c == 0x09 || c == 0x0A || c == 0x0D || c >= 0x20)
@@ -255,225 +346,372 @@ namespace RowaPickupSlim
         return out;
     }
 
-    // Private: Get message type from XML
-    std::string NetworkClient::GetMessageResponseType(const std::string& wwksMessage)
+    // Get dispatch queue counters
+    MessageDispatcher::Counters NetworkClient::GetDispatchCounters() const
     {
-        pugi::xml_document doc;
-        pugi::xml_parse_result res = doc.load_string(wwksMessage.c_str());
-        if (!res) return std::string();
+        return _dispatcher.GetCounters();
+    }
 
-        pugi::xml_node root = doc.child("WWKS");
-        if (!root) return std::string();
+    // Get send queue counters
+    SendQueue::Counters NetworkClient::GetSendCounters() const
+    {
+        return _sendQueue.GetCounters();
+    }
 
-        if (root.child("HelloResponse")) return "HelloResponse";
-        if (root.child("StatusResponse")) return "StatusResponse";
-        if (root.child("StockInfoResponse")) return "StockInfoResponse";
-        if (root.child("OutputResponse")) return "OutputResponse";
-        if (root.child("OutputMessage")) return "OutputMessage";
-        if (root.child("InputMessage")) return "InputMessage";
-        if (root.child("TaskInfoResponse")) return "TaskInfoResponse";
+    // Get KeepAliveRequest -> KeepAliveResponse written latency
+    LatencyHistogram::Summary NetworkClient::GetKeepAliveTurnaround() const
+    {
+        return _keepAliveTurnaround.GetSummary();
+    }
 
-        return std::string();
+    // Get request latency counters
+    RequestTracker::Stats NetworkClient::GetRequestStats(WwksMessageType requestType) const
+    {
+        return _requests.GetStats(requestType);
     }
 
-    // Private: Receive loop
-    void NetworkClient::ReceiveLoop()
+    // Set response timeout of a request type
+    void NetworkClient::SetRequestTimeout(WwksMessageType requestType, std::chrono::milliseconds timeout)
     {
-        constexpr size_t BUFFER_SIZE = 8192;
-        std::vector<char> buffer(BUFFER_SIZE);
-        std::string messageBuilder;
-        const std::string endTag = "</WWKS>";
-        int consecutiveTimeouts = 0;
-        const int MAX_CONSECUTIVE_TIMEOUTS = 12; // 2 minutes of no data = disconnect
+        _requests.SetTimeout(requestType, timeout);
+    }
 
-        while (_running.load())
-        {
-            int bytesRead = ::recv(_sock, buffer.data(), static_cast<int>(buffer.size()), 0);
-            
-            // Handle timeout (WSAETIMEDOUT) - connection is still alive, just no data
-            if (bytesRead == SOCKET_ERROR)
-            {
-                int error = WSAGetLastError();
-                if (error == WSAETIMEDOUT)
+    // Send a tracked request
+    std::future<RequestTracker::Result> NetworkClient::SendRequest(std::string_view message, WwksMessageType requestType,
+        const std::string& id, RequestTracker::Callback callback)
+    {
+        // Tracked before sending, so even an immediate response finds its entry
+        std::future<RequestTracker::Result> result = _requests.Track(id, requestType,
+            [this, callback = std::move(callback)](const RequestTracker::Result& r) {
+                if (r.outcome != RequestOutcome::Answered)
                 {
-                    // Increment timeout counter
-                    consecutiveTimeouts++;
-                    
-                    // If we have too many consecutive timeouts, consider connection dead
-                    if (consecutiveTimeouts >= MAX_CONSECUTIVE_TIMEOUTS)
+                    if (LogMessage)
                     {
-                        if (LogMessage)
-                        {
-                            LogMessage("Connection lost: No data received for " + 
-                                     std::to_string(MAX_CONSECUTIVE_TIMEOUTS * 10) + " seconds");
-                        }
-                        _running.store(false);
-                        break;
+                        LogMessage(std::string("[REQUEST] ") + ToString(r.requestType) + " Id=" + r.id + " failed: " +
+                                   ToString(r.outcome) + " after " +
+                                   std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(r.latency).count()) + " ms");
+                    }
+                    if (RequestFailed)
+                    {
+                        try { RequestFailed(r); } catch (...) {}
                     }
-                    
-                    // Normal timeout - connection is still alive
-                    continue;
                 }
-                // Actual error - connection is broken
-                if (LogMessage)
+                if (callback) callback(r);
+            });
+
+        if (!SendMessage(message))
+        {
+            _requests.Cancel(id, RequestOutcome::NotSent);
+            return result;
+        }
+
+        // Start the expiry timer on the receive thread unless it already runs
+        if (!_requestTimerArmed.load())
+        {
+            std::lock_guard<std::mutex> lk(_activeReactorMtx);
+            if (_activeReactor)
+            {
+                Reactor* reactor = _activeReactor;
+                reactor->Post([this, reactor]() { ArmRequestTimer(*reactor); });
+            }
+        }
+        return result;
+    }
+
+    // Private: Expire requests every wheel tick while any are pending (runs on the receive thread)
+    void NetworkClient::ArmRequestTimer(Reactor& reactor)
+    {
+        if (_requestTimerArmed.load() || _requests.PendingCount() == 0) return;
+
+        _requestTimerArmed.store(true);
+        reactor.AddTimer(_requests.GetTick(), [this, &reactor]() {
+            _requestTimerArmed.store(false);
+            _requests.Expire();
+            ArmRequestTimer(reactor);
+        });
+    }
+
+    // Private: Receive loop
+    void NetworkClient::ReceiveLoop()
+    {
+        WwksFrameSplitter splitter;
+
+        // Connect() sets both before starting this thread and only replaces them after joining it
+        Reactor& reactor = *_reactor;
+        Transport& transport = *_transport;
+
+        auto stop = [&]() {
+            _running.store(false);
+            reactor.Stop();
+        };
+
+        // Hello -> Status -> StockInfo, each request sent as soon as the previous response arrives
+        Handshake::Options handshakeOptions;
+        LivenessMonitor::Options livenessOptions;
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            livenessOptions = _livenessOptions;
+            handshakeOptions = _handshakeOptions;
+        }
+        auto ms = [](Reactor::Clock::duration d) {
+            return std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(d).count());
+        };
+
+        // Dead-peer detection, fed by the read handler. One timer, due at the monitor's next check;
+        // moved earlier when a learned KeepAlive interval shortens the deadline
+        LivenessMonitor liveness(livenessOptions);
+        Reactor::TimerId livenessTimer = 0;
+        Reactor::Clock::time_point livenessDue;
+        std::function<void()> checkLiveness;
+        auto armLiveness = [&]() {
+            auto due = liveness.NextCheck();
+            if (livenessTimer != 0 && due >= livenessDue) return;
+            if (livenessTimer != 0) reactor.CancelTimer(livenessTimer);
+            livenessDue = due;
+            livenessTimer = reactor.AddTimer(due - Reactor::Clock::now(), checkLiveness);
+        };
+
+        Handshake handshake(reactor, handshakeOptions);
+        handshake.SendRequest = [this](Handshake::Step step) {
+            switch (step)
+            {
+            case Handshake::Step::Hello: SendHelloRequest(); break;
+            case Handshake::Step::Status: SendStatusRequest(); break;
+            case Handshake::Step::StockInfo: SendStockInfoRequest(); break;
+            }
+        };
+        handshake.Retrying = [this, maxAttempts = handshakeOptions.maxAttempts](Handshake::Step step, int attempt) {
+            if (LogMessage)
+            {
+                LogMessage(std::string("[HANDSHAKE] No ") + Handshake::StepName(step) + "Response, sending again (attempt " +
+                           std::to_string(attempt) + "/" + std::to_string(maxAttempts) + ")");
+            }
+        };
+        // A robot that never completes the handshake is not usable: drop the connection and report
+        // it as failed, so polling reconnects with backoff
+        std::string handshakeFailure;
+        handshake.Finished = [this, &handshake, &ms, &stop, &handshakeFailure](bool ok, Handshake::Step failedStep) {
+            if (ok)
+            {
+                _handshakeComplete.store(true);
+                _reconnect.OnEstablished(std::chrono::steady_clock::now());
+            }
+            else
+            {
+                handshakeFailure = std::string("Handshake failed: no ") + Handshake::StepName(failedStep) + "Response after " +
+                                   std::to_string(handshake.GetResult(failedStep).attempts) + " attempts";
+            }
+            if (LogMessage)
+            {
+                std::string steps;
+                for (Handshake::Step step : { Handshake::Step::Hello, Handshake::Step::Status, Handshake::Step::StockInfo })
                 {
-                    std::string errorDesc = "Socket error: " + std::to_string(error);
-                    LogMessage(errorDesc);
+                    const Handshake::StepResult& r = handshake.GetResult(step);
+                    steps += std::string(" ") + Handshake::StepName(step) + "=" + ms(r.duration) + "ms/" + std::to_string(r.attempts);
                 }
-                _running.store(false);
-                break;
+                if (ok)
+                    LogMessage("[HANDSHAKE] Complete in " + ms(handshake.GetTotalDuration()) + " ms (step=ms/attempts:" + steps + ")");
+                else
+                    LogMessage(std::string("[HANDSHAKE] Failed: no ") + Handshake::StepName(failedStep) + "Response (step=ms/attempts:" + steps + ")");
             }
-            
-            // Reset timeout counter on successful receive
-            if (bytesRead > 0)
+            if (!ok)
             {
-                consecutiveTimeouts = 0;
+                stop();
             }
-            
-            if (bytesRead == 0)
+        };
+
+        // The transport receives straight into the splitter's buffer to avoid an extra copy per chunk
+        Transport::Receiver receiver;
+        receiver.Prepare = [&](size_t size) { return splitter.PrepareWrite(size); };
+        receiver.Closed = [&](int error) {
+            if (LogMessage)
+            {
+                if (error == 0)
+                    LogMessage("Connection closed by server (recv returned 0)");    // Closed gracefully
+                else
+                    LogMessage("Socket error: " + std::to_string(error));          // Connection is broken
+            }
+            stop();
+        };
+        receiver.Commit = [&](size_t bytes) {
+            auto now = std::chrono::steady_clock::now();
+            liveness.OnReceive(now, false);
+            splitter.Commit(bytes);
+
+            std::string_view frame;
+            while (splitter.NextFrame(frame) && _running.load())
+            {
+                if (HandleFrame(frame, handshake, now) == WwksMessageType::KeepAliveRequest)
+                {
+                    liveness.OnReceive(now, true);
+                    armLiveness();
+                }
+            }
+
+            // The handlers fell too far behind: stop reading until DrainBacklog() has caught up
+            if (_backlogBytes > BACKLOG_PAUSE_BYTES && !_receivePaused)
             {
-                // Connection closed gracefully by server
+                _receivePaused = true;
+                _receivePauses++;
+                transport.PauseReceive(true);
                 if (LogMessage)
                 {
-                    LogMessage("Connection closed by server (recv returned 0)");
+                    LogMessage("[DISPATCH] Handlers are " + std::to_string(_backlog.size()) + " messages behind, pausing receive");
                 }
-                _running.store(false);
-                break;
             }
+        };
 
-            messageBuilder.append(buffer.data(), buffer.data() + bytesRead);
+        // Dead connection detection: runs only at the next probe / dead deadline
+        checkLiveness = [&]() {
+            livenessTimer = 0;
+            auto now = std::chrono::steady_clock::now();
 
-            size_t pos = messageBuilder.find(endTag);
-            while (pos != std::string::npos)
-            {
-                size_t msgEnd = pos + endTag.length();
-                std::string completeMessage = messageBuilder.substr(0, msgEnd);
+            // While we do not read, the silence is ours and says nothing about the peer
+            if (_receivePaused)
+                liveness.OnReceive(now, false);
 
-                // Log incoming message
+            switch (liveness.Check(now))
+            {
+            case LivenessMonitor::Verdict::Dead:
                 if (LogMessage)
                 {
-                    LogMessage("\n<<< INCOMING MESSAGE <<<");
-                    LogMessage(completeMessage);
-                    LogMessage("<<< END INCOMING <<<\n");
+                    LogMessage("Connection lost: No data received for " + ms(liveness.DeadAfter()) + " ms (" +
+                               std::to_string(livenessOptions.missedIntervals) + " KeepAlive intervals of " + ms(liveness.Interval()) + " ms)");
                 }
-
-                // Check if this is a KeepAliveRequest and automatically respond
-                if (completeMessage.find("<KeepAliveRequest") != std::string::npos)
+                stop();
+                return;
+            case LivenessMonitor::Verdict::Probe:
+                if (LogMessage)
                 {
-                    // Extract the Id, Source, and Destination attributes
-                    size_t idPos = completeMessage.find("Id=\"");
-                    size_t sourcePos = completeMessage.find("Source=\"");
-                    size_t destPos = completeMessage.find("Destination=\"");
-                    
-                    if (idPos != std::string::npos && sourcePos != std::string::npos && destPos != std::string::npos)
-                    {
-                        // Extract Id
-                        idPos += 4;  // Move past 'Id="'
-                        size_t idEnd = completeMessage.find("\"", idPos);
-                        std::string keepaliveId = completeMessage.substr(idPos, idEnd - idPos);
-                        
-                        // Extract Source (server ID)
-                        sourcePos += 8;  // Move past 'Source="'
-                        size_t sourceEnd = completeMessage.find("\"", sourcePos);
-                        std::string serverId = completeMessage.substr(sourcePos, sourceEnd - sourcePos);
-                        
-                        // Extract Destination (our client ID)
-                        destPos += 13;  // Move past 'Destination="'
-                        size_t destEnd = completeMessage.find("\"", destPos);
-                        std::string clientId = completeMessage.substr(destPos, destEnd - destPos);
-                        
-                        // Build and send KeepAliveResponse
-                        // Swap Source and Destination: we become the Source, server becomes Destination
-                        std::ostringstream ss;
-                        ss << "<WWKS Version=\"2.0\" TimeStamp=\"";
-                        auto now = std::chrono::system_clock::now();
-                        std::time_t t = std::chrono::system_clock::to_time_t(now);
-                        std::tm tm{};
-                        gmtime_s(&tm, &t);
-                        char buf[64];
-                        strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
-                        ss << buf << "\">";
-                        ss << "<KeepAliveResponse Id=\"" << keepaliveId << "\" Source=\"" << clientId << "\" Destination=\"" << serverId << "\" />";
-                        ss << "</WWKS>";
-                        
-                        if (LogMessage)
-                        {
-                            LogMessage("[KEEPALIVE] Received KeepAliveRequest from server, sending KeepAliveResponse");
-                        }
-                        
-                        SendMessage(ss.str());
-                    }
+                    LogMessage("[LIVENESS] KeepAliveRequest overdue (interval " + ms(liveness.Interval()) + " ms), probing");
                 }
+                SendStatusRequest("[LIVENESS]");
+                break;
+            case LivenessMonitor::Verdict::Alive:
+                break;
+            }
+            armLiveness();
+        };
+        liveness.Reset(std::chrono::steady_clock::now());
+        armLiveness();
 
-                // Dispatch message to message handler
-                std::thread dispatchThread([completeMessage, this]() {
-                    std::string messageType = GetMessageResponseType(completeMessage);
-                    
-                    // Handle handshake sequence by setting flags
-                    // (actual sending will be done in main receive loop to avoid deadlock)
-                    if (messageType == "HelloResponse" && !_helloResponseReceived.load())
-                    {
-                        if (LogMessage)
-                        {
-                            LogMessage("[HANDSHAKE] Received HelloResponse");
-                        }
-                        _helloResponseReceived.store(true);
-                    }
-                    else if (messageType == "StatusResponse" && !_statusResponseReceived.load())
-                    {
-                        if (LogMessage)
-                        {
-                            LogMessage("[HANDSHAKE] Received StatusResponse");
-                        }
-                        _statusResponseReceived.store(true);
-                    }
-                    else if (messageType == "StockInfoResponse" && !_handshakeComplete)
-                    {
-                        if (LogMessage)
-                        {
-                            LogMessage("[HANDSHAKE] Received StockInfoResponse, handshake complete!");
-                        }
-                        _handshakeComplete = true;
-                    }
-                    
-                    // Don't dispatch KeepAliveRequest or internal handshake responses during setup
-                    if (messageType != "KeepAliveRequest" && this->MessageReceived)
-                    {
-                        try
-                        {
-                            this->MessageReceived(messageType, completeMessage);
-                        }
-                        catch (...)
-                        {
-                            // swallow exceptions
-                        }
-                    }
-                });
+        if (!transport.Start(reactor, std::move(receiver)))
+        {
+            if (LogMessage)
+            {
+                LogMessage("Failed to start receiving from " + transport.Describe());
+            }
+            stop();
+        }
 
+        {
+            std::lock_guard<std::mutex> lk(_activeReactorMtx);
+            _activeReactor = &reactor;
+        }
 
+        // Close() may already have stopped the reactor, then this returns immediately
+        if (_running.load())
+        {
+            handshake.Start();
+            ArmRequestTimer(reactor);
+            reactor.Run();
+        }
+        transport.Stop();
 
+        {
+            std::lock_guard<std::mutex> lk(_activeReactorMtx);
+            _activeReactor = nullptr;
+        }
+        _requestTimerArmed.store(false);
 
-                dispatchThread.detach();
+        // Nothing pending can be answered any more: report every open request as failed
+        _requests.CancelAll(RequestOutcome::Disconnected);
 
-                messageBuilder.erase(0, msgEnd);
-                pos = messageBuilder.find(endTag);
+        if (LogMessage)
+        {
+            LivenessMonitor::Metrics lm = liveness.GetMetrics();
+            LogMessage("[LIVENESS] keepAlives=" + std::to_string(lm.keepAlives) + " intervalMs=" + ms(lm.interval) +
+                       (lm.learned ? "" : " (not learned)") + " probes=" + std::to_string(lm.probes) +
+                       " longestSilenceMs=" + ms(lm.longestSilence));
+
+            Reactor::Counters rc = reactor.GetCounters();
+            LogMessage("[REACTOR] waits=" + std::to_string(rc.waits) + " idleWakeups=" + std::to_string(rc.idleWakeups) +
+                       " ioEvents=" + std::to_string(rc.ioEvents) + " timers=" + std::to_string(rc.timersFired));
+        }
+
+        // Stop the writer before the transport is released; Shutdown() releases it if it is
+        // blocked in a write to a peer that stopped reading
+        transport.Shutdown();
+        _sendQueue.Stop();
+
+        if (LogMessage)
+        {
+            SendQueue::Counters sc = _sendQueue.GetCounters();
+            LatencyHistogram::Summary ka = _keepAliveTurnaround.GetSummary();
+            auto us = [](LatencyHistogram::Duration d) {
+                return std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+            };
+            LogMessage("[KEEPALIVE] answered=" + std::to_string(ka.count) + " p50Us=" + us(ka.p50) + " p99Us=" + us(ka.p99) +
+                       " maxUs=" + us(ka.max));
+            RobotClockStats clock = GetRobotClock();
+            LogMessage("[CLOCK] robot TimeStamp -> received: samples=" + std::to_string(clock.samples) +
+                       " lastMs=" + std::to_string(clock.last.count()) + " minMs=" + std::to_string(clock.min.count()) +
+                       " maxMs=" + std::to_string(clock.max.count()) + " unparsed=" + std::to_string(clock.unparsed));
+            LogMessage("[SEND] sent=" + std::to_string(sc.messagesSent) + " priority=" + std::to_string(sc.prioritySent) +
+                       " writes=" + std::to_string(sc.writeCalls) +
+                       " maxBatch=" + std::to_string(sc.maxBatch) + " maxDepth=" + std::to_string(sc.maxDepth) +
+                       " maxBytesInFlight=" + std::to_string(sc.maxBytesInFlight) + " failed=" + std::to_string(sc.failed));
+
+            for (WwksMessageType type : { WwksMessageType::HelloRequest, WwksMessageType::StatusRequest,
+                                          WwksMessageType::StockInfoRequest, WwksMessageType::OutputRequest })
+            {
+                RequestTracker::Stats rs = _requests.GetStats(type);
+                if (rs.answered + rs.failed == 0) continue;
+                std::string avg = rs.answered > 0 ? std::to_string(rs.totalMicros / rs.answered / 1000) : "0";
+                LogMessage(std::string("[REQUEST] ") + ToString(type) + " answered=" + std::to_string(rs.answered) +
+                           " failed=" + std::to_string(rs.failed) + " avgMs=" + avg + " maxMs=" + std::to_string(rs.maxMicros / 1000));
             }
         }
 
-        // Clean up socket when loop exits
+        // Release the transport (closes the socket) when loop exits
         {
             std::lock_guard<std::mutex> lk(_mtx);
-            if (_sock != INVALID_SOCKET)
+            _transport.reset();
+        }
+
+        // Wake the reconnection thread
+        {
+            std::lock_guard<std::mutex> lk(_pollMtx);
+        }
+        _pollWake.notify_all();
+
+        // Hand over what the full lanes had no room for yet; the reactor is gone, so waiting is fine now
+        for (PendingDispatch& pending : _backlog)
+        {
+            _dispatcher.Dispatch(pending.orderKey, std::move(pending.work));
+        }
+        _backlog.clear();
+        _backlogBytes = 0;
+        _receivePaused = false;
+        _backlogDrainPosted.store(false);
+
+        // Notify disconnection (queued behind the messages that are still being handled)
+        _dispatcher.Dispatch(std::string_view(), [this]() {
+            if (MessageReceived)
             {
-                closesocket(_sock);
-                _sock = INVALID_SOCKET;
+                WwksMessage disconnected;
+                try { MessageReceived(disconnected); } catch (...) {}
             }
-        }
+        });
 
-        // Notify disconnection
-        if (MessageReceived)
+        if (LogMessage)
         {
-            try { MessageReceived(std::string(), std::string()); } catch (...) {}
+            MessageDispatcher::Counters c = _dispatcher.GetCounters();
+            std::string avgWait = c.dispatched > 0 ? std::to_string(c.totalWaitMicros / c.dispatched) : "0";
+            LogMessage("[DISPATCH] depth=" + std::to_string(c.depth) + " maxDepth=" + std::to_string(c.maxDepth) +
+                       " dispatched=" + std::to_string(c.dispatched) + " blocked=" + std::to_string(c.blockedPushes) +
+                       " refused=" + std::to_string(c.refusedPushes) + " receivePauses=" + std::to_string(_receivePauses) +
+                       " avgWaitUs=" + avgWait + " maxWaitUs=" + std::to_string(c.maxWaitMicros));
         }
         
         // Set state machine to ConnectionIssue_Terminate (state 2)
@@ -481,7 +719,113 @@ namespace RowaPickupSlim
         SetNetworkState(NetworkConnectionState::ConnectionIssue_Terminate);
         
         // Notify connection lost with error details
-        NotifyStateChange(ConnectionState::NotConnected, ConnectionError::ConnectionReset, "Connection was closed by server");
+        if (!handshakeFailure.empty())
+            NotifyStateChange(ConnectionState::Failed, ConnectionError::Timeout, handshakeFailure);
+        else
+            NotifyStateChange(ConnectionState::NotConnected, ConnectionError::ConnectionReset, "Connection was closed by server");
+    }
+
+    // Private: Handle one complete frame (called on the receive thread), returns its type.
+    // received: when the chunk holding the frame was read (start of the KeepAlive turnaround)
+    WwksMessageType NetworkClient::HandleFrame(std::string_view frame, Handshake& handshake, Reactor::Clock::time_point received)
+    {
+        Capture(TrafficDirection::Inbound, frame, received);
+
+        // Classify on the raw bytes before any DOM is built
+        std::string_view bodyTag;
+        WwksMessageType messageType = ClassifyWwksFrame(frame, &bodyTag);
+        SampleRobotClock(frame, std::chrono::system_clock::now());
+
+        // KeepAliveRequest: answered from the template on the priority lane, never dispatched to the handlers
+        if (messageType == WwksMessageType::KeepAliveRequest)
+        {
+            std::string reply;
+            if (_keepAliveReply.Render(bodyTag, std::time(nullptr), reply))
+            {
+                Capture(TrafficDirection::Outbound, std::string_view(reply).substr(0, reply.size() - 1), Reactor::Clock::now());
+                _sendQueue.Enqueue(std::move(reply), SendQueue::Lane::Priority, [this, received](bool ok) {
+                    if (ok) _keepAliveTurnaround.Record(Reactor::Clock::now() - received);
+                });
+
+                if (LogMessage)
+                {
+                    LogMessage("[KEEPALIVE] Received KeepAliveRequest from server, sending KeepAliveResponse");
+                }
+            }
+            return messageType;
+        }
+
+        // Log incoming message
+        if (LogMessage)
+        {
+            LogMessage("\n<<< INCOMING MESSAGE <<<\n" + std::string(frame) + "\n<<< END INCOMING <<<\n");
+        }
+
+        // Advance the handshake here, before the message waits in the dispatch queue
+        if (handshake.OnMessage(messageType) && LogMessage)
+        {
+            LogMessage(std::string("[HANDSHAKE] Received ") + ToString(messageType));
+        }
+
+        // Messages for the same order (Id of the message element) share a dispatch lane
+        std::string_view orderKey;
+        FindTagAttribute(bodyTag, "Id", orderKey);
+
+        // Completes the pending request with this Id (responses only; records the latency)
+        _requests.OnResponse(orderKey, messageType);
+
+        // Dispatch message to message handler (held in the backlog while its lane is full)
+        WwksMessageParser& parser = *_parsers[_dispatcher.LaneOf(orderKey)];
+        Dispatch(orderKey, [completeMessage = std::string(frame), messageType, &parser, this]() mutable {
+            // Parse once here, in place over the copy this work item owns; the same DOM is handed to MessageReceived
+            const WwksMessage& message = parser.Parse(completeMessage, messageType);
+            
+            if (this->MessageReceived)
+            {
+                try
+                {
+                    this->MessageReceived(message);
+                }
+                catch (...)
+                {
+                    // swallow exceptions
+                }
+            }
+        }, frame.size());
+        return messageType;
+    }
+
+    // Private: Pass work to its dispatch lane without waiting (receive thread). Behind an earlier
+    // message of the backlog, or when the lane is full, it joins the backlog, in arrival order.
+    void NetworkClient::Dispatch(std::string_view orderKey, std::function<void()> work, size_t bytes)
+    {
+        if (_backlog.empty() && _dispatcher.TryDispatch(orderKey, work))
+            return;
+
+        _backlog.push_back(PendingDispatch{ std::string(orderKey), std::move(work), bytes });
+        _backlogBytes += bytes;
+    }
+
+    // Private: A lane made room (posted by MessageDispatcher::SpaceAvailable): move the backlog on
+    // until a lane is full again, and resume reading once it is small enough
+    void NetworkClient::DrainBacklog()
+    {
+        _backlogDrainPosted.store(false);
+
+        while (!_backlog.empty())
+        {
+            PendingDispatch& front = _backlog.front();
+            if (!_dispatcher.TryDispatch(front.orderKey, front.work))
+                break;
+            _backlogBytes -= front.bytes;
+            _backlog.pop_front();
+        }
+
+        if (_receivePaused && _backlogBytes <= BACKLOG_RESUME_BYTES && _transport)
+        {
+            _receivePaused = false;
+            _transport->PauseReceive(false);
+        }
     }
 
     // Start automatic reconnection polling
@@ -490,6 +834,17 @@ namespace RowaPickupSlim
         if (!IsValidIpAddress(serverIp) || !IsValidPort(port))
             return;
 
+        // Already polling the same server: only skip the remaining backoff delay
+        if (_pollingActive.load() && serverIp == _pollIp && port == _pollPort)
+        {
+            {
+                std::lock_guard<std::mutex> lk(_pollMtx);
+                _pollRetryNow = true;
+            }
+            _pollWake.notify_all();
+            return;
+        }
+
         StopConnectionPolling();  // Stop any existing polling first
 
         _pollIp = serverIp;
@@ -501,7 +856,11 @@ namespace RowaPickupSlim
     // Stop automatic reconnection polling
     void NetworkClient::StopConnectionPolling()
     {
-        _pollingActive.store(false);
+        {
+            std::lock_guard<std::mutex> lk(_pollMtx);
+            _pollingActive.store(false);
+        }
+        _pollWake.notify_all();
         if (_pollingThread.joinable())
         {
             _pollingThread.join();
@@ -511,7 +870,8 @@ namespace RowaPickupSlim
     // Check if connected
     bool NetworkClient::IsConnected() const
     {
-        return _sock != INVALID_SOCKET;
+        std::lock_guard<std::mutex> lk(_mtx);
+        return _transport != nullptr;
     }
 
     // Get current connection state
@@ -526,11 +886,12 @@ namespace RowaPickupSlim
         return _lastError;
     }
 
-    // Convert WSA error code to ConnectionError
-    ConnectionError NetworkClient::GetErrorType(int wsaError)
+    // Convert WSA error code (errno elsewhere) to ConnectionError
+    ConnectionError NetworkClient::GetErrorType(int socketError)
     {
-        switch (wsaError)
+        switch (socketError)
         {
+#ifdef _WIN32
         case WSAETIMEDOUT:
             return ConnectionError::Timeout;
         case WSAECONNREFUSED:
@@ -541,6 +902,18 @@ namespace RowaPickupSlim
             return ConnectionError::NetworkUnreachable;
         case WSAEHOSTUNREACH:
             return ConnectionError::HostUnreachable;
+#else
+        case ETIMEDOUT:
+            return ConnectionError::Timeout;
+        case ECONNREFUSED:
+            return ConnectionError::ConnectionRefused;
+        case ECONNRESET:
+            return ConnectionError::ConnectionReset;
+        case ENETUNREACH:
+            return ConnectionError::NetworkUnreachable;
+        case EHOSTUNREACH:
+            return ConnectionError::HostUnreachable;
+#endif
         default:
             return ConnectionError::Other;
         }
@@ -565,91 +938,84 @@ namespace RowaPickupSlim
         }
     }
 
-    // Automatic reconnection polling thread (tries every 5 seconds, max 10 attempts)
+    // Automatic reconnection thread: runs until StopConnectionPolling(). While connected it sleeps
+    // until the receive thread reports the connection lost; while not, it retries with the
+    // ReconnectPolicy delays (immediate first retry, then backoff with jitter, never giving up).
     void NetworkClient::PollingLoop()
     {
-        const int MAX_ATTEMPTS = 10;
-        const int RETRY_INTERVAL_MS = 5000;  // 5 seconds
-        int attemptCount = 0;
-
         if (LogMessage)
         {
-            LogMessage("Connection polling started: will attempt " + std::to_string(MAX_ATTEMPTS) + " times, 5 seconds apart");
+            ReconnectPolicy::Options options = _reconnect.GetOptions();
+            LogMessage("Connection polling started: retrying until connected, backoff up to " +
+                       std::to_string(std::chrono::duration_cast<std::chrono::seconds>(options.maxDelay).count()) + " seconds");
         }
 
-        while (_pollingActive.load() && attemptCount < MAX_ATTEMPTS)
+        auto ms = [](std::chrono::steady_clock::duration d) {
+            return std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(d).count());
+        };
+
+        while (_pollingActive.load())
         {
-            // Only poll if NOT connected
+            // Connected: nothing to do until the connection is lost
             {
-                std::lock_guard<std::mutex> lk(_mtx);
-                if (_sock != INVALID_SOCKET)
-                {
-                    // Already connected, stop polling
-                    if (LogMessage)
-                    {
-                        LogMessage("Connection polling succeeded - connection established!");
-                    }
-                    _pollingActive.store(false);
-                    return;
-                }
+                std::unique_lock<std::mutex> lk(_pollMtx);
+                _pollWake.wait(lk, [this]() { return !_pollingActive.load() || !IsConnected(); });
             }
+            if (!_pollingActive.load()) break;
 
-            attemptCount++;
+            auto now = std::chrono::steady_clock::now();
+            _reconnect.OnDisconnected(now);
+            std::chrono::steady_clock::duration delay = _reconnect.NextDelay(now);
+            ReconnectPolicy::Metrics m = _reconnect.GetMetrics(now);
 
-            // Log polling attempt with clear status
             if (LogMessage)
             {
-                std::string msg = "Polling attempt " + std::to_string(attemptCount) + "/" + std::to_string(MAX_ATTEMPTS) + 
-                                " - Trying to connect to " + _pollIp + ":" + std::to_string(_pollPort);
-                LogMessage(msg);
+                LogMessage("Polling attempt " + std::to_string(m.attempts) + " - Trying to connect to " + _pollIp + ":" +
+                           std::to_string(_pollPort) + " in " + ms(delay) + " ms (disconnected for " + ms(m.currentOutage) + " ms)");
             }
 
-            // Try to connect
+            // StopConnectionPolling() ends the wait immediately, a Refresh (StartConnectionPolling) retries at once
+            {
+                std::unique_lock<std::mutex> lk(_pollMtx);
+                _pollWake.wait_for(lk, delay, [this]() { return !_pollingActive.load() || _pollRetryNow; });
+                _pollRetryNow = false;
+            }
+            if (!_pollingActive.load()) break;
+
             if (Connect(_pollIp, _pollPort))
             {
+                _reconnect.OnConnected(std::chrono::steady_clock::now());
+                m = _reconnect.GetMetrics(std::chrono::steady_clock::now());
                 if (LogMessage)
                 {
-                    LogMessage("SUCCESS: Connection established during polling attempt " + std::to_string(attemptCount));
+                    // The outage (and the backoff) only ends once the handshake completes
+                    LogMessage("SUCCESS: Connection established during polling attempt " + std::to_string(m.attempts) +
+                               " (disconnected for " + ms(m.currentOutage) + " ms, longest outage " + ms(m.longestOutage) + " ms)");
                 }
-                // ConnectionStatusChanged callback will be called by Connect()
-                _pollingActive.store(false);
-                return;
-            }
-
-            // Log failed attempt
-            if (LogMessage)
-            {
-                LogMessage("  Attempt " + std::to_string(attemptCount) + " failed, waiting 5 seconds before retry...");
+                // ConnectionStatusChanged callback was called by Connect()
             }
-
-            // Wait before next attempt, checking if polling was stopped every 100ms
-            for (int i = 0; i < RETRY_INTERVAL_MS / 100 && _pollingActive.load(); i++)
+            else if (LogMessage)
             {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                LogMessage("  Attempt " + std::to_string(m.attempts) + " failed");
             }
         }
 
-        // Max attempts reached or polling was stopped
         if (LogMessage)
         {
-            if (attemptCount >= MAX_ATTEMPTS)
-            {
-                LogMessage("Connection polling stopped: maximum " + std::to_string(MAX_ATTEMPTS) + " attempts reached without success");
-                LogMessage("Setting network state to Disconnected_PausedWaitingForUser (state 3)");
-            }
-            else
-            {
-                LogMessage("Connection polling was stopped");
-            }
+            LogMessage("Connection polling was stopped");
         }
+    }
 
-        // Set state to 3 (PausedWaitingForUser) if max attempts reached
-        if (attemptCount >= MAX_ATTEMPTS)
-        {
-            SetNetworkState(NetworkConnectionState::Disconnected_PausedWaitingForUser);
-        }
+    // Get reconnection metrics
+    ReconnectPolicy::Metrics NetworkClient::GetReconnectMetrics() const
+    {
+        return _reconnect.GetMetrics(std::chrono::steady_clock::now());
+    }
 
-        _pollingActive.store(false);
+    // Set reconnection backoff
+    void NetworkClient::SetReconnectOptions(const ReconnectPolicy::Options& options)
+    {
+        _reconnect.SetOptions(options);
     }
 
     // Get network connection state
@@ -687,97 +1053,163 @@ namespace RowaPickupSlim
         }
     }
 
+    // Private: Identity for the next request (defaults when no callback is set)
+    ClientIdentity NetworkClient::GetIdentity() const
+    {
+        if (Identity)
+        {
+            try { return Identity(); } catch (...) {}
+        }
+        return ClientIdentity();
+    }
+
     // Get handshake complete state
     bool NetworkClient::IsHandshakeComplete() const
     {
-        return _handshakeComplete;
+        return _handshakeComplete.load();
+    }
+
+    // Set connect deadline / attempt delay for the next connection
+    void NetworkClient::SetConnectOptions(std::chrono::milliseconds timeout, std::chrono::milliseconds attemptDelay)
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        _connectOptions.timeout = timeout;
+        _connectOptions.attemptDelay = attemptDelay;
+    }
+
+    // Set dead-peer detection / TCP keepalive for the next connection
+    void NetworkClient::SetLivenessOptions(const LivenessMonitor::Options& options,
+        std::chrono::milliseconds tcpKeepAliveIdle, std::chrono::milliseconds tcpKeepAliveInterval)
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        _livenessOptions = options;
+        _tcpKeepAliveIdle = tcpKeepAliveIdle;
+        _tcpKeepAliveInterval = tcpKeepAliveInterval;
+    }
+
+    // Get robot clock offset statistics
+    RobotClockStats NetworkClient::GetRobotClock() const
+    {
+        std::lock_guard<std::mutex> lk(_robotClockMtx);
+        return _robotClock;
+    }
+
+    // Private: Compare the TimeStamp of the <WWKS> element with the time the frame was received
+    void NetworkClient::SampleRobotClock(std::string_view frame, std::chrono::system_clock::time_point received)
+    {
+        std::string_view stamp;
+        std::chrono::system_clock::time_point robotTime;
+        size_t start = frame.find("<WWKS");
+        size_t end = start == std::string_view::npos ? start : frame.find('>', start);
+        bool parsed = end != std::string_view::npos &&
+                      FindTagAttribute(frame.substr(start, end - start + 1), "TimeStamp", stamp) &&
+                      ParseIsoTimestamp(stamp, robotTime);
+
+        std::lock_guard<std::mutex> lk(_robotClockMtx);
+        if (!parsed)
+        {
+            _robotClock.unparsed++;
+            return;
+        }
+
+        auto offset = std::chrono::duration_cast<std::chrono::milliseconds>(received - robotTime);
+        if (_robotClock.samples == 0 || offset < _robotClock.min) _robotClock.min = offset;
+        if (_robotClock.samples == 0 || offset > _robotClock.max) _robotClock.max = offset;
+        _robotClock.last = offset;
+        _robotClock.samples++;
+    }
+
+    // Start / stop recording the traffic
+    void NetworkClient::SetCapture(std::shared_ptr<TrafficCaptureWriter> capture)
+    {
+        std::lock_guard<std::mutex> lk(_captureMtx);
+        _capturing.store(capture != nullptr);
+        _capture = std::move(capture);
+    }
+
+    // Private: Record one frame if a capture is set (any thread)
+    void NetworkClient::Capture(TrafficDirection direction, std::string_view frame, Reactor::Clock::time_point when)
+    {
+        if (!_capturing.load(std::memory_order_relaxed)) return;
+
+        std::lock_guard<std::mutex> lk(_captureMtx);
+        if (_capture) _capture->Record(direction, frame, when);
+    }
+
+    // Set handshake options for the next connection
+    void NetworkClient::SetHandshakeOptions(const Handshake::Options& options)
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        _handshakeOptions = options;
+    }
+
+    // Private: Id for a request sent by the client itself. The RequestTracker matches responses by Id,
+    // so Ids must not repeat; a clock value modulo 10^6 repeated every second and within a millisecond
+    std::string NetworkClient::NextRequestId()
+    {
+        return std::to_string(_lastRequestId.fetch_add(1, std::memory_order_relaxed) + 1);
     }
 
     // Send HelloRequest to initiate protocol handshake
     void NetworkClient::SendHelloRequest()
     {
-        std::string id = std::to_string(std::chrono::system_clock::now().time_since_epoch().count() % 1000000);
-        std::ostringstream ss;
-        ss << "<WWKS Version=\"2.0\" TimeStamp=\"";
-        auto now = std::chrono::system_clock::now();
-        std::time_t t = std::chrono::system_clock::to_time_t(now);
-        std::tm tm{};
-        gmtime_s(&tm, &t);
-        char buf[64];
-        strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
-        ss << buf << "\">";
-        ss << "<HelloRequest Id=\"" << id << "\"";
-        
-
-        
-        ss << ">";
-        ss << "<Subscriber Id=\"" << SharedVariables::SourceNumber << "\" Type=\"IMS\" Manufacturer=\"Becton Dickenson Netherlands\" ProductInfo=\"RowaPickupSlim\" VersionInfo=\"1.0\"";
+        ClientIdentity identity = GetIdentity();
+        std::string id = NextRequestId();
+        WwksMessageBuilder& b = _requestBuilder;
+        b.Begin(std::time(nullptr))
+            .Element("HelloRequest").Attribute("Id", id).Children()
+            .Element("Subscriber").Attribute("Id", identity.sourceNumber).Raw(SUBSCRIBER_ATTRIBUTES);
         // Add TenantId if provided (optional for multi-tenant systems)
-        if (!SharedVariables::TenantId.empty())
+        if (!identity.tenantId.empty())
         {
-            ss << " TenantId=\"" << SharedVariables::TenantId << "\"";
+            b.Attribute("TenantId", identity.tenantId);
         }
-        ss << ">";
-        ss << "<Capability Name=\"KeepAlive\" /><Capability Name=\"Status\" />";
-        ss << "<Capability Name=\"StockInfo\" /><Capability Name=\"Output\" />";
-        ss << "<Capability Name=\"TaskInfo\" />";
-        ss << "</Subscriber>";
-        ss << "</HelloRequest>";
-        ss << "</WWKS>";
+        b.Children()
+            .Raw(SUBSCRIBER_CAPABILITIES)
+            .Close("Subscriber")
+            .Close("HelloRequest");
         
         if (LogMessage)
         {
             LogMessage("[HANDSHAKE] Sending HelloRequest");
         }
-        SendMessage(ss.str());
+        SendRequest(b.End(), WwksMessageType::HelloRequest, id);
     }
 
     // Send StatusRequest as part of handshake
-    void NetworkClient::SendStatusRequest()
-    {
-        std::string id = std::to_string(std::chrono::system_clock::now().time_since_epoch().count() % 1000000);
-        std::ostringstream ss;
-        ss << "<WWKS Version=\"2.0\" TimeStamp=\"";
-        auto now = std::chrono::system_clock::now();
-        std::time_t t = std::chrono::system_clock::to_time_t(now);
-        std::tm tm{};
-        gmtime_s(&tm, &t);
-        char buf[64];
-        strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
-        ss << buf << "\">";
-        ss << "<StatusRequest Id=\"" << id << "\" Source=\"" << SharedVariables::SourceNumber << "\" IncludeDetails=\"True\" />";
-        ss << "</WWKS>";
+    void NetworkClient::SendStatusRequest(const char* logTag)
+    {
+        ClientIdentity identity = GetIdentity();
+        std::string id = NextRequestId();
+        WwksMessageBuilder& b = _requestBuilder;
+        b.Begin(std::time(nullptr))
+            .Element("StatusRequest").Attribute("Id", id).Attribute("Source", identity.sourceNumber)
+            .AttributeRaw("IncludeDetails", "True").Empty();
         
         if (LogMessage)
         {
-            LogMessage("[HANDSHAKE] Sending StatusRequest");
+            LogMessage(std::string(logTag) + " Sending StatusRequest");
         }
-        SendMessage(ss.str());
+        SendRequest(b.End(), WwksMessageType::StatusRequest, id);
     }
 
     // Send StockInfoRequest as final handshake step
     void NetworkClient::SendStockInfoRequest()
     {
-        std::string id = std::to_string(std::chrono::system_clock::now().time_since_epoch().count() % 1000000);
-        std::ostringstream ss;
-        ss << "<WWKS Version=\"2.0\" TimeStamp=\"";
-        auto now = std::chrono::system_clock::now();
-        std::time_t t = std::chrono::system_clock::to_time_t(now);
-        std::tm tm{};
-        gmtime_s(&tm, &t);
-        char buf[64];
-        strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
-        ss << buf << "\">";
-        ss << "<StockInfoRequest Id=\"" << id << "\" Source=\"" << SharedVariables::SourceNumber << "\" Destination=\"999\" IncludePacks=\"False\" IncludeArticleDetails=\"False\">";
-        ss << "<Criteria StockLocationId=\"" << SharedVariables::RobotStockLocation << "\" />";
-        ss << "</StockInfoRequest>";
-        ss << "</WWKS>";
+        ClientIdentity identity = GetIdentity();
+        std::string id = NextRequestId();
+        WwksMessageBuilder& b = _requestBuilder;
+        b.Begin(std::time(nullptr))
+            .Element("StockInfoRequest").Attribute("Id", id).Attribute("Source", identity.sourceNumber)
+            .AttributeRaw("Destination", "999").AttributeRaw("IncludePacks", "False").AttributeRaw("IncludeArticleDetails", "False").Children()
+            .Element("Criteria").Attribute("StockLocationId", identity.stockLocation).Empty()
+            .Close("StockInfoRequest");
         
         if (LogMessage)
         {
             LogMessage("[HANDSHAKE] Sending StockInfoRequest");
         }
-        SendMessage(ss.str());
+        SendRequest(b.End(), WwksMessageType::StockInfoRequest, id);
     }
 
 } // namespace RowaPickupSlim
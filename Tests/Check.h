@@ -0,0 +1,39 @@
+#pragma once
+// Check.h
+// Checks for the tests: CHECK(condition) reports a failed condition with its file and line and the
+// test goes on, so one run shows every failure. main() ends with "return Check::Result(name);".
+// Only depends on the standard library.
+
+#include <cstdio>
+
+namespace Check
+{
+    inline int& Failures()
+    {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline bool Report(bool ok, const char* condition, const char* file, int line)
+    {
+        if (!ok)
+        {
+            std::printf("%s:%d: CHECK failed: %s\n", file, line, condition);
+            Failures()++;
+        }
+        return ok;
+    }
+
+    /// Print the outcome of the test
+    /// @return The exit status for main(): 0 if every check passed
+    inline int Result(const char* test)
+    {
+        if (Failures() == 0)
+            std::printf("%s: passed\n", test);
+        else
+            std::printf("%s: %d checks failed\n", test, Failures());
+        return Failures() == 0 ? 0 : 1;
+    }
+}
+
+#define CHECK(condition) Check::Report(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
@@ -0,0 +1,286 @@
+// LivenessMonitorTest.cpp
+// LivenessMonitor on a virtual clock: the learned KeepAlive interval, the probe and the dead
+// verdict. Then failover end to end: a NetworkClient connected over TCP to a local stand-in robot
+// that sends KeepAliveRequests and then stops responding without closing the connection. The client
+// must drop it a few learned intervals after the last KeepAlive, and keep a robot that still
+// answers the probes.
+//
+// Build and run: ./build.sh --run LivenessMonitorTest
+
+#include "Check.h"
+#include "LivenessMonitor.h"
+#include "networkclient.h"
+#include "WwksClassifier.h"
+#include "WwksFrameSplitter.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstdio>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace RowaPickupSlim;
+using namespace std::chrono_literals;
+
+using Clock = LivenessMonitor::Clock;
+using Verdict = LivenessMonitor::Verdict;
+
+static void TestInitialInterval()
+{
+    LivenessMonitor monitor;
+    Clock::time_point start{};
+    monitor.Reset(start);
+    CHECK(monitor.DeadAfter() == 120s);             // 3 x 40 s until the cadence is known
+    CHECK(monitor.NextCheck() == start + 60s);      // Probe after 1.5 intervals
+    CHECK(monitor.Check(start + 59s) == Verdict::Alive);
+
+    // One KeepAlive is not an interval yet
+    monitor.OnReceive(start + 1s, true);
+    CHECK(!monitor.GetMetrics().learned);
+    CHECK(monitor.DeadAfter() == 120s);
+}
+
+static void TestLearnedInterval()
+{
+    LivenessMonitor monitor;
+    Clock::time_point now{};
+    monitor.Reset(now);
+    for (int i = 0; i < 5; i++)
+    {
+        now += 2s;
+        monitor.OnReceive(now, true);
+    }
+    LivenessMonitor::Metrics m = monitor.GetMetrics();
+    CHECK(m.learned);
+    CHECK(m.keepAlives == 5);
+    CHECK(monitor.Interval() == 2s);
+    CHECK(monitor.DeadAfter() == 6s);
+
+    // Silence: one probe at 1.5 intervals, then dead at 3 intervals
+    Clock::time_point last = now;
+    CHECK(monitor.NextCheck() == last + 3s);
+    CHECK(monitor.Check(last + 2s) == Verdict::Alive);
+    CHECK(monitor.Check(last + 3s) == Verdict::Probe);
+    CHECK(monitor.Check(last + 4s) == Verdict::Alive);  // Reported once per silence
+    CHECK(monitor.NextCheck() == last + 6s);
+    CHECK(monitor.Check(last + 6s) == Verdict::Dead);
+    CHECK(monitor.GetMetrics().probes == 1);
+
+    // Any data (the probe's answer) ends the silence and re-arms the probe
+    monitor.OnReceive(last + 5s, false);
+    CHECK(monitor.Check(last + 7s) == Verdict::Alive);
+    CHECK(monitor.Check(last + 8s) == Verdict::Probe);
+    CHECK(monitor.Interval() == 2s);                    // Not a KeepAlive: the interval is unchanged
+    CHECK(monitor.GetMetrics().longestSilence == 5s);
+
+    // A new cadence is followed gradually: a 9 s gap gives 0.75 * 2 s + 0.25 * 9 s
+    monitor.OnReceive(last + 9s, true);
+    CHECK(monitor.Interval() == 3750ms);
+}
+
+static void TestClampAndReset()
+{
+    LivenessMonitor::Options options;
+    options.minInterval = 1s;
+    options.maxInterval = 10s;
+    LivenessMonitor monitor(options);
+    Clock::time_point now{};
+    monitor.Reset(now);
+    monitor.OnReceive(now + 100ms, true);
+    monitor.OnReceive(now + 200ms, true);
+    CHECK(monitor.Interval() == 1s);
+
+    // A gap across a reconnect is not an interval
+    monitor.Reset(now + 1min);
+    monitor.OnReceive(now + 1min + 1s, true);
+    CHECK(monitor.Interval() == 1s);
+    CHECK(monitor.GetMetrics().keepAlives == 3);
+
+    options.probe = false;
+    LivenessMonitor noProbe(options);
+    noProbe.Reset(now);
+    CHECK(noProbe.NextCheck() == now + noProbe.DeadAfter());
+    CHECK(noProbe.Check(now + noProbe.DeadAfter() - 1ms) == Verdict::Alive);
+}
+
+// Stand-in robot on a loopback TCP port: answers the handshake, sends a KeepAliveRequest every
+// keepAliveEvery, and after silentAfter neither sends nor answers anything (but the probes, if
+// answerProbes) while the connection stays open
+class StandInRobot
+{
+public:
+    StandInRobot(std::chrono::milliseconds keepAliveEvery, std::chrono::milliseconds silentAfter, bool answerProbes)
+        : _keepAliveEvery(keepAliveEvery), _silentAfter(silentAfter), _answerProbes(answerProbes)
+    {
+        _listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (::bind(_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+            ::getsockname(_listener, reinterpret_cast<sockaddr*>(&address), &length) == 0 && ::listen(_listener, 1) == 0)
+            _port = ntohs(address.sin_port);
+        _thread = std::thread([this]() { Serve(); });
+    }
+
+    ~StandInRobot()
+    {
+        _stop = true;
+        ::shutdown(_listener, SHUT_RDWR);
+        _thread.join();
+        ::close(_listener);
+    }
+
+    int Port() const { return _port; }
+    Clock::time_point LastKeepAlive() const { return _lastKeepAlive.load(); }
+    int ProbesAnswered() const { return _probesAnswered.load(); }
+
+private:
+    void Serve()
+    {
+        int client = ::accept(_listener, nullptr, nullptr);
+        if (client < 0) return;
+        Clock::time_point start = Clock::now();
+        Clock::time_point nextKeepAlive = start;
+        WwksFrameSplitter splitter;
+        int keepAliveId = 1;
+        while (!_stop.load())
+        {
+            Clock::time_point now = Clock::now();
+            bool silent = now - start >= _silentAfter;
+            if (!silent && now >= nextKeepAlive)
+            {
+                Send(client, "<KeepAliveRequest Id=\"" + std::to_string(keepAliveId++) + "\" Source=\"999\" Destination=\"100\" />");
+                _lastKeepAlive = now;
+                nextKeepAlive = now + _keepAliveEvery;
+            }
+
+            pollfd readable{ client, POLLIN, 0 };
+            if (::poll(&readable, 1, 5) <= 0) continue;
+            char* buffer = splitter.PrepareWrite(4096);
+            ssize_t n = ::recv(client, buffer, 4096, 0);
+            if (n <= 0) break;
+            splitter.Commit(static_cast<size_t>(n));
+
+            std::string_view frame;
+            while (splitter.NextFrame(frame))
+            {
+                std::string_view tag;
+                WwksMessageType type = ClassifyWwksFrame(frame, &tag);
+                std::string_view idView;
+                FindTagAttribute(tag, "Id", idView);
+                std::string id(idView);
+                if (silent && !(_answerProbes && type == WwksMessageType::StatusRequest)) continue;
+
+                const std::string route = " Source=\"999\" Destination=\"100\"";
+                if (type == WwksMessageType::HelloRequest)
+                    Send(client, "<HelloResponse Id=\"" + id + "\"><Subscriber Id=\"999\" Type=\"StorageSystem\" /></HelloResponse>");
+                else if (type == WwksMessageType::StatusRequest)
+                {
+                    Send(client, "<StatusResponse Id=\"" + id + "\"" + route + " State=\"Ready\" />");
+                    if (silent) _probesAnswered++;
+                }
+                else if (type == WwksMessageType::StockInfoRequest)
+                    Send(client, "<StockInfoResponse Id=\"" + id + "\"" + route + " />");
+            }
+        }
+        ::close(client);
+    }
+
+    static void Send(int client, const std::string& body)
+    {
+        std::string frame = "<WWKS Version=\"2.0\" TimeStamp=\"2026-01-01T00:00:00Z\">" + body + "</WWKS>\n";
+        ::send(client, frame.data(), frame.size(), MSG_NOSIGNAL);
+    }
+
+    std::chrono::milliseconds _keepAliveEvery;
+    std::chrono::milliseconds _silentAfter;
+    bool _answerProbes;
+    int _listener = -1;
+    int _port = 0;
+    std::atomic<bool> _stop{ false };
+    std::atomic<Clock::time_point> _lastKeepAlive{ Clock::time_point{} };
+    std::atomic<int> _probesAnswered{ 0 };
+    std::thread _thread;
+};
+
+struct Failover
+{
+    bool connected = false;
+    bool dropped = false;
+    Clock::duration afterLastKeepAlive{};
+    int probes = 0;
+    int probesAnswered = 0;
+};
+
+// Connect to a robot with 100 ms KeepAlives that goes silent after 1 s; watch for up to watchFor
+static Failover RunFailover(bool answerProbes, std::chrono::milliseconds watchFor)
+{
+    StandInRobot robot(100ms, 1000ms, answerProbes);
+    NetworkClient client;
+    LivenessMonitor::Options options;
+    options.minInterval = 20ms;         // The production floor (1 s) is above this robot's cadence
+    client.SetLivenessOptions(options, 10000ms, 1000ms);
+    client.Identity = []() { ClientIdentity identity; identity.sourceNumber = 100; return identity; };
+
+    std::atomic<bool> lost{ false };
+    std::atomic<Clock::time_point> lostAt{ Clock::time_point{} };
+    std::atomic<int> probes{ 0 };
+    client.ConnectionStateChanged = [&](ConnectionState state, ConnectionError, const std::string&) {
+        if (state != ConnectionState::NotConnected && state != ConnectionState::Failed) return;
+        lostAt = Clock::now();
+        lost = true;
+    };
+    client.LogMessage = [&](const std::string& message) {
+        if (message.find("[LIVENESS] KeepAliveRequest overdue") != std::string::npos) probes++;
+    };
+
+    Failover result;
+    result.connected = client.Connect("127.0.0.1", robot.Port());
+    Clock::time_point deadline = Clock::now() + watchFor;
+    while (!lost.load() && Clock::now() < deadline)
+        std::this_thread::sleep_for(1ms);
+
+    result.dropped = lost.load();
+    if (result.dropped) result.afterLastKeepAlive = lostAt.load() - robot.LastKeepAlive();
+    result.probes = probes.load();
+    result.probesAnswered = robot.ProbesAnswered();
+    client.Close();
+    return result;
+}
+
+static void TestFailoverSilentRobot()
+{
+    // Learned interval ~100 ms: dead after 3 intervals without data, one unanswered probe on the way
+    Failover f = RunFailover(false, 5000ms);
+    CHECK(f.connected);
+    CHECK(f.dropped);
+    CHECK(f.afterLastKeepAlive >= 250ms);
+    CHECK(f.afterLastKeepAlive < 1000ms);       // Was 120 s with the fixed receive-idle limit
+    CHECK(f.probes == 1);
+    std::printf("  silent robot dropped %lld ms after its last KeepAlive\n",
+                static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(f.afterLastKeepAlive).count()));
+}
+
+static void TestProbesKeepResponsiveRobot()
+{
+    // No more KeepAlives, but the StatusRequest probes are answered: the connection stays up
+    Failover f = RunFailover(true, 2500ms);
+    CHECK(f.connected);
+    CHECK(!f.dropped);
+    CHECK(f.probes >= 3);
+    CHECK(f.probesAnswered == f.probes);
+}
+
+int main()
+{
+    TestInitialInterval();
+    TestLearnedInterval();
+    TestClampAndReset();
+    TestFailoverSilentRobot();
+    TestProbesKeepResponsiveRobot();
+    return Check::Result("LivenessMonitorTest");
+}
@@ -0,0 +1,212 @@
+// ReactorTest.cpp
+// Reactor against a local TCP server on the loopback interface: readiness of a connected socket,
+// peer close, one-shot timers and cancellation, Post() and Stop() from other threads, and that an
+// idle loop sleeps instead of waking up.
+//
+// Build and run: ./build.sh --run ReactorTest
+
+#include "Check.h"
+#include "Reactor.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace RowaPickupSlim;
+using namespace std::chrono_literals;
+
+// A connected pair: client is the socket the reactor watches, server the accepted peer
+struct LocalConnection
+{
+    int client = -1;
+    int server = -1;
+
+    LocalConnection()
+    {
+        int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+            ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) == 0 && ::listen(listener, 1) == 0)
+        {
+            client = ::socket(AF_INET, SOCK_STREAM, 0);
+            if (::connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0)
+                server = ::accept(listener, nullptr, nullptr);
+            ::fcntl(client, F_SETFL, ::fcntl(client, F_GETFL) | O_NONBLOCK);
+        }
+        ::close(listener);
+    }
+
+    ~LocalConnection()
+    {
+        if (client >= 0) ::close(client);
+        if (server >= 0) ::close(server);
+    }
+
+    bool IsValid() const { return client >= 0 && server >= 0; }
+};
+
+// Run the reactor until done() or the time is up
+template <typename Done>
+static bool RunUntil(Reactor& reactor, Done&& done, Reactor::Clock::duration limit = 2s)
+{
+    Reactor::Clock::time_point deadline = Reactor::Clock::now() + limit;
+    while (!done() && Reactor::Clock::now() < deadline)
+        reactor.RunOnce(10ms);
+    return done();
+}
+
+static void TestReadAndPeerClose()
+{
+    LocalConnection connection;
+    Reactor reactor;
+    if (!CHECK(connection.IsValid() && reactor.IsValid())) return;
+
+    std::string received;
+    bool closed = false;
+    CHECK(reactor.Add(connection.client, Reactor::Readable, [&](uint32_t) {
+        char buffer[4096];
+        ssize_t n = ::recv(connection.client, buffer, sizeof(buffer), 0);
+        if (n > 0)
+        {
+            received.append(buffer, static_cast<size_t>(n));
+            return;
+        }
+        closed = true;
+        reactor.Remove(connection.client);      // A handler may remove itself
+    }));
+
+    CHECK(::send(connection.server, "hello", 5, 0) == 5);
+    CHECK(RunUntil(reactor, [&]() { return received.size() == 5; }));
+    CHECK(received == "hello");
+
+    // Nothing more to read: the handler is not called again
+    size_t events = reactor.GetCounters().ioEvents;
+    reactor.RunOnce(20ms);
+    CHECK(reactor.GetCounters().ioEvents == events);
+
+    ::shutdown(connection.server, SHUT_WR);
+    CHECK(RunUntil(reactor, [&]() { return closed; }));
+
+    // Removed: a second close notification is not delivered
+    events = reactor.GetCounters().ioEvents;
+    reactor.RunOnce(20ms);
+    CHECK(reactor.GetCounters().ioEvents == events);
+}
+
+static void TestWritable()
+{
+    LocalConnection connection;
+    Reactor reactor;
+    if (!CHECK(connection.IsValid())) return;
+
+    uint32_t seen = 0;
+    CHECK(reactor.Add(connection.client, Reactor::Readable, [&](uint32_t events) { seen |= events; }));
+    reactor.RunOnce(20ms);
+    CHECK(seen == 0);
+
+    CHECK(reactor.Modify(connection.client, Reactor::Readable | Reactor::Writable));
+    CHECK(RunUntil(reactor, [&]() { return (seen & Reactor::Writable) != 0; }));
+    CHECK((seen & Reactor::Readable) == 0);
+    reactor.Remove(connection.client);
+}
+
+static void TestTimers()
+{
+    Reactor reactor;
+    std::vector<int> fired;
+    reactor.AddTimer(60ms, [&]() { fired.push_back(3); });
+    reactor.AddTimer(20ms, [&]() { fired.push_back(1); });
+    Reactor::TimerId cancelled = reactor.AddTimer(30ms, [&]() { fired.push_back(99); });
+    Reactor::TimerId second = reactor.AddTimer(40ms, [&]() { fired.push_back(2); });
+    CHECK(reactor.CancelTimer(cancelled));
+    CHECK(!reactor.CancelTimer(cancelled));
+
+    // A timer may add a timer
+    reactor.AddTimer(10ms, [&]() { reactor.AddTimer(0ms, [&]() { fired.push_back(0); }); });
+
+    Reactor::Clock::time_point start = Reactor::Clock::now();
+    CHECK(RunUntil(reactor, [&]() { return fired.size() == 4; }));
+    CHECK(Reactor::Clock::now() - start >= 60ms);
+    CHECK((fired == std::vector<int>{ 0, 1, 2, 3 }));
+    CHECK(!reactor.CancelTimer(second));        // Already fired
+    CHECK(reactor.GetCounters().timersFired == 5);
+}
+
+static void TestPostStopAndIdle()
+{
+    LocalConnection connection;
+    Reactor reactor;
+    if (!CHECK(connection.IsValid())) return;
+
+    std::atomic<size_t> received{ 0 };
+    reactor.Add(connection.client, Reactor::Readable, [&](uint32_t) {
+        char buffer[256];
+        ssize_t n = ::recv(connection.client, buffer, sizeof(buffer), 0);
+        if (n > 0) received += static_cast<size_t>(n);
+    });
+
+    std::thread::id loopThread;
+    std::thread loop([&]() {
+        loopThread = std::this_thread::get_id();
+        reactor.Run();
+    });
+
+    // Idle with a registered socket: the loop sleeps in one wait
+    std::this_thread::sleep_for(300ms);
+    Reactor::Counters idle = reactor.GetCounters();
+    CHECK(idle.waits <= 2);
+    CHECK(idle.idleWakeups == 0);
+
+    // Data wakes the loop
+    CHECK(::send(connection.server, "x", 1, 0) == 1);
+    for (int i = 0; i < 200 && received.load() == 0; i++) std::this_thread::sleep_for(1ms);
+    CHECK(received.load() == 1);
+
+    // Posted tasks run on the loop thread, in order, from any number of threads
+    std::atomic<int> ran{ 0 };
+    std::atomic<bool> onLoop{ true };
+    std::vector<int> order;
+    std::vector<std::thread> posters;
+    for (int t = 0; t < 4; t++)
+    {
+        posters.emplace_back([&]() {
+            for (int i = 0; i < 250; i++)
+                reactor.Post([&]() {
+                    if (std::this_thread::get_id() != loopThread) onLoop = false;
+                    ran++;
+                });
+        });
+    }
+    for (std::thread& t : posters) t.join();
+    std::atomic<bool> ordered{ false };
+    for (int i = 0; i < 5; i++) reactor.Post([&, i]() { order.push_back(i); });
+    reactor.Post([&]() { ordered = true; });
+    for (int i = 0; i < 2000 && !ordered.load(); i++) std::this_thread::sleep_for(1ms);
+    CHECK(ran.load() == 1000);
+    CHECK(onLoop.load());
+
+    // Stop from another thread ends Run() promptly
+    Reactor::Clock::time_point stopAt = Reactor::Clock::now();
+    reactor.Stop();
+    loop.join();
+    CHECK(Reactor::Clock::now() - stopAt < 100ms);
+    CHECK(reactor.IsStopped());
+    CHECK((order == std::vector<int>{ 0, 1, 2, 3, 4 }));
+}
+
+int main()
+{
+    TestReadAndPeerClose();
+    TestWritable();
+    TestTimers();
+    TestPostStopAndIdle();
+    return Check::Result("ReactorTest");
+}
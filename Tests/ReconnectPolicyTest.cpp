@@ -0,0 +1,175 @@
+// ReconnectPolicyTest.cpp
+// ReconnectPolicy on a virtual clock: the backoff sequence and its cap, jitter bounds, and when an
+// outage ends. A peer that accepts the connection and drops it again must not reset the backoff;
+// only an established session (or one that stayed connected for stableAfter) does.
+//
+// Build and run: ./build.sh --run ReconnectPolicyTest
+
+#include "Check.h"
+#include "ReconnectPolicy.h"
+#include <set>
+#include <vector>
+
+using namespace RowaPickupSlim;
+using namespace std::chrono_literals;
+
+using Clock = ReconnectPolicy::Clock;
+using Duration = ReconnectPolicy::Duration;
+
+static ReconnectPolicy::Options NoJitter()
+{
+    ReconnectPolicy::Options options;
+    options.jitter = 0.0;
+    return options;
+}
+
+// One polling iteration as NetworkClient::PollingLoop runs it: lost, wait, connect
+static Duration Retry(ReconnectPolicy& policy, Clock::time_point& now)
+{
+    policy.OnDisconnected(now);
+    Duration delay = policy.NextDelay(now);
+    now += delay;
+    return delay;
+}
+
+static void TestBackoffSequence()
+{
+    ReconnectPolicy policy(NoJitter(), 1);
+    Clock::time_point now{};
+    std::vector<Duration> delays;
+    for (int i = 0; i < 9; i++)
+    {
+        delays.push_back(Retry(policy, now));
+        now += 5ms;     // The connect attempt fails
+    }
+    CHECK((delays == std::vector<Duration>{ 0s, 1s, 2s, 4s, 8s, 16s, 30s, 30s, 30s }));
+
+    ReconnectPolicy::Metrics m = policy.GetMetrics(now);
+    CHECK(m.inOutage);
+    CHECK(m.attempts == 9);
+    CHECK(m.outages == 1);
+    CHECK(m.reconnects == 0);
+    CHECK(m.lastDelay == 30s);
+    CHECK(m.currentOutage == now - Clock::time_point{});
+
+    ReconnectPolicy::Options noImmediate = NoJitter();
+    noImmediate.immediateFirstRetry = false;
+    CHECK(ReconnectPolicy::BaseDelay(noImmediate, 1) == 1s);
+    CHECK(ReconnectPolicy::BaseDelay(noImmediate, 3) == 4s);
+    CHECK(ReconnectPolicy::BaseDelay(noImmediate, 1000) == 30s);
+}
+
+static void TestJitter()
+{
+    ReconnectPolicy::Options options;       // jitter 0.5: delay * [0.5, 1]
+    std::set<Duration::rep> fourth;
+    for (uint32_t seed = 0; seed < 50; seed++)
+    {
+        ReconnectPolicy policy(options, seed);
+        Clock::time_point now{};
+        CHECK(Retry(policy, now) == 0s);    // The immediate retry is not jittered
+        for (uint32_t attempt = 2; attempt <= 10; attempt++)
+        {
+            Duration base = ReconnectPolicy::BaseDelay(options, attempt);
+            Duration delay = Retry(policy, now);
+            CHECK(delay >= base / 2 && delay <= base);
+            if (attempt == 4) fourth.insert(delay.count());
+        }
+    }
+    // Terminals that lost the robot together spread out
+    CHECK(fourth.size() > 40);
+}
+
+// The peer accepts and closes at once: the attempt count and the delays keep growing
+static void TestAcceptThenClose()
+{
+    ReconnectPolicy policy(NoJitter(), 1);
+    Clock::time_point now{};
+    std::vector<Duration> delays;
+    for (int i = 0; i < 8; i++)
+    {
+        delays.push_back(Retry(policy, now));
+        policy.OnConnected(now);
+        now += 10ms;
+    }
+    CHECK((delays == std::vector<Duration>{ 0s, 1s, 2s, 4s, 8s, 16s, 30s, 30s }));
+
+    policy.OnDisconnected(now);
+    ReconnectPolicy::Metrics m = policy.GetMetrics(now);
+    CHECK(m.inOutage);
+    CHECK(m.attempts == 8);
+    CHECK(m.outages == 1);
+    CHECK(m.reconnects == 0);
+    CHECK(m.unstableConnections == 8);
+    CHECK(m.totalAttempts == 8);
+}
+
+// A completed handshake ends the outage; the next loss starts a new one with an immediate retry
+static void TestEstablishedEndsOutage()
+{
+    ReconnectPolicy policy(NoJitter(), 1);
+    Clock::time_point start{};
+    Clock::time_point now = start;
+    for (int i = 0; i < 4; i++) Retry(policy, now);     // 0 + 1 + 2 + 4 s
+    policy.OnConnected(now);
+    CHECK(policy.GetMetrics(now).inOutage);             // Connected, handshake still running
+    now += 200ms;
+    policy.OnEstablished(now);
+
+    ReconnectPolicy::Metrics m = policy.GetMetrics(now);
+    CHECK(!m.inOutage);
+    CHECK(m.reconnects == 1);
+    CHECK(m.lastOutage == 7200ms);
+    CHECK(m.longestOutage == 7200ms);
+    CHECK(m.currentOutage == 0s);
+
+    // Established twice, or disconnected afterwards: still one reconnect
+    policy.OnEstablished(now);
+    now += 1min;
+    CHECK(Retry(policy, now) == 0s);
+    m = policy.GetMetrics(now);
+    CHECK(m.inOutage);
+    CHECK(m.attempts == 1);
+    CHECK(m.outages == 2);
+    CHECK(m.reconnects == 1);
+    CHECK(m.unstableConnections == 0);
+    CHECK(Retry(policy, now) == 1s);
+}
+
+// Without OnEstablished, a connection that lasts stableAfter ends the outage
+static void TestStableConnectionEndsOutage()
+{
+    ReconnectPolicy::Options options = NoJitter();
+    options.stableAfter = 5s;
+    ReconnectPolicy policy(options, 1);
+    Clock::time_point now{};
+    for (int i = 0; i < 3; i++) Retry(policy, now);     // 0 + 1 + 2 s
+    policy.OnConnected(now);
+
+    now += 4s;
+    CHECK(policy.GetMetrics(now).inOutage);
+    now += 2s;
+    ReconnectPolicy::Metrics m = policy.GetMetrics(now);
+    CHECK(!m.inOutage);
+    CHECK(m.reconnects == 1);
+    CHECK(m.lastOutage == 8s);                          // Ended stableAfter after the connect
+
+    // The loss is a new outage, and the outage just ended is recorded once
+    now += 1min;
+    CHECK(Retry(policy, now) == 0s);
+    m = policy.GetMetrics(now);
+    CHECK(m.outages == 2);
+    CHECK(m.reconnects == 1);
+    CHECK(m.lastOutage == 8s);
+    CHECK(m.unstableConnections == 0);
+}
+
+int main()
+{
+    TestBackoffSequence();
+    TestJitter();
+    TestAcceptThenClose();
+    TestEstablishedEndsOutage();
+    TestStableConnectionEndsOutage();
+    return Check::Result("ReconnectPolicyTest");
+}
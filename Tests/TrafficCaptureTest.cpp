@@ -0,0 +1,103 @@
+// TrafficCaptureTest.cpp
+// TrafficCaptureWriter / TrafficCaptureReader round trip through a temporary file: a frame larger
+// than the backlog limit is still captured, frames dropped while the backlog is full leave a gap
+// record at their place (also when the capture stops right after), and the reader returns the
+// records in order with non-decreasing timestamps.
+//
+// Build and run: ./build.sh --run TrafficCaptureTest
+
+#include "Check.h"
+#include "TrafficCapture.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace RowaPickupSlim;
+
+static std::string CapturePath()
+{
+    return (std::filesystem::temp_directory_path() / "TrafficCaptureTest.wwkscap").string();
+}
+
+static std::vector<TrafficRecord> ReadAll(const std::string& path)
+{
+    std::vector<TrafficRecord> records;
+    TrafficCaptureReader reader;
+    std::string error;
+    if (!CHECK(reader.Open(path, error))) return records;
+
+    TrafficRecord record;
+    while (reader.Next(record)) records.push_back(record);
+    CHECK(!reader.IsTruncated());
+    for (size_t i = 1; i < records.size(); i++) CHECK(records[i].time >= records[i - 1].time);
+    return records;
+}
+
+static void TestFrameLargerThanLimit()
+{
+    const std::string path = CapturePath();
+    const std::string stock(5 * 1024 * 1024, 'x');
+    {
+        TrafficCaptureWriter writer(64 * 1024);
+        CHECK(writer.Open(path));
+        CHECK(writer.Record(TrafficDirection::Inbound, stock));
+        writer.Flush();
+        CHECK(writer.Record(TrafficDirection::Outbound, "<WWKS />"));
+        writer.Stop();
+        CHECK(writer.GetCounters().records == 2);
+        CHECK(writer.GetCounters().dropped == 0);
+    }
+
+    std::vector<TrafficRecord> records = ReadAll(path);
+    CHECK(records.size() == 2);
+    if (records.size() == 2)
+    {
+        CHECK(records[0].direction == TrafficDirection::Inbound);
+        CHECK(records[0].frame == stock);
+        CHECK(records[1].direction == TrafficDirection::Outbound);
+        CHECK(records[1].frame == "<WWKS />");
+    }
+    std::filesystem::remove(path);
+}
+
+static void TestDropsLeaveGap()
+{
+    const std::string path = CapturePath();
+    const std::string frame(400, 'f');
+    {
+        TrafficCaptureWriter writer(1000);
+        CHECK(writer.Open(path));
+        CHECK(writer.Record(TrafficDirection::Inbound, frame));
+        CHECK(writer.Record(TrafficDirection::Inbound, frame));
+        CHECK(!writer.Record(TrafficDirection::Inbound, frame));       // The backlog is full
+        CHECK(!writer.Record(TrafficDirection::Outbound, frame));
+        writer.Flush();
+        CHECK(writer.Record(TrafficDirection::Outbound, "after"));
+        writer.Flush();
+        CHECK(writer.Record(TrafficDirection::Inbound, frame));
+        CHECK(writer.Record(TrafficDirection::Inbound, frame));
+        CHECK(!writer.Record(TrafficDirection::Inbound, frame));       // Dropped just before Stop()
+        writer.Stop();
+        CHECK(writer.GetCounters().records == 5);
+        CHECK(writer.GetCounters().dropped == 3);
+    }
+
+    std::vector<TrafficRecord> records = ReadAll(path);
+    CHECK(records.size() == 7);
+    if (records.size() == 7)
+    {
+        CHECK(records[2].direction == TrafficDirection::Gap);
+        CHECK(records[2].frame == "2 frames, 800 bytes dropped: capture backlog full");
+        CHECK(records[3].frame == "after");
+        CHECK(records[6].direction == TrafficDirection::Gap);
+        CHECK(records[6].frame == "1 frames, 400 bytes dropped: capture backlog full");
+    }
+    std::filesystem::remove(path);
+}
+
+int main()
+{
+    TestFrameLargerThanLimit();
+    TestDropsLeaveGap();
+    return Check::Result("TrafficCaptureTest");
+}
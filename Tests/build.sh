@@ -0,0 +1,64 @@
+#!/bin/sh
+# Build and run the tests on Linux (g++ or clang++ with C++20).
+# Usage: ./build.sh [--run] [name...]      (default: all; binaries go to ./bin)
+# One test per module, <Module>Test.cpp, linked with the RowaPickupSlim sources it tests.
+# With --run every built test is run; the script fails if any of them fails.
+
+set -e
+cd "$(dirname "$0")"
+
+SRC=../RowaPickupSlim
+CXX="${CXX:-g++}"
+CXXFLAGS="-std=c++20 -O2 -Wall -Wextra -pthread -I$SRC"
+RUN=
+if [ "$1" = "--run" ]; then
+    RUN=1
+    shift
+fi
+WANTED="$*"
+FAILED=
+
+mkdir -p bin
+
+# pugixml is compiled once and shared by the tests that parse XML
+pugixml()
+{
+    if [ ! -f bin/pugixml.o ] || [ "$SRC/pugixml.cpp" -nt bin/pugixml.o ]; then
+        $CXX $CXXFLAGS -c "$SRC/pugixml.cpp" -o bin/pugixml.o
+    fi
+    echo bin/pugixml.o
+}
+
+# unittest <name> <sources...>
+unittest()
+{
+    name="$1"
+    shift
+    if [ -n "$WANTED" ]; then
+        case " $WANTED " in
+            *" $name "*) ;;
+            *) return 0 ;;
+        esac
+    fi
+    $CXX $CXXFLAGS "$name.cpp" "$@" -o "bin/$name"
+    echo "Built bin/$name"
+    if [ -n "$RUN" ]; then
+        "bin/$name" || FAILED="$FAILED $name"
+    fi
+}
+
+unittest ReactorTest "$SRC/Reactor.cpp"
+unittest ReconnectPolicyTest "$SRC/ReconnectPolicy.cpp"
+unittest TrafficCaptureTest "$SRC/TrafficCapture.cpp"
+unittest AsyncLoggerTest "$SRC/AsyncLogger.cpp" "$SRC/IsoTimestamp.cpp"
+unittest LivenessMonitorTest "$SRC/LivenessMonitor.cpp" \
+    "$SRC/networkclient_fixed.cpp" "$SRC/Reactor.cpp" "$SRC/SendQueue.cpp" "$SRC/Handshake.cpp" "$SRC/RequestTracker.cpp" \
+    "$SRC/ReconnectPolicy.cpp" "$SRC/TcpConnector.cpp" "$SRC/KeepAliveReply.cpp" "$SRC/WwksMessageBuilder.cpp" \
+    "$SRC/IsoTimestamp.cpp" "$SRC/LatencyHistogram.cpp" "$SRC/MessageDispatcher.cpp" "$SRC/TcpTransport.cpp" \
+    "$SRC/LoopbackTransport.cpp" "$SRC/TrafficCapture.cpp" "$SRC/WwksFrameSplitter.cpp" "$SRC/WwksClassifier.cpp" \
+    "$SRC/WwksMessage.cpp" "$SRC/ParseArena.cpp" "$(pugixml)"
+
+if [ -n "$FAILED" ]; then
+    echo "FAILED:$FAILED"
+    exit 1
+fi